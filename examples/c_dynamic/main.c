@@ -2,6 +2,7 @@
 #include <rlGameCanvas/Bitmap.h>
 #include <rlGameCanvas/Definitions.h>
 #include <rlGameCanvas/Pixel.h>
+#include <rlGameCanvas/Sprite.h>
 
 #include "TestBitmaps.h"
 
@@ -31,6 +32,7 @@
 #define LOGO_ANIM_SECONDS 2
 
 bool bPaused = false;
+rlGameCanvas_Sprite sprCursor = NULL;
 typedef struct
 {
 	unsigned                iAnimFrame;
@@ -154,10 +156,13 @@ void __stdcall CanvasMsg(
 	{
 	case RL_GAMECANVAS_MSG_CREATE:
 		printf("CREATE received\n");
+		sprCursor = rlGameCanvas_CreateSprite(&bmpCURSOR);
 		break;
 
 	case RL_GAMECANVAS_MSG_DESTROY:
 		printf("DESTROY received\n");
+		rlGameCanvas_DestroySprite(sprCursor);
+		sprCursor = NULL;
 		break;
 
 	case RL_GAMECANVAS_MSG_LOSEFOCUS:
@@ -394,10 +399,10 @@ void __stdcall Draw(
 		const rlGameCanvas_UInt iX = pDataT->oMousePos.x;
 		const rlGameCanvas_UInt iY = pDataT->oMousePos.y;
 		
-		rlGameCanvas_ApplyBitmapOverlay(
-			&poLayers[LAYERID_CURSOR].bmp, &bmpCURSOR,
+		rlGameCanvas_ApplySpriteOverlay(
+			&poLayers[LAYERID_CURSOR].bmp, sprCursor,
 			(rlGameCanvas_Int)iX - 1, (rlGameCanvas_Int)iY - 1,
-			RL_GAMECANVAS_BMP_OVERLAY_REPLACE
+			RL_GAMECANVAS_BMP_OVERLAY_BLEND
 		);
 	}
 
@@ -1,5 +1,6 @@
 #include <rlGameCanvas++/GameCanvas.hpp>
 #include <rlGameCanvas++/Bitmap.hpp>
+#include <rlGameCanvas++/BakedSprite.hpp>
 #include <rlGameCanvas/Definitions.h>
 
 #include <cstdio>
@@ -80,11 +81,8 @@ constexpr lib::PixelInt pxData[] =
 #undef X
 #undef _
 
-constexpr lib::Bitmap bmpTest =
-{
-	/* ppxData */ const_cast<lib::PixelInt *>(pxData),
-	/* size    */ { /* x */ 10, /* y */ 10}
-};
+// compiled to spans at compile time --> no preprocessing at runtime
+constexpr auto oSpriteTest = lib::BakeSprite<10, pxData>();
 
 void __stdcall DrawState_(
 	rlGameCanvas    canvas,
@@ -101,7 +99,8 @@ void __stdcall DrawState_(
 	{
 		*ppxBackground = lib::Color::White;
 
-		lib::ApplyBitmapOverlay(&poLayers[0].bmp, &bmpTest, 0, 0, lib::BitmapOverlayStrategy::Replace);
+		lib::ApplySpriteOverlay(&poLayers[0].bmp, oSpriteTest, 0, 0,
+			lib::BitmapOverlayStrategy::Blend, poLayers[0].poDirtyRects);
 	}
 
 	const auto &state = *reinterpret_cast<const GameState *>(pcvState);
@@ -114,6 +113,10 @@ void __stdcall DrawState_(
 		poLayers[0].bmp.ppxData[36] = pxEyeTop;
 		poLayers[0].bmp.ppxData[42] = pxEyeBottom;
 		poLayers[0].bmp.ppxData[47] = pxEyeBottom;
+
+		// only the eyes need to be uploaded again
+		lib::AddDirtyRect(poLayers[0].poDirtyRects,
+			{ /* iLeft */ 2, /* iTop */ 3, /* iRight */ 8, /* iBottom */ 5 });
 	}
 }
 
@@ -150,6 +153,8 @@ int main(int argc, char* argv[])
 	sc.fnUpdateState  = UpdateState;
 	sc.fnDrawState    = DrawState_;
 
+	sc.iFlags = RL_GAMECANVAS_SUP_DIRTY_RECTS;
+
 	try
 	{
 		lib::GameCanvas gc(sc);
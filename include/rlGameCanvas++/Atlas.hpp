@@ -0,0 +1,100 @@
+#ifndef RLGAMECANVAS_ATLAS_CPP
+#define RLGAMECANVAS_ATLAS_CPP
+
+
+
+
+
+#include "Bitmap.hpp"
+
+#include <cstddef>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class Atlas;
+
+	bool ApplyAtlasRegionOverlay(
+		Bitmap               *poBase,
+		const Atlas          &oAtlas,
+		UInt                  iRegion,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	bool ApplyAtlasRegionOverlay_Scaled(
+		Bitmap               *poBase,
+		const Atlas          &oAtlas,
+		UInt                  iRegion,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		UInt                  iOverlayScaledWidth,
+		UInt                  iOverlayScaledHeight,
+		BitmapOverlayStrategy eOverlayStrategy,
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+
+
+	// Many small bitmaps, packed into a single contiguous sheet.
+	// Region i of the atlas contains the i-th bitmap it was created from.
+	class Atlas final
+	{
+	public: // methods
+
+		// Pack bitmaps into a new sheet that is at most iMaxWidth pixels wide (0 = pick a roughly
+		// square size) and copy their pixels. The bitmaps are not referenced after the call.
+		// iPadding transparent pixels are kept between the regions, so bilinear scaling doesn't
+		// bleed into the neighboring regions.
+		// Check valid() afterwards.
+		Atlas(const Bitmap *pcoBitmaps, UInt iBitmapCount, UInt iMaxWidth = 0, UInt iPadding = 0);
+		// Load an atlas that was saved via save().
+		// Check valid() afterwards.
+		Atlas(const void *pData, size_t iSize);
+		Atlas(const Atlas &) = delete;
+		Atlas(Atlas &&rval) noexcept;
+		~Atlas();
+
+		Atlas &operator=(const Atlas &) = delete;
+		Atlas &operator=(Atlas &&rval) noexcept;
+
+		// Was the atlas successfully packed/loaded?
+		bool valid() const;
+
+		// The whole sheet.
+		const Bitmap &bitmap() const;
+
+		UInt regionCount() const;
+		// The area of the sheet a region occupies.
+		// iRegion must be smaller than regionCount().
+		const Rect &region(UInt iRegion) const;
+		// A view of the pixels of a region, for drawing it via the Bitmap API.
+		// iRegion must be smaller than regionCount().
+		BitmapView regionView(UInt iRegion) const;
+
+		// The size of the data written by save(), in bytes.
+		size_t saveSize() const;
+		// Write the atlas to a buffer of at least saveSize() bytes, so it can be loaded later on
+		// without packing it again.
+		bool save(void *pBuffer, size_t iBufferSize) const;
+
+
+	private: // types
+
+		class PIMPL;
+		PIMPL *m_pPIMPL = nullptr;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_ATLAS_CPP
\ No newline at end of file
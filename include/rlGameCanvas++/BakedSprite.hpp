@@ -0,0 +1,280 @@
+#ifndef RLGAMECANVAS_BAKEDSPRITE_CPP
+#define RLGAMECANVAS_BAKEDSPRITE_CPP
+
+
+
+
+
+#include "Sprite.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator> // std::data, std::size
+
+
+
+namespace rlGameCanvasLib
+{
+
+	/*
+		BAKED SPRITES
+		Sprites that are compiled at compile time, from a constexpr pixel array.
+
+		A baked sprite holds exactly the same spans as a Sprite created from the same pixels, but
+		it's a literal type - so a constexpr baked sprite is stored in the read-only data of the
+		executable and needs neither any preprocessing at startup nor any heap memory.
+
+		Example:
+		  #define X 0xFF000000
+		  #define _ 0x00000000
+		  constexpr PixelInt pxSmiley[] = { _,X,X,_, X,_,_,X, ... };
+		  #undef X
+		  #undef _
+		  constexpr auto oSmiley = BakeSprite<4, pxSmiley>();
+
+		  ApplySpriteOverlay(&bmp, oSmiley, iX, iY, BitmapOverlayStrategy::Blend);
+
+		Pixel art can also be written as text, see PixelsFromArt().
+	*/
+
+
+
+	// The kind of alpha values of the pixels of a span.
+	enum class SpriteRunType : unsigned char
+	{
+		Transparent,
+		Opaque,
+		Translucent
+	};
+
+	// A character of pixel art, see PixelsFromArt().
+	struct ArtColor
+	{
+		char     ch;
+		PixelInt px;
+	};
+
+	namespace SpriteBaking
+	{
+
+		// Opaque runs and transparent gaps shorter than this are merged into the surrounding
+		// translucent runs.
+		constexpr UInt iMinSeparateRunLength = 8;
+
+		// The number of pixels the blend kernels process at once.
+		constexpr UInt iBlendGranularity = 8;
+
+		struct Counts
+		{
+			size_t iSpans;
+			size_t iPixels;
+		};
+
+		constexpr SpriteRunType GetRunType(PixelInt px)
+		{
+			switch (px >> 24)
+			{
+			case 0:
+				return SpriteRunType::Transparent;
+			case 255:
+				return SpriteRunType::Opaque;
+			default:
+				return SpriteRunType::Translucent;
+			}
+		}
+
+		// Decide how every pixel of a row is drawn. pTypes must hold iWidth elements.
+		constexpr void ClassifyRow(const PixelInt *pRow, UInt iWidth, SpriteRunType *pTypes)
+		{
+			// split the row into runs of pixels with the same kind of alpha value.
+			// short opaque runs and short gaps between visible pixels are cheaper to blend than
+			// to handle separately, as the blend kernels are way faster on longer rows.
+			for (UInt iX = 0; iX < iWidth;)
+			{
+				const SpriteRunType eType  = GetRunType(pRow[iX]);
+				const UInt          iStart = iX;
+				do
+				{
+					++iX;
+				} while (iX < iWidth && GetRunType(pRow[iX]) == eType);
+
+				SpriteRunType eResult = eType;
+				if (iX - iStart < iMinSeparateRunLength &&
+					(eType == SpriteRunType::Opaque || (iStart > 0 && iX < iWidth)))
+					eResult = SpriteRunType::Translucent;
+
+				for (UInt i = iStart; i < iX; ++i)
+				{
+					pTypes[i] = eResult;
+				}
+			}
+
+			// the blend kernels process 8 pixels at a time, the remainder is slow.
+			// blending a transparent or opaque pixel gives the same result as skipping/copying
+			// it, so the translucent runs are extended to a multiple of 8 pixels.
+			for (UInt iX = 0; iX < iWidth;)
+			{
+				if (pTypes[iX] != SpriteRunType::Translucent)
+				{
+					++iX;
+					continue;
+				}
+
+				UInt iEnd = iX;
+				while (iEnd < iWidth && pTypes[iEnd] == SpriteRunType::Translucent)
+				{
+					++iEnd;
+				}
+				const UInt iBlocks    = (iEnd - iX + iBlendGranularity - 1) / iBlendGranularity;
+				UInt       iPaddedEnd = iX + iBlocks * iBlendGranularity;
+				if (iPaddedEnd > iWidth)
+					iPaddedEnd = iWidth;
+				for (UInt i = iEnd; i < iPaddedEnd; ++i)
+				{
+					pTypes[i] = SpriteRunType::Translucent;
+				}
+
+				iX = iPaddedEnd;
+			}
+		}
+
+		// Compile the pixels of a sprite to spans.
+		// pTypes must hold size.x elements.
+		// If pSpans is nullptr, the spans are only counted. Otherwise, pSpans, pRowStart and
+		// pPixels must be large enough for the counts that were returned before.
+		constexpr Counts BakeRows(const PixelInt *ppxData, const Resolution &size,
+			SpriteRunType *pTypes, SpriteSpan *pSpans, size_t *pRowStart, PixelInt *pPixels)
+		{
+			Counts oCounts = {};
+
+			const PixelInt *pRow = ppxData;
+			for (UInt iY = 0; iY < size.y; ++iY, pRow += size.x)
+			{
+				if (pSpans)
+					pRowStart[iY] = oCounts.iSpans;
+
+				ClassifyRow(pRow, size.x, pTypes);
+
+				// store the visible runs
+				for (UInt iX = 0; iX < size.x;)
+				{
+					const SpriteRunType eType  = pTypes[iX];
+					const UInt          iStart = iX;
+					do
+					{
+						++iX;
+					} while (iX < size.x && pTypes[iX] == eType);
+
+					if (eType == SpriteRunType::Transparent)
+						continue;
+
+					const bool bOpaque = (eType == SpriteRunType::Opaque);
+					if (pSpans)
+					{
+						pSpans[oCounts.iSpans] = { iStart, iX - iStart, bOpaque, oCounts.iPixels };
+
+						// transparent pixels inside a translucent run must not have any effect,
+						// even when blending with premultiplied alpha
+						for (UInt i = iStart; i < iX; ++i)
+						{
+							pPixels[oCounts.iPixels + (i - iStart)] =
+								(!bOpaque && (pRow[i] >> 24) == 0) ? 0 : pRow[i];
+						}
+					}
+
+					++oCounts.iSpans;
+					oCounts.iPixels += iX - iStart;
+				}
+			}
+			if (pSpans)
+				pRowStart[size.y] = oCounts.iSpans;
+
+			return oCounts;
+		}
+
+		template <UInt iWidth>
+		constexpr Counts Count(const PixelInt *ppxData, UInt iHeight)
+		{
+			SpriteRunType oTypes[iWidth] = {};
+			return BakeRows(ppxData, { iWidth, iHeight }, oTypes, nullptr, nullptr, nullptr);
+		}
+
+	}
+
+
+
+	// A sprite that was compiled at compile time. Create via BakeSprite().
+	template <UInt iWidth, UInt iHeight, size_t iSpanCount, size_t iPixelCount>
+	struct BakedSprite
+	{
+		// the arrays always have at least one element, as arrays of size 0 are not allowed
+		SpriteSpan oSpans[iSpanCount ? iSpanCount : 1];
+		size_t     iRowStart[iHeight + 1];
+		PixelInt   pxPixels[iPixelCount ? iPixelCount : 1];
+
+		constexpr Resolution size() const { return { iWidth, iHeight }; }
+
+		constexpr operator SpriteSpanView() const
+		{
+			return { { iWidth, iHeight }, oSpans, iRowStart, pxPixels };
+		}
+	};
+
+	// Compile a constexpr array of pixels (a C array or a std::array) with rows of iWidth pixels
+	// to a sprite, at compile time.
+	template <UInt iWidth, const auto &pxData>
+	constexpr auto BakeSprite()
+	{
+		constexpr size_t iTotalPixels = std::size(pxData);
+		static_assert(iWidth > 0 && iTotalPixels % iWidth == 0,
+			"The pixel count must be a multiple of the width");
+
+		constexpr UInt iHeight = UInt(iTotalPixels / iWidth);
+		constexpr auto oCounts = SpriteBaking::Count<iWidth>(std::data(pxData), iHeight);
+
+		BakedSprite<iWidth, iHeight, oCounts.iSpans, oCounts.iPixels> oResult = {};
+		SpriteRunType oTypes[iWidth] = {};
+		SpriteBaking::BakeRows(std::data(pxData), { iWidth, iHeight }, oTypes, oResult.oSpans,
+			oResult.iRowStart, oResult.pxPixels);
+
+		return oResult;
+	}
+
+	// Convert pixel art, written as text with one character per pixel, to pixels at compile
+	// time. The rows are simply written one after another (adjacent string literals are joined):
+	//
+	//   constexpr auto pxArt = PixelsFromArt<4, 2>(
+	//       " XX "
+	//       "X..X",
+	//       { { ' ', 0x00000000 }, { 'X', 0xFF000000 }, { '.', 0xFFFFFFFF } }
+	//   );
+	//   constexpr auto oSprite = BakeSprite<4, pxArt>();
+	//
+	// A character that's not in the palette is a compile error.
+	template <UInt iWidth, UInt iHeight, size_t iColorCount>
+	constexpr std::array<PixelInt, (size_t)iWidth * iHeight> PixelsFromArt(
+		const char (&szArt)[(size_t)iWidth * iHeight + 1],
+		const ArtColor (&oPalette)[iColorCount]
+	)
+	{
+		std::array<PixelInt, (size_t)iWidth * iHeight> oResult = {};
+		for (size_t i = 0; i < oResult.size(); ++i)
+		{
+			size_t iColor = 0;
+			while (oPalette[iColor].ch != szArt[i])
+			{
+				++iColor; // beyond the palette --> not a constant expression
+			}
+			oResult[i] = oPalette[iColor].px;
+		}
+
+		return oResult;
+	}
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_BAKEDSPRITE_CPP
\ No newline at end of file
@@ -6,16 +6,39 @@
 
 
 #include "Types.hpp"
+#include "../rlGameCanvas/Bitmap.h" // rlGameCanvas_BitmapView
 
 
 
 namespace rlGameCanvasLib
 {
 
+	// Add a rectangle to a list of changed areas.
+	// All drawing functions add the area they changed to poDirtyRects if it's not nullptr.
+	bool AddDirtyRect(DirtyRects *poDirtyRects, const Rect &rect);
+
+
+
+	// A view of a rectangular area of pixels within a bigger buffer.
+	// The rows are iStride pixels apart. The view doesn't own the pixels, so it's cheap to copy.
+	using BitmapView = rlGameCanvas_BitmapView;
+
+	// A view of a whole bitmap.
+	BitmapView GetBitmapView(const Bitmap &bmp);
+	// A view of a part of another view. The rectangle is clipped to the view.
+	BitmapView GetBitmapSubView(const BitmapView &oView, const Rect &rect);
+
+
+
+	// See the RL_GAMECANVAS_BMP_OVERLAY_[...] values for descriptions.
 	enum class BitmapOverlayStrategy
 	{
 		Replace,
-		Blend
+		Blend,
+		BlendPremultiplied,
+		Add,
+		Multiply,
+		Screen
 	};
 
 	bool ApplyBitmapOverlay(
@@ -23,7 +46,61 @@ namespace rlGameCanvasLib
 		const Bitmap         *poOverlay,
 		Int                   iOverlayX,
 		Int                   iOverlayY,
-		BitmapOverlayStrategy eOverlayStrategy
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	// The pixels of oBase are changed, the view itself isn't.
+	// The changed area added to poDirtyRects is in coordinates of oBase.
+	bool ApplyBitmapOverlay(
+		const BitmapView     &oBase,
+		const BitmapView     &oOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	// Mix the colors of the overlay with pxTint, weighted by the alpha value of pxTint, and blend
+	// the result onto the base bitmap (e.g. to let a sprite flash in a single color).
+	// The overlay must have straight alpha.
+	bool ApplyBitmapOverlay_Tinted(
+		Bitmap       *poBase,
+		const Bitmap *poOverlay,
+		Int           iOverlayX,
+		Int           iOverlayY,
+		PixelInt      pxTint,
+		DirtyRects   *poDirtyRects = nullptr
+	);
+
+	// The pixels of oBase are changed, the view itself isn't.
+	// The changed area added to poDirtyRects is in coordinates of oBase.
+	bool ApplyBitmapOverlay_Tinted(
+		const BitmapView &oBase,
+		const BitmapView &oOverlay,
+		Int               iOverlayX,
+		Int               iOverlayY,
+		PixelInt          pxTint,
+		DirtyRects       *poDirtyRects = nullptr
+	);
+
+
+
+	struct BitmapOverlayBatchEntry
+	{
+		const Bitmap         *poOverlay;
+		Int                   iX;
+		Int                   iY;
+		BitmapOverlayStrategy eOverlayStrategy;
+	};
+
+	// bMultithreaded = draw the batch via the pool of SetBitmapParallelism, if enabled.
+	bool ApplyBitmapOverlayBatch(
+		Bitmap                        *poBase,
+		const BitmapOverlayBatchEntry *pcoEntries,
+		UInt                           iEntryCount,
+		bool                           bMultithreaded = false,
+		DirtyRects                    *poDirtyRects   = nullptr
 	);
 
 
@@ -42,9 +119,65 @@ namespace rlGameCanvasLib
 		UInt                  iOverlayScaledWidth,
 		UInt                  iOverlayScaledHeight,
 		BitmapOverlayStrategy eOverlayStrategy,
-		BitmapScalingStrategy eScalingStrategy
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects = nullptr
 	);
 
+	// The pixels of oBase are changed, the view itself isn't.
+	// The changed area added to poDirtyRects is in coordinates of oBase.
+	bool ApplyBitmapOverlay_Scaled(
+		const BitmapView     &oBase,
+		const BitmapView     &oOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		UInt                  iOverlayScaledWidth,
+		UInt                  iOverlayScaledHeight,
+		BitmapOverlayStrategy eOverlayStrategy,
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	constexpr UInt iDefaultParallelMinPixelCount = 256 * 256;
+
+	// Split calls of ApplyBitmapOverlay[_Tinted/_Scaled] that change at least iMinPixelCount
+	// pixels (and multithreaded batches on base bitmaps of that size) into bands of rows that
+	// are drawn by a shared pool of iThreadCount threads (0 = one per logical processor).
+	// The result is the same as when drawing on a single thread.
+	// iThreadCount = 1 stops the threads again; this is the default.
+	// Calls from multiple threads at once are fine, but only one of them uses the pool at a time.
+	bool SetBitmapParallelism(UInt iThreadCount,
+		UInt iMinPixelCount = iDefaultParallelMinPixelCount);
+
+
+
+	// Supported strategies:
+	// * Replace
+	// * Blend (index 0 is transparent)
+	bool ApplyIndexedBitmapOverlay(
+		IndexedBitmap        *poBase,
+		const IndexedBitmap  *poOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	// pcpxPalette must contain 256 pixels.
+	bool ApplyIndexedBitmapOverlayRGBA(
+		Bitmap               *poBase,
+		const IndexedBitmap  *poOverlay,
+		const PixelInt       *pcpxPalette,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+
+
+	bool PremultiplyBitmap(Bitmap *poBitmap);
+	bool UnpremultiplyBitmap(Bitmap *poBitmap);
+
 }
 
 
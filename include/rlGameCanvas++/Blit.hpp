@@ -0,0 +1,219 @@
+#ifndef RLGAMECANVAS_BLIT_CPP
+#define RLGAMECANVAS_BLIT_CPP
+
+
+
+
+
+#include "Bitmap.hpp"
+
+#include <cstddef>
+#include <type_traits>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	/*
+		BLIT
+		Header-only drawing of a bitmap onto another one with a pixel operator that's known at
+		compile time.
+
+		The clipping is done once per call; the operator is then applied to every visible row. An
+		operator is a function object of one of the following forms:
+
+		  Per pixel: PixelInt operator()(PixelInt pxDest, PixelInt pxSrc) const
+		             Returns the new destination pixel. Called in a simple loop, so the compiler
+		             can inline and auto-vectorize it.
+		  Per row:   void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+		             Processes iCount pixels of a row at once.
+
+		Example: Draw a sprite as a silhouette in a single color.
+		  struct Silhouette
+		  {
+		      PixelInt pxColor;
+		      PixelInt operator()(PixelInt pxDest, PixelInt pxSrc) const
+		      {
+		          return (pxSrc >> 24) ? pxColor : pxDest;
+		      }
+		  };
+		  Blit(oLayer, oSprite, iX, iY, Silhouette{ 0xFF0000FF });
+
+		The built-in overlay strategies are available as per-row operators in BlitOp. They use the
+		fastest implementation supported by the CPU.
+	*/
+
+
+
+	// A blit that was clipped to the destination.
+	struct BlitClipping
+	{
+		UInt iSrcX; // the first visible pixel of the source
+		UInt iSrcY;
+		Rect rectDest; // the visible area, in coordinates of the destination
+	};
+
+	// Clip a source of size resSrc at position (iX, iY) to a destination of size resDest.
+	// Returns false if the source is completely invisible (oClipping is undefined then).
+	inline bool ClipBlit(const Resolution &resDest, Int iX, Int iY, const Resolution &resSrc,
+		BlitClipping &oClipping)
+	{
+		// check if too far right and/or down
+		if (
+			(iX > 0 && UInt(iX) >= resDest.x) ||
+			(iY > 0 && UInt(iY) >= resDest.y)
+		)
+			return false;
+
+
+		oClipping.iSrcX = (iX < 0) ? UInt(-iX) : 0;
+		oClipping.iSrcY = (iY < 0) ? UInt(-iY) : 0;
+
+		if (oClipping.iSrcX >= resSrc.x || oClipping.iSrcY >= resSrc.y)
+			return false; // too far left and/or up
+
+
+		Resolution resVisible =
+		{
+			/* x */ resSrc.x - oClipping.iSrcX,
+			/* y */ resSrc.y - oClipping.iSrcY
+		};
+
+		const UInt iRightmost  = UInt(iX + Int(resSrc.x));
+		const UInt iBottommost = UInt(iY + Int(resSrc.y));
+
+		if (iRightmost >= resDest.x)
+			resVisible.x -= iRightmost  - resDest.x;
+		if (iBottommost >= resDest.y)
+			resVisible.y -= iBottommost - resDest.y;
+
+		auto &rect = oClipping.rectDest;
+		rect.iLeft   = UInt(iX + Int(oClipping.iSrcX));
+		rect.iTop    = UInt(iY + Int(oClipping.iSrcY));
+		rect.iRight  = rect.iLeft + resVisible.x;
+		rect.iBottom = rect.iTop  + resVisible.y;
+
+		return true;
+	}
+
+	// Does a view describe a valid area of pixels?
+	inline bool IsValidBitmapView(const BitmapView &oView)
+	{
+		if (oView.iStride < oView.size.x)
+			return false;
+
+		return oView.ppxData != nullptr || oView.size.x == 0 || oView.size.y == 0;
+	}
+
+	// Apply an operator to the rows iTop to iBottom - 1 (in coordinates of the destination) of a
+	// clipped blit.
+	// Blit() calls this for all visible rows; it's only needed for splitting a blit into bands.
+	template <typename TOp>
+	void BlitRows(const BitmapView &oDest, const BitmapView &oSrc, const BlitClipping &oClipping,
+		UInt iTop, UInt iBottom, const TOp &op)
+	{
+		const auto  &rect   = oClipping.rectDest;
+		const size_t iWidth = rect.iRight - rect.iLeft;
+
+		const PixelInt *pSrc = oSrc.ppxData +
+			((size_t)(oClipping.iSrcY + iTop - rect.iTop) * oSrc.iStride + oClipping.iSrcX);
+		PixelInt *pDest = oDest.ppxData + ((size_t)iTop * oDest.iStride + rect.iLeft);
+
+		for (UInt iY = iTop; iY < iBottom; ++iY, pSrc += oSrc.iStride, pDest += oDest.iStride)
+		{
+			if constexpr (std::is_invocable_v<const TOp &, PixelInt *, const PixelInt *, size_t>)
+				op(pDest, pSrc, iWidth);
+			else
+			{
+				for (size_t iX = 0; iX < iWidth; ++iX)
+				{
+					pDest[iX] = op(pDest[iX], pSrc[iX]);
+				}
+			}
+		}
+	}
+
+	// Draw oSrc onto oDest at position (iX, iY), combining the pixels via op.
+	// The pixels of oDest are changed, the view itself isn't.
+	// The changed area added to poDirtyRects is in coordinates of oDest.
+	template <typename TOp>
+	bool Blit(const BitmapView &oDest, const BitmapView &oSrc, Int iX, Int iY,
+		const TOp &op = TOp(), DirtyRects *poDirtyRects = nullptr)
+	{
+		if (!IsValidBitmapView(oDest) || !IsValidBitmapView(oSrc))
+			return false;
+
+		BlitClipping oClipping;
+		if (!ClipBlit(oDest.size, iX, iY, oSrc.size, oClipping))
+			return true;
+
+		BlitRows(oDest, oSrc, oClipping, oClipping.rectDest.iTop, oClipping.rectDest.iBottom, op);
+
+		AddDirtyRect(poDirtyRects, oClipping.rectDest);
+		return true;
+	}
+
+	template <typename TOp>
+	bool Blit(Bitmap *poDest, const Bitmap *poSrc, Int iX, Int iY,
+		const TOp &op = TOp(), DirtyRects *poDirtyRects = nullptr)
+	{
+		if (poDest == nullptr || poSrc == nullptr)
+			return false;
+
+		return Blit(GetBitmapView(*poDest), GetBitmapView(*poSrc), iX, iY, op, poDirtyRects);
+	}
+
+
+
+	// The built-in overlay strategies as per-row operators for Blit().
+	namespace BlitOp
+	{
+
+		struct Replace final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		struct Blend final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		struct BlendPremultiplied final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		struct Add final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		struct Multiply final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		struct Screen final
+		{
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+		// See ApplyBitmapOverlay_Tinted.
+		struct Tint final
+		{
+			PixelInt pxTint;
+
+			void operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const;
+		};
+
+	}
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_BLIT_CPP
\ No newline at end of file
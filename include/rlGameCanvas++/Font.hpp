@@ -0,0 +1,114 @@
+#ifndef RLGAMECANVAS_FONT_CPP
+#define RLGAMECANVAS_FONT_CPP
+
+
+
+
+
+#include "Bitmap.hpp"
+#include "Pixel.hpp"
+#include "../rlGameCanvas/Font.h" // rlGameCanvas_Glyph
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class Font;
+
+	using Glyph = rlGameCanvas_Glyph;
+
+	// Get the size of a text, in pixels.
+	// Lines are separated by '\n'.
+	Resolution MeasureText(const Font &oFont, const U8Char *szText);
+
+	// Draw a UTF-8 text with the font's glyphs tinted by pxColor.
+	// Only BitmapOverlayStrategy::Blend and BitmapOverlayStrategy::BlendPremultiplied are
+	// supported; with BlendPremultiplied, the font's bitmap must have premultiplied alpha.
+	// The font caches the rendered texts, so the font must not be used by multiple threads at
+	// once.
+	bool ApplyTextOverlay(
+		Bitmap               *poBase,
+		Font                 &oFont,
+		const U8Char         *szText,
+		Pixel                 pxColor,
+		Int                   iX,
+		Int                   iY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+
+
+	// A bitmap font, with every glyph compiled to a list of visible pixel runs per row.
+	// The glyphs are multiplied with the text color, so white glyphs take on the text color.
+	// Texts are rendered once and then kept in a cache of the most recently drawn texts, so
+	// drawing an unchanged text is as fast as drawing a sprite.
+	class Font final
+	{
+	public: // static variables
+
+		static constexpr UInt iDefaultCacheSize = 64;
+
+
+	public: // methods
+
+		// A font with glyphs of a fixed size, laid out in a grid from left to right, top to
+		// bottom. The first cell contains the code point iFirstCodePoint, the following cells the
+		// following code points. Incomplete cells on the right and bottom edges are ignored.
+		// Check valid() afterwards.
+		Font(const Bitmap &bmp, const Resolution &oCellSize, UInt iFirstCodePoint,
+			UInt iCacheSize = iDefaultCacheSize);
+		// A font with glyphs of individual sizes, taken from areas of bmp.
+		// Check valid() afterwards.
+		Font(const Bitmap &bmp, const Glyph *pcoGlyphs, UInt iGlyphCount, UInt iLineHeight,
+			UInt iCacheSize = iDefaultCacheSize);
+		Font(const Font &) = delete;
+		Font(Font &&rval) noexcept;
+		~Font();
+
+		Font &operator=(const Font &) = delete;
+		Font &operator=(Font &&rval) noexcept;
+
+		// Were the glyphs successfully compiled?
+		bool valid() const;
+
+		UInt lineHeight() const;
+
+		// The maximum count of rendered texts the font keeps.
+		UInt cacheSize() const;
+		// The count of rendered texts the font currently keeps.
+		UInt cachedTextCount() const;
+		// The count of texts that were rendered so far, i.e. the count of cache misses.
+		size_t renderCount() const;
+		// Remove all rendered texts from the cache.
+		void clearCache();
+
+
+	private: // types
+
+		class PIMPL;
+		PIMPL *m_pPIMPL = nullptr;
+
+
+		friend Resolution MeasureText(const Font &oFont, const U8Char *szText);
+		friend bool ApplyTextOverlay(
+			Bitmap               *poBase,
+			Font                 &oFont,
+			const U8Char         *szText,
+			Pixel                 pxColor,
+			Int                   iX,
+			Int                   iY,
+			BitmapOverlayStrategy eOverlayStrategy,
+			DirtyRects           *poDirtyRects
+		);
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_FONT_CPP
\ No newline at end of file
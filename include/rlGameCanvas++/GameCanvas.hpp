@@ -23,6 +23,10 @@ namespace rlGameCanvasLib
 		bool run();
 		void quit();
 
+		// Get statistics about the texture uploads.
+		// Can be called from any thread.
+		UploadStatistics getUploadStatistics() const;
+
 		
 	private: // types
 
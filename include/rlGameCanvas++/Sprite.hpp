@@ -0,0 +1,103 @@
+#ifndef RLGAMECANVAS_SPRITE_CPP
+#define RLGAMECANVAS_SPRITE_CPP
+
+
+
+
+
+#include "Bitmap.hpp"
+
+#include <cstddef>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class Sprite;
+
+
+
+	// A run of consecutive visible pixels within a row of a sprite.
+	// The fully transparent pixels between the spans are not stored at all.
+	struct SpriteSpan
+	{
+		UInt   iX;          // first pixel of the span
+		UInt   iLength;     // number of pixels
+		bool   bOpaque;     // all pixels opaque --> copy, otherwise blend
+		size_t iDataOffset; // index of the first pixel in the pixel data
+	};
+
+	// The compiled data of a sprite, as stored by Sprite or BakedSprite (see BakedSprite.hpp).
+	struct SpriteSpanView
+	{
+		Resolution        size;
+		const SpriteSpan *pcoSpans;
+		const size_t     *pcoRowStart; // index of the first span of every row + end index
+		const PixelInt   *pcoPixels;   // pixel data of all spans
+	};
+
+	// Only BitmapOverlayStrategy::Blend and BitmapOverlayStrategy::BlendPremultiplied are
+	// supported.
+	bool ApplySpriteOverlay(
+		Bitmap               *poBase,
+		const Sprite         &oSprite,
+		Int                   iSpriteX,
+		Int                   iSpriteY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+	// Draw compiled sprite data, e.g. a BakedSprite.
+	bool ApplySpriteOverlay(
+		Bitmap               *poBase,
+		const SpriteSpanView &oSprite,
+		Int                   iSpriteX,
+		Int                   iSpriteY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects = nullptr
+	);
+
+
+
+	// A bitmap that was compiled to a list of opaque and translucent pixel runs per row.
+	// Pixels with an alpha value of 0 are skipped entirely when drawing.
+	class Sprite final
+	{
+	public: // methods
+
+		Sprite(const Bitmap &bmp);
+		Sprite(const Sprite &) = delete;
+		Sprite(Sprite &&rval) noexcept;
+		~Sprite();
+
+		Sprite &operator=(const Sprite &) = delete;
+		Sprite &operator=(Sprite &&rval) noexcept;
+
+		const Resolution &size() const;
+
+
+	private: // types
+
+		class PIMPL;
+		PIMPL *m_pPIMPL = nullptr;
+
+
+		friend bool ApplySpriteOverlay(
+			Bitmap               *poBase,
+			const Sprite         &oSprite,
+			Int                   iSpriteX,
+			Int                   iSpriteY,
+			BitmapOverlayStrategy eOverlayStrategy,
+			DirtyRects           *poDirtyRects
+		);
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_SPRITE_CPP
\ No newline at end of file
@@ -24,7 +24,16 @@ namespace rlGameCanvasLib
 
 	using Resolution = rlGameCanvas_Resolution;
 
-	using Bitmap = rlGameCanvas_Bitmap;
+	using Bitmap        = rlGameCanvas_Bitmap;
+	using IndexedBitmap = rlGameCanvas_IndexedBitmap;
+
+	using Rect       = rlGameCanvas_Rect;
+	using DirtyRects = rlGameCanvas_DirtyRects;
+
+	using TileIndex = rlGameCanvas_TileIndex;
+	using Tilemap   = rlGameCanvas_Tilemap;
+
+	using UploadStatistics = rlGameCanvas_UploadStatistics;
 
 	using CreateStateCallback  = rlGameCanvas_CreateStateCallback;
 	using DestroyStateCallback = rlGameCanvas_DestroyStateCallback;
@@ -0,0 +1,205 @@
+/***************************************************************************************************
+  rlGameCanvas ATLAS API
+  ======================
+
+  This file contains function definitions for handling sprite atlases within the rlGameCanvas
+  library.
+
+  An atlas packs many small bitmaps into a single contiguous sheet, so drawing a lot of different
+  sprites in a frame doesn't jump around in memory. Every bitmap ends up in a region of the sheet,
+  which can be drawn like a bitmap of its own.
+
+  Packing is done when the atlas is created. The result can be saved and loaded again later on,
+  so the packing can also be done ahead of time.
+
+  (c) 2024 RobinLe
+***************************************************************************************************/
+#ifndef RLGAMECANVAS_ATLAS_C
+#define RLGAMECANVAS_ATLAS_C
+
+
+
+
+
+#include "ExportSpecs.h"
+#include "Types.h"
+#include "Bitmap.h"
+
+
+
+typedef struct rlGameCanvas_AtlasOpaquePtrStruct
+{
+	int iUnused;
+} *rlGameCanvas_Atlas;
+
+
+
+/// <summary>
+/// Pack bitmaps into a new atlas.<para />
+/// Region <c>i</c> of the atlas contains the bitmap <c>pcoBitmaps[i]</c>.
+/// </summary>
+/// <param name="pcoBitmaps">
+/// The bitmaps to pack. They're not referenced after the call.
+/// </param>
+/// <param name="iBitmapCount">The count of elements in <c>pcoBitmaps</c>.</param>
+/// <param name="iMaxWidth">
+/// The maximum width of the sheet, in pixels.<para />
+/// If zero, a roughly square sheet is created.
+/// </param>
+/// <param name="iPadding">
+/// The count of transparent pixels between two regions.<para />
+/// Should be at least 1 if the regions are drawn with bilinear scaling.
+/// </param>
+/// <returns>
+/// If the function succeeded, the return value is the handle of the newly created atlas.<para/>
+/// If the function failed, the return value is zero.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Atlas RLGAMECANVAS_LIB rlGameCanvas_CreateAtlas(
+	const rlGameCanvas_Bitmap *pcoBitmaps,
+	rlGameCanvas_UInt          iBitmapCount,
+	rlGameCanvas_UInt          iMaxWidth,
+	rlGameCanvas_UInt          iPadding
+);
+
+/// <summary>
+/// Load an atlas that was saved via <c>rlGameCanvas_SaveAtlas</c>.
+/// </summary>
+/// <param name="pcData">The saved data.</param>
+/// <param name="iSize">The size of the saved data, in bytes.</param>
+/// <returns>
+/// If the function succeeded, the return value is the handle of the newly created atlas.<para/>
+/// If the function failed (e.g. the data is invalid), the return value is zero.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Atlas RLGAMECANVAS_LIB rlGameCanvas_LoadAtlas(
+	const void *pcData,
+	size_t      iSize
+);
+
+/// <summary>
+/// Destroy an atlas.
+/// </summary>
+/// <param name="atlas">The handle of the atlas to be destroyed.</param>
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroyAtlas(
+	rlGameCanvas_Atlas atlas
+);
+
+
+
+/// <summary>
+/// Get the size of the data written by <c>rlGameCanvas_SaveAtlas</c>.
+/// </summary>
+/// <param name="atlas">The atlas.</param>
+/// <returns>The size of the data, in bytes. Zero on failure.</returns>
+RLGAMECANVAS_API size_t RLGAMECANVAS_LIB rlGameCanvas_GetAtlasSaveSize(
+	rlGameCanvas_Atlas atlas
+);
+
+/// <summary>
+/// Save an atlas to a buffer, so it can be loaded via <c>rlGameCanvas_LoadAtlas</c> later on.
+/// </summary>
+/// <param name="atlas">The atlas.</param>
+/// <param name="pBuffer">The buffer the atlas should be written to.</param>
+/// <param name="iBufferSize">
+/// The size of <c>pBuffer</c>, in bytes.<para />
+/// Must be at least the value returned by <c>rlGameCanvas_GetAtlasSaveSize</c>.
+/// </param>
+/// <returns>Was the atlas successfully saved?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_SaveAtlas(
+	rlGameCanvas_Atlas atlas,
+	void              *pBuffer,
+	size_t             iBufferSize
+);
+
+
+
+/// <summary>
+/// Get the whole sheet of an atlas.
+/// </summary>
+/// <param name="atlas">The atlas.</param>
+/// <param name="poBitmap">
+/// The sheet. The pixels belong to the atlas and are only valid until it's destroyed.
+/// </param>
+/// <returns>Was the sheet successfully retrieved?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetAtlasBitmap(
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_Bitmap *poBitmap
+);
+
+/// <summary>
+/// Get the count of regions of an atlas.
+/// </summary>
+/// <param name="atlas">The atlas.</param>
+/// <returns>The count of regions. Zero on failure.</returns>
+RLGAMECANVAS_API rlGameCanvas_UInt RLGAMECANVAS_LIB rlGameCanvas_GetAtlasRegionCount(
+	rlGameCanvas_Atlas atlas
+);
+
+/// <summary>
+/// Get a region of an atlas.
+/// </summary>
+/// <param name="atlas">The atlas.</param>
+/// <param name="iRegion">The index of the region.</param>
+/// <param name="poRect">Optional. The area of the sheet the region occupies.</param>
+/// <param name="poView">
+/// Optional. A view of the pixels of the region, for use with the Bitmap API.<para />
+/// The pixels belong to the atlas and are only valid until it's destroyed.
+/// </param>
+/// <returns>Was the region successfully retrieved?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetAtlasRegion(
+	rlGameCanvas_Atlas       atlas,
+	rlGameCanvas_UInt        iRegion,
+	rlGameCanvas_Rect       *poRect,
+	rlGameCanvas_BitmapView *poView
+);
+
+
+
+/// <summary>
+/// Draw a region of an atlas onto a bitmap.
+/// </summary>
+/// <param name="poBase">The bitmap the region should be drawn onto.</param>
+/// <param name="atlas">The atlas.</param>
+/// <param name="iRegion">The index of the region.</param>
+/// <param name="iOverlayX">The x position of the region.</param>
+/// <param name="iOverlayY">The y position of the region.</param>
+/// <param name="iOverlayStrategy">One of the <c>RL_GAMECANVAS_BMP_OVERLAY_[...] values.</param>
+/// <returns>Was the region successfully drawn?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyAtlasRegionOverlay(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_UInt    iRegion,
+	rlGameCanvas_Int     iOverlayX,
+	rlGameCanvas_Int     iOverlayY,
+	rlGameCanvas_UInt    iOverlayStrategy
+);
+
+/// <summary>
+/// Draw a region of an atlas onto a bitmap with additional scaling.
+/// </summary>
+/// <param name="poBase">The bitmap the region should be drawn onto.</param>
+/// <param name="atlas">The atlas.</param>
+/// <param name="iRegion">The index of the region.</param>
+/// <param name="iOverlayX">The x position of the region.</param>
+/// <param name="iOverlayY">The y position of the region.</param>
+/// <param name="iOverlayScaledWidth">The width the region should be scaled to.</param>
+/// <param name="iOverlayScaledHeight">The height the region should be scaled to.</param>
+/// <param name="iOverlayStrategy">One of the <c>RL_GAMECANVAS_BMP_OVERLAY_[...] values.</param>
+/// <param name="iScalingStrategy">One of the <c>RL_GAMECANVAS_BMP_SCALE_[...] values.</param>
+/// <returns>Was the region successfully drawn?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyAtlasRegionOverlay_Scaled(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_UInt    iRegion,
+	rlGameCanvas_Int     iOverlayX,
+	rlGameCanvas_Int     iOverlayY,
+	rlGameCanvas_UInt    iOverlayScaledWidth,
+	rlGameCanvas_UInt    iOverlayScaledHeight,
+	rlGameCanvas_UInt    iOverlayStrategy,
+	rlGameCanvas_UInt    iScalingStrategy
+);
+
+
+
+
+
+#endif // RLGAMECANVAS_ATLAS_C
\ No newline at end of file
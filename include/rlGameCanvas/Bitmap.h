@@ -19,6 +19,75 @@
 
 
 
+/// <summary>
+/// Add a rectangle to a list of changed areas.<para />
+/// The Bitmap API functions don't know whether they draw onto a layer, so the changed area must be
+/// reported separately when using <c>RL_GAMECANVAS_SUP_DIRTY_RECTS</c>.
+/// </summary>
+/// <param name="poDirtyRects">The list of changed areas, usually from a layer.</param>
+/// <param name="pcoRect">The changed area.</param>
+/// <returns>Was the rectangle successfully added?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_AddDirtyRect(
+	rlGameCanvas_DirtyRects *poDirtyRects,
+	const rlGameCanvas_Rect *pcoRect
+);
+
+
+
+
+
+/*
+	A view of a rectangular area of pixels within a bigger buffer, e.g. a single frame of a sprite
+	sheet or a part of a layer.
+	The view doesn't own the pixels; drawing onto the view changes the underlying buffer.
+
+	ppxData
+		The top left pixel of the view.
+	size
+		The size of the view, in pixels.
+	iStride
+		The distance between the starts of two rows, in pixels.
+		Must be at least size.x.
+*/
+typedef struct
+{
+	rlGameCanvas_Pixel     *ppxData;
+	rlGameCanvas_Resolution size;
+	rlGameCanvas_UInt       iStride;
+} rlGameCanvas_BitmapView;
+
+
+
+/// <summary>
+/// Get a view of a whole bitmap.
+/// </summary>
+/// <param name="pcoBitmap">The bitmap.</param>
+/// <param name="poView">The view.</param>
+/// <returns>Was the view successfully created?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetBitmapView(
+	const rlGameCanvas_Bitmap *pcoBitmap,
+	rlGameCanvas_BitmapView   *poView
+);
+
+/// <summary>
+/// Get a view of a part of another view, without copying any pixels.<para />
+/// The rectangle is clipped to the view, so the sub view might be smaller than the rectangle or
+/// even empty.
+/// </summary>
+/// <param name="pcoView">The view to get a part of.</param>
+/// <param name="pcoRect">The part of the view, in coordinates of the view.</param>
+/// <param name="poSubView">The view of the part.</param>
+/// <returns>Was the view successfully created?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetBitmapSubView(
+	const rlGameCanvas_BitmapView *pcoView,
+	const rlGameCanvas_Rect       *pcoRect,
+	rlGameCanvas_BitmapView       *poSubView
+);
+
+
+
+
+
 /*
 	BMP = Bitmap
 
@@ -26,11 +95,33 @@
 		Replace the pixels of the base bitmap with the pixels of the overlay.
 		Fastest overlay strategy.
 	RL_GAMECANVAS_BMP_OVERLAY_BLEND
-		Mix the pixels of the bitmap and the pixels of the overlay, considering the alpha value.
+		Mix the pixels of the bitmap and the pixels of the overlay, considering the alpha values
+		("source over" compositing).
 		Slower overlay strategy.
+	RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED
+		Like RL_GAMECANVAS_BMP_OVERLAY_BLEND, but for bitmaps with premultiplied alpha.
+		Considerably faster than RL_GAMECANVAS_BMP_OVERLAY_BLEND.
+	RL_GAMECANVAS_BMP_OVERLAY_ADD
+		Add the colors of the overlay, weighted by their alpha values, to the colors of the base
+		bitmap (saturated). For glows and other light effects.
+	RL_GAMECANVAS_BMP_OVERLAY_MULTIPLY
+		Multiply the colors of the base bitmap with the colors of the overlay, which are mixed with
+		white by their alpha values. For shadows and other darkening effects.
+	RL_GAMECANVAS_BMP_OVERLAY_SCREEN
+		The inverse of RL_GAMECANVAS_BMP_OVERLAY_MULTIPLY: Multiply the inverted colors. Brightens
+		the base bitmap like RL_GAMECANVAS_BMP_OVERLAY_ADD, but without clipping to white as
+		quickly.
+
+	The alpha values of the base bitmap are kept by RL_GAMECANVAS_BMP_OVERLAY_ADD,
+	RL_GAMECANVAS_BMP_OVERLAY_MULTIPLY and RL_GAMECANVAS_BMP_OVERLAY_SCREEN. The overlay must have
+	straight alpha.
 */
-#define RL_GAMECANVAS_BMP_OVERLAY_REPLACE 1
-#define RL_GAMECANVAS_BMP_OVERLAY_BLEND   2
+#define RL_GAMECANVAS_BMP_OVERLAY_REPLACE             1
+#define RL_GAMECANVAS_BMP_OVERLAY_BLEND               2
+#define RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED 3
+#define RL_GAMECANVAS_BMP_OVERLAY_ADD                 4
+#define RL_GAMECANVAS_BMP_OVERLAY_MULTIPLY            5
+#define RL_GAMECANVAS_BMP_OVERLAY_SCREEN              6
 
 
 
@@ -51,6 +142,133 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 	rlGameCanvas_UInt          iOverlayStrategy
 );
 
+/// <summary>
+/// Apply a bitmap overlay onto another bitmap, both given as views.<para />
+/// This way, a single frame of a sprite sheet can be drawn onto a part of a layer without copying
+/// either of them first.
+/// </summary>
+/// <param name="pcoBase">
+/// The "bottom" view the overlay should be applied to. Its pixels are changed.
+/// </param>
+/// <param name="pcoOverlay">The "top" view that acts as an overlay.</param>
+/// <param name="iOverlayX">The x position of the overlay, relative to the base view.</param>
+/// <param name="iOverlayY">The y position of the overlay, relative to the base view.</param>
+/// <param name="iOverlayStrategy">One of the <c>RL_GAMECANVAS_BMP_OVERLAY_[...] values.</param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_UInt              iOverlayStrategy
+);
+
+/// <summary>
+/// Apply a bitmap overlay onto another bitmap in a single color.<para />
+/// The colors of the overlay are mixed with a constant color and the result is blended onto the
+/// base bitmap like with <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND</c>, e.g. to let a sprite flash.
+/// </summary>
+/// <param name="poBase">The "bottom" bitmap the overlay should be applied to.</param>
+/// <param name="poOverlay">
+/// The "top" bitmap that acts as an overlay. Must have straight alpha.
+/// </param>
+/// <param name="iOverlayX">The x position of the overlay.</param>
+/// <param name="iOverlayY">The y position of the overlay.</param>
+/// <param name="pxTint">
+/// The color to mix the overlay with.<para />
+/// Its alpha value is the weight of the color: 0 leaves the overlay unchanged, 255 replaces the
+/// color of every pixel of the overlay.
+/// </param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlay_Tinted(
+	rlGameCanvas_Bitmap       *poBase,
+	const rlGameCanvas_Bitmap *poOverlay,
+	rlGameCanvas_Int           iOverlayX,
+	rlGameCanvas_Int           iOverlayY,
+	rlGameCanvas_Pixel         pxTint
+);
+
+/// <summary>
+/// Apply a bitmap overlay onto another bitmap in a single color, both given as views.
+/// </summary>
+/// <param name="pcoBase">
+/// The "bottom" view the overlay should be applied to. Its pixels are changed.
+/// </param>
+/// <param name="pcoOverlay">
+/// The "top" view that acts as an overlay. Must have straight alpha.
+/// </param>
+/// <param name="iOverlayX">The x position of the overlay, relative to the base view.</param>
+/// <param name="iOverlayY">The y position of the overlay, relative to the base view.</param>
+/// <param name="pxTint">
+/// The color to mix the overlay with. See <c>rlGameCanvas_ApplyBitmapOverlay_Tinted</c>.
+/// </param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay_Tinted(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_Pixel             pxTint
+);
+
+
+
+
+
+/*
+	BMP = Bitmap
+
+	RL_GAMECANVAS_BMP_BATCH_MULTITHREADED
+		Distribute the work of rlGameCanvas_ApplyBitmapOverlayBatch across the shared pool of
+		threads set up via rlGameCanvas_SetBitmapParallelism.
+		Without the pool, or if the base bitmap has less pixels than the minimum pixel count given
+		there, the batch is drawn on the calling thread.
+*/
+#define RL_GAMECANVAS_BMP_BATCH_MULTITHREADED 0x00000001
+
+
+
+/*
+	A single overlay within a call to rlGameCanvas_ApplyBitmapOverlayBatch.
+
+	poOverlay
+		The "top" bitmap that acts as an overlay.
+	iX, iY
+		The position of the overlay.
+	iOverlayStrategy
+		One of the RL_GAMECANVAS_BMP_OVERLAY_[...] values.
+*/
+typedef struct
+{
+	const rlGameCanvas_Bitmap *poOverlay;
+	rlGameCanvas_Int           iX;
+	rlGameCanvas_Int           iY;
+	rlGameCanvas_UInt          iOverlayStrategy;
+} rlGameCanvas_BitmapOverlayBatchEntry;
+
+
+
+/// <summary>
+/// Apply multiple bitmap overlays onto another bitmap.<para />
+/// The result is the same as calling <c>rlGameCanvas_ApplyBitmapOverlay</c> for every entry, in
+/// the order given, but all entries are validated and clipped before anything is drawn and the
+/// base bitmap is processed in cache-friendly bands of rows.
+/// </summary>
+/// <param name="poBase">The "bottom" bitmap the overlays should be applied to.</param>
+/// <param name="pcoEntries">The overlays, in the order they should be applied in.</param>
+/// <param name="iEntryCount">The count of elements in <c>pcoEntries</c>.</param>
+/// <param name="iFlags">A combination of the <c>RL_GAMECANVAS_BMP_BATCH_[...]</c> values.</param>
+/// <returns>
+/// Were the overlays successfully applied?<para />
+/// If any of the entries is invalid, nothing is drawn.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlayBatch(
+	rlGameCanvas_Bitmap                        *poBase,
+	const rlGameCanvas_BitmapOverlayBatchEntry *pcoEntries,
+	rlGameCanvas_UInt                           iEntryCount,
+	rlGameCanvas_UInt                           iFlags
+);
+
 
 
 
@@ -93,6 +311,125 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 	rlGameCanvas_UInt          iScalingStrategy
 );
 
+/// <summary>
+/// Apply a bitmap overlay onto another bitmap with additional scaling, both given as views.
+/// </summary>
+/// <param name="pcoBase">
+/// The "bottom" view the overlay should be applied to. Its pixels are changed.
+/// </param>
+/// <param name="pcoOverlay">The "top" view that acts as an overlay.</param>
+/// <param name="iOverlayX">The x position of the overlay, relative to the base view.</param>
+/// <param name="iOverlayY">The y position of the overlay, relative to the base view.</param>
+/// <param name="iOverlayScaledWidth">The width the overlay should be scaled to.</param>
+/// <param name="iOverlayScaledHeight">The height the overlay should be scaled to.</param>
+/// <param name="iOverlayStrategy">One of the <c>RL_GAMECANVAS_BMP_OVERLAY_[...] values.</param>
+/// <param name="iScalingStrategy">One of the <c>RL_GAMECANVAS_BMP_SCALE_[...] values.</param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay_Scaled(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_UInt              iOverlayScaledWidth,
+	rlGameCanvas_UInt              iOverlayScaledHeight,
+	rlGameCanvas_UInt              iOverlayStrategy,
+	rlGameCanvas_UInt              iScalingStrategy
+);
+
+/// <summary>
+/// Split large calls of <c>rlGameCanvas_ApplyBitmapOverlay</c>,
+/// <c>rlGameCanvas_ApplyBitmapOverlay_Tinted</c>, <c>rlGameCanvas_ApplyBitmapOverlay_Scaled</c>,
+/// their view variants and batches with <c>RL_GAMECANVAS_BMP_BATCH_MULTITHREADED</c> into bands
+/// of rows that are drawn by a shared pool of threads.
+/// <para />
+/// The result is the same as when drawing on a single thread. By default, all drawing is done on
+/// the calling thread.<para />
+/// Calls from multiple threads at once are fine, but only one of them uses the pool at a time.
+/// </summary>
+/// <param name="iThreadCount">
+/// The count of threads to draw with, including the calling thread.<para />
+/// 0 = one per logical processor.<para />
+/// 1 = always draw on the calling thread and stop the pool's threads. Should be done before the
+/// library is unloaded.
+/// </param>
+/// <param name="iMinPixelCount">
+/// The count of pixels a call must change at least to be split.<para />
+/// Smaller calls are faster on a single thread, as waking up the threads takes some time.
+/// </param>
+/// <returns>Could the threads be started?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_SetBitmapParallelism(
+	rlGameCanvas_UInt iThreadCount,
+	rlGameCanvas_UInt iMinPixelCount
+);
+
+
+
+
+
+/// <summary>
+/// Apply an indexed bitmap overlay onto another indexed bitmap.<para />
+/// Both bitmaps are expected to use the same palette.
+/// </summary>
+/// <param name="poBase">The "bottom" bitmap the overlay should be applied to.</param>
+/// <param name="poOverlay">The "top" bitmap that acts as an overlay.</param>
+/// <param name="iOverlayX">The x position of the overlay.</param>
+/// <param name="iOverlayY">The y position of the overlay.</param>
+/// <param name="iOverlayStrategy">
+/// Either <c>RL_GAMECANVAS_BMP_OVERLAY_REPLACE</c> or
+/// <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND</c>.<para />
+/// When blending, index 0 is treated as transparent.
+/// </param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyIndexedBitmapOverlay(
+	rlGameCanvas_IndexedBitmap       *poBase,
+	const rlGameCanvas_IndexedBitmap *poOverlay,
+	rlGameCanvas_Int                  iOverlayX,
+	rlGameCanvas_Int                  iOverlayY,
+	rlGameCanvas_UInt                 iOverlayStrategy
+);
+
+/// <summary>
+/// Apply an indexed bitmap overlay onto an RGBA bitmap.
+/// </summary>
+/// <param name="poBase">The "bottom" bitmap the overlay should be applied to.</param>
+/// <param name="poOverlay">The "top" bitmap that acts as an overlay.</param>
+/// <param name="pcpxPalette">The 256 colors of the overlay.</param>
+/// <param name="iOverlayX">The x position of the overlay.</param>
+/// <param name="iOverlayY">The y position of the overlay.</param>
+/// <param name="iOverlayStrategy">One of the <c>RL_GAMECANVAS_BMP_OVERLAY_[...] values.</param>
+/// <returns>Was the overlay successfully applied?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyIndexedBitmapOverlayRGBA(
+	rlGameCanvas_Bitmap              *poBase,
+	const rlGameCanvas_IndexedBitmap *poOverlay,
+	const rlGameCanvas_Pixel         *pcpxPalette,
+	rlGameCanvas_Int                  iOverlayX,
+	rlGameCanvas_Int                  iOverlayY,
+	rlGameCanvas_UInt                 iOverlayStrategy
+);
+
+
+
+
+
+/// <summary>
+/// Convert a bitmap with straight alpha to premultiplied alpha.<para />
+/// The conversion loses precision for partially transparent pixels.
+/// </summary>
+/// <param name="poBitmap">The bitmap to convert.</param>
+/// <returns>Was the bitmap successfully converted?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_PremultiplyBitmap(
+	rlGameCanvas_Bitmap *poBitmap
+);
+
+/// <summary>
+/// Convert a bitmap with premultiplied alpha back to straight alpha.
+/// </summary>
+/// <param name="poBitmap">The bitmap to convert.</param>
+/// <returns>Was the bitmap successfully converted?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_UnpremultiplyBitmap(
+	rlGameCanvas_Bitmap *poBitmap
+);
+
 
 
 
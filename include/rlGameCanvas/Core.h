@@ -56,6 +56,18 @@ RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_Quit(
 	rlGameCanvas canvas
 );
 
+/// <summary>
+/// Get statistics about the texture uploads of a <c>rlGameCanvas</c> object.<para />
+/// Can be called from any thread.
+/// </summary>
+/// <param name="canvas">The canvas to get the statistics of.</param>
+/// <param name="pStatistics">Pointer to the variable that receives the statistics.</param>
+/// <returns>Could the statistics be retrieved?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetUploadStatistics(
+	rlGameCanvas                   canvas,
+	rlGameCanvas_UploadStatistics *pStatistics
+);
+
 
 
 
@@ -92,6 +92,26 @@
 		retaining the original aspect ratio.
 		If this flag is set, the screen will only be upscaled in multiples of the original size
 		(when possible).
+	RL_GAMECANVAS_SUP_PREMULTIPLIED_ALPHA
+		If this flag is set, the pixels of all layers are expected to use premultiplied alpha,
+		meaning the color channels are already multiplied by the alpha channel.
+		This is the cheapest form of blending, both for the GPU and for
+		RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED.
+		rlGameCanvas_PremultiplyBitmap can be used to convert existing bitmaps.
+	RL_GAMECANVAS_SUP_DIRTY_RECTS
+		If this flag is set, only the areas of the layers that were reported as changed via
+		rlGameCanvas_LayerData::poDirtyRects are redrawn.
+		If it's not set, all layers are redrawn completely on every frame.
+	RL_GAMECANVAS_SUP_SOFTWARE_COMPOSITING
+		If this flag is set, the visible layers are blended into a single image on the CPU, using
+		all available cores, and only that image is passed on to OpenGL.
+		Meant for machines without a GPU, where OpenGL is emulated in software and blending whole
+		layers is slow. The result looks the same as without this flag.
+	RL_GAMECANVAS_SUP_LARGE_PAGES
+		If this flag is set, the pixel memory of modes with big layers is allocated in large pages
+		(usually 2 MiB instead of 4 KiB), so passes over whole layers cause fewer TLB misses.
+		Requires the "Lock pages in memory" privilege; without it, normal pages are used.
+		Ignored if a custom allocator was set via rlGameCanvas_StartupConfig::fnAllocate.
 */
 #define RL_GAMECANVAS_SUP_MAXIMIZED             (0x00000001)
 #define RL_GAMECANVAS_SUP_FULLSCREEN            (0x00000002)
@@ -102,6 +122,10 @@
 //                                              (0x00000040) is reserved for future use.
 //                                              (0x00000080) is reserved for future use.
 #define RL_GAMECANVAS_SUP_PREFER_PIXELPERFECT   (0x00000100)
+#define RL_GAMECANVAS_SUP_PREMULTIPLIED_ALPHA   (0x00000200)
+#define RL_GAMECANVAS_SUP_DIRTY_RECTS           (0x00000400)
+#define RL_GAMECANVAS_SUP_SOFTWARE_COMPOSITING  (0x00000800)
+#define RL_GAMECANVAS_SUP_LARGE_PAGES           (0x00001000)
 
 
 
@@ -166,9 +190,63 @@
 		
 		This happens...
 		* at the very first call to the Draw callback.
-		* whenever a mode change occurs.
+		* whenever a mode change occurs, unless RL_GAMECANVAS_DRW_RESTOREDMODE is set instead.
+	RL_GAMECANVAS_DRW_RESTOREDMODE
+		If this flag is set, a mode switch occured, but the mode's layers were restored from the
+		cache (see iModeCacheSize of rlGameCanvas_StartupConfig).
+		This means that all layers contain exactly what they contained when the mode was left,
+		and that their screen positions and visibility are unchanged.
+		So only what changed in the meantime has to be redrawn.
 */
-#define RL_GAMECANVAS_DRW_NEWMODE (0x00000001)
+#define RL_GAMECANVAS_DRW_NEWMODE      (0x00000001)
+#define RL_GAMECANVAS_DRW_RESTOREDMODE (0x00000002)
+
+
+
+
+
+
+
+
+
+
+/*
+	LAY = Layer
+
+	RL_GAMECANVAS_LAY_FORMAT_RGBA
+		The layer consists of RGBA pixels.
+		Default.
+	RL_GAMECANVAS_LAY_FORMAT_INDEXED8
+		The layer consists of 8 bit indices into a palette of 256 colors.
+		The palette can be changed on every frame, the indices are converted to colors when the
+		layer is drawn to the screen.
+	RL_GAMECANVAS_LAY_FORMAT_TILEMAP
+		The layer consists of a grid of tile indices into a tileset.
+		Only the tiles that changed since the last frame are redrawn.
+
+	RL_GAMECANVAS_LAY_TILE_EMPTY
+		A tile index that is always transparent.
+
+	RL_GAMECANVAS_LAY_DETECT_CHANGES
+		RGBA layers only.
+		Keep a copy of the pixels on screen and compare it to the layer after every call of the draw
+		callback, so only the changed tiles are uploaded.
+		Meant for draw code that can't report the areas it changes. The dirty rectangles of the
+		layer are ignored.
+	RL_GAMECANVAS_LAY_ALIGNED_ROWS
+		RGBA layers only.
+		Pad the rows of the layer, so every row starts at a 64 byte boundary (a cache line).
+		Vectorized code can then use aligned loads and stores on every row.
+		The distance between two rows is given via rlGameCanvas_LayerData::iStride.
+*/
+#define RL_GAMECANVAS_LAY_FORMAT_RGBA     (0x00000000)
+#define RL_GAMECANVAS_LAY_FORMAT_INDEXED8 (0x00000001)
+#define RL_GAMECANVAS_LAY_FORMAT_TILEMAP  (0x00000002)
+
+#define RL_GAMECANVAS_LAY_TILE_EMPTY (0xFFFF)
+
+#define RL_GAMECANVAS_LAY_DETECT_CHANGES (0x00000001)
+#define RL_GAMECANVAS_LAY_ALIGNED_ROWS   (0x00000002)
 
 
 
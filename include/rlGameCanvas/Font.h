@@ -0,0 +1,157 @@
+/***************************************************************************************************
+  rlGameCanvas FONT API
+  =====================
+
+  This file contains function definitions for drawing text with bitmap fonts within the
+  rlGameCanvas library.
+
+  A font is created once from a bitmap containing the glyphs. Every glyph is compiled to a list of
+  visible pixel runs per row, so fully transparent pixels are skipped altogether.
+  The glyphs are multiplied with the color of the text, so white glyphs take on the text color.
+
+  Every font keeps the most recently drawn texts in a cache. Drawing a text that was already drawn
+  with the same color is as fast as drawing a compiled sprite.
+
+  (c) 2024 RobinLe
+***************************************************************************************************/
+#ifndef RLGAMECANVAS_FONT_C
+#define RLGAMECANVAS_FONT_C
+
+
+
+
+
+#include "ExportSpecs.h"
+#include "Types.h"
+
+
+
+typedef struct rlGameCanvas_FontOpaquePtrStruct
+{
+	int iUnused;
+} *rlGameCanvas_Font;
+
+
+
+/*
+	A single glyph of a font with glyphs of individual sizes.
+
+	iCodePoint
+		The Unicode code point the glyph stands for.
+	rect
+		The area of the font bitmap that contains the glyph.
+	iAdvance
+		The horizontal distance between the start of this glyph and the start of the next one, in
+		pixels.
+		Usually the width of rect, plus the spacing between two glyphs.
+*/
+typedef struct
+{
+	rlGameCanvas_UInt iCodePoint;
+	rlGameCanvas_Rect rect;
+	rlGameCanvas_UInt iAdvance;
+} rlGameCanvas_Glyph;
+
+
+
+/// <summary>
+/// Create a font with glyphs of a fixed size.<para />
+/// The glyphs are laid out in a grid from left to right, top to bottom. The first cell contains
+/// the glyph for <c>iFirstCodePoint</c>, every following cell the glyph for the next code point.
+/// <para />
+/// Incomplete cells on the right and bottom edges are ignored.
+/// </summary>
+/// <param name="poBitmap">
+/// The bitmap containing the glyphs. It's not referenced after the call.
+/// </param>
+/// <param name="poCellSize">The size of a single glyph, in pixels.</param>
+/// <param name="iFirstCodePoint">The Unicode code point of the first glyph.</param>
+/// <param name="iCacheSize">The maximum count of rendered texts to keep.</param>
+/// <returns>
+/// If the function succeeded, the return value is the handle of the newly created font.<para/>
+/// If the function failed, the return value is zero.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Font RLGAMECANVAS_LIB rlGameCanvas_CreateFixedFont(
+	const rlGameCanvas_Bitmap     *poBitmap,
+	const rlGameCanvas_Resolution *poCellSize,
+	rlGameCanvas_UInt              iFirstCodePoint,
+	rlGameCanvas_UInt              iCacheSize
+);
+
+/// <summary>
+/// Create a font with glyphs of individual sizes.
+/// </summary>
+/// <param name="poBitmap">
+/// The bitmap containing the glyphs. It's not referenced after the call.
+/// </param>
+/// <param name="pcoGlyphs">The glyphs.</param>
+/// <param name="iGlyphCount">The count of elements in <c>pcoGlyphs</c>.</param>
+/// <param name="iLineHeight">The vertical distance between two lines of text, in pixels.</param>
+/// <param name="iCacheSize">The maximum count of rendered texts to keep.</param>
+/// <returns>
+/// If the function succeeded, the return value is the handle of the newly created font.<para/>
+/// If the function failed, the return value is zero.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Font RLGAMECANVAS_LIB rlGameCanvas_CreateFont(
+	const rlGameCanvas_Bitmap *poBitmap,
+	const rlGameCanvas_Glyph  *pcoGlyphs,
+	rlGameCanvas_UInt          iGlyphCount,
+	rlGameCanvas_UInt          iLineHeight,
+	rlGameCanvas_UInt          iCacheSize
+);
+
+/// <summary>
+/// Destroy a font.
+/// </summary>
+/// <param name="font">The handle of the font to be destroyed.</param>
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroyFont(
+	rlGameCanvas_Font font
+);
+
+
+
+/// <summary>
+/// Get the size of a text, in pixels.
+/// </summary>
+/// <param name="font">The font.</param>
+/// <param name="szText">The UTF-8 text. Lines are separated by <c>'\n'</c>.</param>
+/// <param name="poSize">The size of the text.</param>
+/// <returns>Was the text successfully measured?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_MeasureText(
+	rlGameCanvas_Font          font,
+	const rlGameCanvas_U8Char *szText,
+	rlGameCanvas_Resolution   *poSize
+);
+
+/// <summary>
+/// Draw a text onto a bitmap.<para />
+/// Code points without a glyph are drawn as <c>'?'</c>, if the font has a glyph for it.
+/// </summary>
+/// <param name="poBase">The bitmap the text should be drawn onto.</param>
+/// <param name="font">The font.</param>
+/// <param name="szText">The UTF-8 text. Lines are separated by <c>'\n'</c>.</param>
+/// <param name="pxColor">The color the glyphs are multiplied with.</param>
+/// <param name="iX">The x position of the top left of the text.</param>
+/// <param name="iY">The y position of the top left of the text.</param>
+/// <param name="iOverlayStrategy">
+/// <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND</c> or <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED</c>.
+/// <para/>
+/// For <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED</c>, the font bitmap must have
+/// premultiplied alpha.
+/// </param>
+/// <returns>Was the text successfully drawn?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyTextOverlay(
+	rlGameCanvas_Bitmap       *poBase,
+	rlGameCanvas_Font          font,
+	const rlGameCanvas_U8Char *szText,
+	rlGameCanvas_Pixel         pxColor,
+	rlGameCanvas_Int           iX,
+	rlGameCanvas_Int           iY,
+	rlGameCanvas_UInt          iOverlayStrategy
+);
+
+
+
+
+
+#endif // RLGAMECANVAS_FONT_C
\ No newline at end of file
@@ -0,0 +1,81 @@
+/***************************************************************************************************
+  rlGameCanvas SPRITE API
+  =======================
+
+  This file contains function definitions for handling compiled sprites within the rlGameCanvas
+  library.
+
+  A compiled sprite is created once from a bitmap and stores every row as a list of opaque and
+  translucent pixel runs, skipping fully transparent pixels altogether.
+  This makes drawing sprites that are mostly transparent (like cursors or characters) a lot faster
+  than using rlGameCanvas_ApplyBitmapOverlay with RL_GAMECANVAS_BMP_OVERLAY_BLEND.
+
+  (c) 2024 RobinLe
+***************************************************************************************************/
+#ifndef RLGAMECANVAS_SPRITE_C
+#define RLGAMECANVAS_SPRITE_C
+
+
+
+
+
+#include "ExportSpecs.h"
+#include "Types.h"
+
+
+
+typedef struct rlGameCanvas_SpriteOpaquePtrStruct
+{
+	int iUnused;
+} *rlGameCanvas_Sprite;
+
+
+
+/// <summary>
+/// Compile a bitmap into a sprite.<para />
+/// Pixels with an alpha value of 0 are considered fully transparent and won't be drawn.
+/// </summary>
+/// <param name="poBitmap">The bitmap to compile. It's not referenced after the call.</param>
+/// <returns>
+/// If the function succeeded, the return value is the handle of the newly created sprite.<para/>
+/// If the function failed, the return value is zero.
+/// </returns>
+RLGAMECANVAS_API rlGameCanvas_Sprite RLGAMECANVAS_LIB rlGameCanvas_CreateSprite(
+	const rlGameCanvas_Bitmap *poBitmap
+);
+
+/// <summary>
+/// Destroy a compiled sprite.
+/// </summary>
+/// <param name="sprite">The handle of the sprite to be destroyed.</param>
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroySprite(
+	rlGameCanvas_Sprite sprite
+);
+
+/// <summary>
+/// Draw a compiled sprite onto a bitmap.
+/// </summary>
+/// <param name="poBase">The bitmap the sprite should be drawn onto.</param>
+/// <param name="sprite">The sprite to draw.</param>
+/// <param name="iSpriteX">The x position of the sprite.</param>
+/// <param name="iSpriteY">The y position of the sprite.</param>
+/// <param name="iOverlayStrategy">
+/// <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND</c> or <c>RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED</c>.
+/// <para/>
+/// <c>RL_GAMECANVAS_BMP_OVERLAY_REPLACE</c> is not supported, as the transparent pixels are not
+/// stored in the sprite.
+/// </param>
+/// <returns>Was the sprite successfully drawn?</returns>
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplySpriteOverlay(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Sprite  sprite,
+	rlGameCanvas_Int     iSpriteX,
+	rlGameCanvas_Int     iSpriteY,
+	rlGameCanvas_UInt    iOverlayStrategy
+);
+
+
+
+
+
+#endif // RLGAMECANVAS_SPRITE_C
\ No newline at end of file
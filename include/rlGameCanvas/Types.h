@@ -21,6 +21,7 @@ typedef struct IUnknown IUnknown;
 #undef WIN32_LEAN_AND_MEAN
 #undef NOMINMAX
 
+#include <stddef.h>
 #include <stdint.h>
 
 
@@ -68,6 +69,94 @@ typedef struct
 
 
 
+/*
+	A rectangular area, in pixels.
+	iRight and iBottom are exclusive.
+*/
+typedef struct
+{
+	rlGameCanvas_UInt iLeft;
+	rlGameCanvas_UInt iTop;
+	rlGameCanvas_UInt iRight;
+	rlGameCanvas_UInt iBottom;
+} rlGameCanvas_Rect;
+
+/*
+	A list of the areas of a layer that were changed in the current frame.
+	Should only be modified via rlGameCanvas_AddDirtyRect.
+
+	poRects
+		Storage for up to iCapacity rectangles.
+	iCapacity
+		The maximum number of rectangles.
+	iCount
+		The number of rectangles in poRects.
+	bAll
+		Was the whole layer changed?
+		Is also set when more than iCapacity rectangles are added.
+*/
+typedef struct
+{
+	rlGameCanvas_Rect *poRects;
+	rlGameCanvas_UInt  iCapacity;
+	rlGameCanvas_UInt  iCount;
+	rlGameCanvas_Bool  bAll;
+} rlGameCanvas_DirtyRects;
+
+/*
+	A bitmap of 8 bit palette indices.
+	The actual colors are defined by a separate palette of 256 pixels.
+*/
+typedef struct
+{
+	uint8_t *piData;
+	rlGameCanvas_Resolution size;
+} rlGameCanvas_IndexedBitmap;
+
+
+
+typedef uint16_t rlGameCanvas_TileIndex;
+
+/*
+	A grid of tiles.
+
+	piTiles
+		The tile indices, row by row.
+		Indices outside of the tileset (like RL_GAMECANVAS_LAY_TILE_EMPTY) are transparent.
+	size
+		The size of the map, in tiles.
+*/
+typedef struct
+{
+	rlGameCanvas_TileIndex *piTiles;
+	rlGameCanvas_Resolution size;
+} rlGameCanvas_Tilemap;
+
+
+
+/*
+	Statistics about the texture uploads of a canvas, summed up since the canvas was created.
+
+	iUploadedPixels
+		The count of pixels uploaded to the graphics card.
+	iSkippedPixels
+		The count of pixels of layers with RL_GAMECANVAS_LAY_DETECT_CHANGES that weren't uploaded
+		because they didn't change.
+	iComparedTiles
+		The count of tiles compared by the change detection.
+	iChangedTiles
+		The count of compared tiles that contained changes.
+*/
+typedef struct
+{
+	uint64_t iUploadedPixels;
+	uint64_t iSkippedPixels;
+	uint64_t iComparedTiles;
+	uint64_t iChangedTiles;
+} rlGameCanvas_UploadStatistics;
+
+
+
 typedef struct rlGameCanvas_OpaquePtrStruct
 {
 	int iUnused;
@@ -81,6 +170,20 @@ typedef void (__stdcall *rlGameCanvas_CopyStateCallback)(const void *pcvSrc, voi
 
 
 
+/*
+	A custom allocator for the pixel memory of the layers.
+
+	rlGameCanvas_AllocateCallback
+		Must return a block of at least iSize bytes, aligned to iAlignment bytes (a power of 2).
+		Returns NULL on failure. The memory doesn't need to be initialized.
+	rlGameCanvas_FreeCallback
+		Releases a block returned by the allocate callback.
+*/
+typedef void *(__stdcall *rlGameCanvas_AllocateCallback)(size_t iSize, size_t iAlignment);
+typedef void  (__stdcall *rlGameCanvas_FreeCallback)(void *pvData);
+
+
+
 /*
 	The current "logical" graphics configuration.
 	Can be changed via the game settings, no manual resizing by the user.
@@ -125,14 +228,39 @@ typedef struct
 	oScreenPos
 		The coordinate of the top- and leftmost pixel visible on screen.
 		The layer contents are repeated if out-of-bounds pixels would be visible.
+		Positions beyond the layer size wrap around, i.e. they're taken modulo the layer size.
+		Behavior change: When the layers were drawn one by one (drivers without shader support or
+		modes with too many layers for the single-pass compositor), earlier versions took the
+		position modulo the screen size and scrolled vertically in the opposite direction, so
+		(0,0) showed the bottom rows of a layer that is higher than the screen. All rendering paths
+		now show the same image, as described above.
 	bVisible
 		Should the layer be rendered to the screen?
+	iFormat
+		The pixel format of the layer.
+		One of the RL_GAMECANVAS_LAY_FORMAT_[...] values.
+		Defaults to RGBA if the struct is zero-initialized.
+	oTileSize
+		Tilemap layers only.
+		The size, in pixels, of a single tile.
+		The layer size must be a multiple of the tile size.
+	pcoTileset
+		Tilemap layers only.
+		A bitmap containing the tiles, from left to right, top to bottom.
+		Must contain at least one tile. Incomplete tiles on the right and bottom edges are ignored.
+		The bitmap is copied when the canvas is created.
+	iFlags
+		A combination of the RL_GAMECANVAS_LAY_[...] flags.
 */
 typedef struct
 {
-	rlGameCanvas_Resolution oLayerSize;
-	rlGameCanvas_Resolution oScreenPos;
-	rlGameCanvas_Bool       bHide;
+	rlGameCanvas_Resolution    oLayerSize;
+	rlGameCanvas_Resolution    oScreenPos;
+	rlGameCanvas_Bool          bHide;
+	rlGameCanvas_UInt          iFormat;
+	rlGameCanvas_Resolution    oTileSize;
+	const rlGameCanvas_Bitmap *pcoTileset;
+	rlGameCanvas_UInt          iFlags;
 } rlGameCanvas_LayerMetadata;
 
 /*
@@ -141,17 +269,56 @@ typedef struct
 	bmp
 		The layer bitmap.
 		Changes to the size member variable will be ignored.
+		ppxData is NULL for all layers that aren't RGBA layers.
+		ppxData may point to a different location on every frame, don't store it.
+		The rows are iStride pixels apart.
 	poScreenPos
 		The top-left position of the "camera".
+		Wraps around at the layer size, see rlGameCanvas_LayerMetadata::oScreenPos.
 	pbVisible
 		Should the layer be rendered to the screen?
+	bmpIndexed
+		The palette indices of an indexed layer.
+		Changes to the size member variable will be ignored.
+		piData is NULL for all layers that aren't indexed layers.
+	ppxPalette
+		The 256 colors of an indexed layer.
+		Can be changed every frame, the indices are only resolved when the layer is drawn to the
+		screen.
+		NULL for all layers that aren't indexed layers.
+	tilemap
+		The tiles of a tilemap layer.
+		Only the tiles that changed since the last frame are redrawn.
+		Changes to the size member variable will be ignored.
+		piTiles is NULL for all layers that aren't tilemap layers.
+	poDirtyRects
+		The areas of bmp/bmpIndexed that were changed in this frame.
+		Only used if RL_GAMECANVAS_SUP_DIRTY_RECTS was set on startup, otherwise the whole layer
+		is redrawn on every frame.
+		Changing the palette of an indexed layer changes the whole layer.
+		Ignored for tilemap layers and layers with RL_GAMECANVAS_LAY_DETECT_CHANGES, as they keep
+		track of their changes on their own.
+	iStride
+		The distance between the starts of two rows of bmp, in pixels.
+		Equal to bmp.size.x unless the layer was created with RL_GAMECANVAS_LAY_ALIGNED_ROWS.
+		Together with bmp, it describes a rlGameCanvas_BitmapView of the whole layer, so overlays
+		can be drawn onto parts of the layer directly.
 */
 typedef struct
 {
-	rlGameCanvas_Bitmap bmp;
+	rlGameCanvas_Bitmap        bmp;
 
 	rlGameCanvas_Resolution   *poScreenPos;
 	rlGameCanvas_Bool         *pbVisible;
+
+	rlGameCanvas_IndexedBitmap bmpIndexed;
+	rlGameCanvas_Pixel        *ppxPalette;
+
+	rlGameCanvas_Tilemap       tilemap;
+
+	rlGameCanvas_DirtyRects   *poDirtyRects;
+
+	rlGameCanvas_UInt          iStride;
 } rlGameCanvas_LayerData;
 
 
@@ -329,6 +496,18 @@ typedef void (__stdcall *rlGameCanvas_MsgCallback)(
 		Size of the array pointed to by poModes.
 	pcoModes
 		Pointer to an array of mode definitions.
+	iModeCacheSize
+		The maximum memory, in bytes, that may be used to keep the graphics data of previously
+		active modes, so switching back to them is instant (see RL_GAMECANVAS_DRW_RESTOREDMODE).
+		The least recently left modes are dropped first.
+		0 = the graphics data is always recreated on a mode switch.
+	fnAllocate
+		Callback function that allocates the pixel memory of the layers of a mode.
+		Can be NULL, in which case the memory is allocated by the library.
+		Must be set if fnFree is set.
+	fnFree
+		Callback function that releases memory allocated via fnAllocate.
+		Can be NULL. Must be set if fnAllocate is set.
 */
 typedef struct
 {
@@ -345,6 +524,9 @@ typedef struct
 	rlGameCanvas_UInt                 iFlags;
 	rlGameCanvas_UInt                 iModeCount;
 	const rlGameCanvas_Mode          *pcoModes;
+	uint64_t                          iModeCacheSize;
+	rlGameCanvas_AllocateCallback     fnAllocate;
+	rlGameCanvas_FreeCallback         fnFree;
 } rlGameCanvas_StartupConfig;
 
 
@@ -0,0 +1,148 @@
+#include "private/Arena.hpp"
+
+#include <Windows.h>
+
+#include <cstring> // memset
+#include <new>
+#include <utility> // std::exchange, std::swap
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		// Arenas of at least this size are allocated as whole pages, which the system hands out
+		// already zeroed.
+		constexpr size_t iMinPagesSize = 1024 * 1024;
+
+		// Try to enable the privilege to allocate large pages for this process.
+		// Returns the size of a large page, 0 if they can't be used.
+		size_t EnableLargePages()
+		{
+			HANDLE hToken = NULL;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY,
+				&hToken))
+				return 0;
+
+			TOKEN_PRIVILEGES tp = {};
+			tp.PrivilegeCount           = 1;
+			tp.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+
+			bool bEnabled =
+				LookupPrivilegeValueW(NULL, SE_LOCK_MEMORY_NAME, &tp.Privileges[0].Luid) &&
+				AdjustTokenPrivileges(hToken, FALSE, &tp, 0, NULL, NULL) &&
+				GetLastError() != ERROR_NOT_ALL_ASSIGNED; // the user lacks the privilege
+			CloseHandle(hToken);
+
+			return bEnabled ? GetLargePageMinimum() : 0;
+		}
+
+		size_t LargePageSize()
+		{
+			static const size_t iSize = EnableLargePages();
+			return iSize;
+		}
+
+	}
+
+
+
+	Arena::Arena(Arena &&other) noexcept :
+		m_pData     (std::exchange(other.m_pData, nullptr)),
+		m_iSize     (std::exchange(other.m_iSize, 0)),
+		m_eSource   (std::exchange(other.m_eSource, Source::None)),
+		m_oAllocator(other.m_oAllocator)
+	{ }
+
+	Arena &Arena::operator=(Arena &&other) noexcept
+	{
+		if (this != &other)
+		{
+			deallocate();
+			std::swap(m_pData,      other.m_pData);
+			std::swap(m_iSize,      other.m_iSize);
+			std::swap(m_eSource,    other.m_eSource);
+			std::swap(m_oAllocator, other.m_oAllocator);
+		}
+		return *this;
+	}
+
+	void Arena::allocate(size_t iSize, const ArenaAllocator &oAllocator)
+	{
+		deallocate();
+		if (iSize == 0)
+			return;
+
+		iSize        = AlignSize(iSize);
+		m_oAllocator = oAllocator;
+
+		if (oAllocator.fnAllocate)
+		{
+			m_pData = static_cast<uint8_t *>(oAllocator.fnAllocate(iSize, iAlignment));
+			if (m_pData == nullptr)
+				throw std::bad_alloc();
+
+			memset(m_pData, 0, iSize);
+			m_eSource = Source::Custom;
+		}
+		else
+		{
+			const size_t iLargePageSize = oAllocator.bLargePages ? LargePageSize() : 0;
+			if (iLargePageSize > 0 && iSize >= iLargePageSize)
+			{
+				iSize = (iSize + iLargePageSize - 1) / iLargePageSize * iLargePageSize;
+				m_pData = static_cast<uint8_t *>(VirtualAlloc(NULL, iSize,
+					MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+				if (m_pData)
+					m_eSource = Source::LargePages;
+				// else: not enough contiguous physical memory --> normal pages
+			}
+
+			if (m_pData == nullptr && iSize >= iMinPagesSize)
+			{
+				m_pData = static_cast<uint8_t *>(VirtualAlloc(NULL, iSize,
+					MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+				if (m_pData == nullptr)
+					throw std::bad_alloc();
+				m_eSource = Source::Pages;
+			}
+
+			if (m_pData == nullptr)
+			{
+				m_pData = static_cast<uint8_t *>(
+					::operator new[](iSize, std::align_val_t(iAlignment)));
+				memset(m_pData, 0, iSize);
+				m_eSource = Source::Heap;
+			}
+		}
+
+		m_iSize = iSize;
+	}
+
+	void Arena::deallocate()
+	{
+		switch (m_eSource)
+		{
+		case Source::Heap:
+			::operator delete[](m_pData, std::align_val_t(iAlignment));
+			break;
+		case Source::Pages:
+		case Source::LargePages:
+			VirtualFree(m_pData, 0, MEM_RELEASE);
+			break;
+		case Source::Custom:
+			m_oAllocator.fnFree(m_pData);
+			break;
+		case Source::None:
+			break;
+		}
+
+		m_pData   = nullptr;
+		m_iSize   = 0;
+		m_eSource = Source::None;
+	}
+
+}
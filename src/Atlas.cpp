@@ -0,0 +1,428 @@
+#include <rlGameCanvas++/Atlas.hpp>
+
+#include <algorithm> // std::sort, std::min, std::max
+#include <cmath>     // std::sqrt, std::ceil
+#include <cstring>   // memcpy_s, memcmp
+#include <utility>   // std::move
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		// Packs rectangles into a bin of a fixed width and unlimited height via the "skyline
+		// bottom-left" heuristic.
+		// The used part of the bin is described by its outline (the "skyline"), a list of
+		// horizontal segments from left to right. Every rectangle is put onto the skyline where its
+		// bottom edge ends up the highest up, preferring the leftmost position.
+		// Inserting the rectangles sorted by descending height gives a tight packing.
+		class SkylinePacker final
+		{
+		public: // methods
+
+			SkylinePacker(UInt iBinWidth) : m_iBinWidth(iBinWidth)
+			{
+				m_oSegments.push_back({ 0, 0, iBinWidth });
+			}
+
+			// Find a place for a rectangle and mark it as used.
+			// Returns false if the rectangle doesn't fit.
+			bool insert(UInt iWidth, UInt iHeight, UInt &iX, UInt &iY)
+			{
+				if (iWidth == 0 || iWidth > m_iBinWidth)
+					return false;
+
+				constexpr size_t iNone = ~size_t(0);
+				size_t   iBest       = iNone;
+				UInt     iBestTop    = 0;
+				uint64_t iBestBottom = ~uint64_t(0);
+				for (size_t i = 0; i < m_oSegments.size(); ++i)
+				{
+					if (iWidth > m_iBinWidth - m_oSegments[i].iX)
+						break; // the segments are sorted --> no room on any of the following ones
+
+					// the rectangle rests on the lowest point of all the segments below it
+					UInt iTop     = 0;
+					UInt iCovered = 0;
+					for (size_t j = i; iCovered < iWidth; ++j)
+					{
+						iTop      = std::max(iTop, m_oSegments[j].iY);
+						iCovered += m_oSegments[j].iWidth;
+					}
+
+					const uint64_t iBottom = (uint64_t)iTop + iHeight;
+					if (iBottom < iBestBottom)
+					{
+						iBest       = i;
+						iBestTop    = iTop;
+						iBestBottom = iBottom;
+					}
+				}
+				if (iBest == iNone || iBestBottom > ~UInt(0))
+					return false;
+
+				iX = m_oSegments[iBest].iX;
+				iY = iBestTop;
+
+
+				// replace the covered part of the skyline with the bottom edge of the rectangle
+				const UInt iRight = iX + iWidth;
+				size_t iEnd = iBest;
+				while (iEnd < m_oSegments.size() &&
+					m_oSegments[iEnd].iX + m_oSegments[iEnd].iWidth <= iRight)
+				{
+					++iEnd;
+				}
+				if (iEnd < m_oSegments.size() && m_oSegments[iEnd].iX < iRight)
+				{
+					auto &seg = m_oSegments[iEnd];
+					seg.iWidth -= iRight - seg.iX;
+					seg.iX      = iRight;
+				}
+				m_oSegments.erase(m_oSegments.begin() + iBest, m_oSegments.begin() + iEnd);
+				m_oSegments.insert(m_oSegments.begin() + iBest, { iX, UInt(iBestBottom), iWidth });
+
+				// merge with the neighbors at the same height, keeping the skyline short
+				if (iBest + 1 < m_oSegments.size() &&
+					m_oSegments[iBest + 1].iY == m_oSegments[iBest].iY)
+				{
+					m_oSegments[iBest].iWidth += m_oSegments[iBest + 1].iWidth;
+					m_oSegments.erase(m_oSegments.begin() + iBest + 1);
+				}
+				if (iBest > 0 && m_oSegments[iBest - 1].iY == m_oSegments[iBest].iY)
+				{
+					m_oSegments[iBest - 1].iWidth += m_oSegments[iBest].iWidth;
+					m_oSegments.erase(m_oSegments.begin() + iBest);
+				}
+
+				return true;
+			}
+
+
+		private: // types
+
+			struct Segment
+			{
+				UInt iX;
+				UInt iY;     // top of the free space above the segment
+				UInt iWidth;
+			};
+
+
+		private: // variables
+
+			const UInt           m_iBinWidth;
+			std::vector<Segment> m_oSegments;
+
+		};
+
+
+
+		// Layout of the saved data (little endian, like all supported platforms):
+		//   SaveHeader
+		//   Rect[iRegionCount]
+		//   PixelInt[iWidth * iHeight]
+		struct SaveHeader
+		{
+			char     szMagic[4];
+			uint32_t iVersion;
+			uint32_t iWidth;
+			uint32_t iHeight;
+			uint32_t iRegionCount;
+		};
+
+		constexpr char     szSaveMagic[4] = { 'R', 'L', 'G', 'A' };
+		constexpr uint32_t iSaveVersion   = 1;
+
+		// returned by atlases that were moved from
+		const Bitmap bmpEmpty  = {};
+		const Rect   rectEmpty = {};
+
+	}
+
+
+
+	class Atlas::PIMPL final
+	{
+	public: // methods
+
+		PIMPL(const Bitmap *pcoBitmaps, UInt iBitmapCount, UInt iMaxWidth, UInt iPadding)
+		{
+			if (pcoBitmaps == nullptr && iBitmapCount > 0)
+				return;
+
+			// the regions are packed with the padding on their right and bottom edges
+			constexpr uint64_t iMaxSize = ~UInt(0);
+			uint64_t iArea   = 0;
+			UInt     iWidest = 0;
+			std::vector<UInt> oOrder;
+			oOrder.reserve(iBitmapCount);
+			for (UInt i = 0; i < iBitmapCount; ++i)
+			{
+				const auto &bmp = pcoBitmaps[i];
+				if (bmp.size.x == 0 || bmp.size.y == 0)
+					continue; // empty regions take up no space at all
+				if (bmp.ppxData == nullptr ||
+					(uint64_t)bmp.size.x + iPadding > iMaxSize ||
+					(uint64_t)bmp.size.y + iPadding > iMaxSize)
+					return;
+
+				iWidest = std::max(iWidest, bmp.size.x);
+				iArea  += ((uint64_t)bmp.size.x + iPadding) * ((uint64_t)bmp.size.y + iPadding);
+				oOrder.push_back(i);
+			}
+
+			UInt iBinWidth;
+			if (iMaxWidth == 0)
+				iBinWidth = (UInt)std::min<uint64_t>(iMaxSize, std::max<uint64_t>(
+					(uint64_t)iWidest + iPadding, (uint64_t)std::ceil(std::sqrt((double)iArea))));
+			else if (iWidest > iMaxWidth || (uint64_t)iMaxWidth + iPadding > iMaxSize)
+				return;
+			else
+				iBinWidth = iMaxWidth + iPadding;
+
+			// tallest first, ties broken by width, then by index to stay deterministic
+			std::sort(oOrder.begin(), oOrder.end(), [&](UInt a, UInt b)
+				{
+					const auto &sizeA = pcoBitmaps[a].size;
+					const auto &sizeB = pcoBitmaps[b].size;
+					if (sizeA.y != sizeB.y)
+						return sizeA.y > sizeB.y;
+					if (sizeA.x != sizeB.x)
+						return sizeA.x > sizeB.x;
+					return a < b;
+				}
+			);
+
+			std::vector<Rect> oRegions(iBitmapCount, Rect{});
+			SkylinePacker oPacker(iBinWidth);
+			Resolution oSheetSize = {};
+			for (const UInt i : oOrder)
+			{
+				const auto &size = pcoBitmaps[i].size;
+
+				UInt iX, iY;
+				if (!oPacker.insert(size.x + iPadding, size.y + iPadding, iX, iY))
+					return;
+
+				oRegions[i] = { iX, iY, iX + size.x, iY + size.y };
+				oSheetSize.x = std::max(oSheetSize.x, iX + size.x);
+				oSheetSize.y = std::max(oSheetSize.y, iY + size.y);
+			}
+
+			// the padding stays transparent
+			m_oPixels.resize((size_t)oSheetSize.x * oSheetSize.y, 0);
+			for (const UInt i : oOrder)
+			{
+				const auto &bmp  = pcoBitmaps[i];
+				const auto &rect = oRegions[i];
+
+				const PixelInt *pSrc  = bmp.ppxData;
+				PixelInt       *pDest =
+					m_oPixels.data() + ((size_t)rect.iTop * oSheetSize.x + rect.iLeft);
+				const size_t iRowSize = bmp.size.x * sizeof(PixelInt);
+				for (UInt iY = 0; iY < bmp.size.y; ++iY, pSrc += bmp.size.x, pDest += oSheetSize.x)
+				{
+					memcpy_s(pDest, iRowSize, pSrc, iRowSize);
+				}
+			}
+
+			m_oRegions = std::move(oRegions);
+			m_bmp      = { m_oPixels.data(), oSheetSize };
+			m_bValid   = true;
+		}
+
+		PIMPL(const void *pData, size_t iSize)
+		{
+			SaveHeader oHeader;
+			if (pData == nullptr || iSize < sizeof(oHeader))
+				return;
+			memcpy_s(&oHeader, sizeof(oHeader), pData, sizeof(oHeader));
+
+			if (memcmp(oHeader.szMagic, szSaveMagic, sizeof(szSaveMagic)) != 0 ||
+				oHeader.iVersion != iSaveVersion)
+				return;
+
+			const uint64_t iPixelCount = (uint64_t)oHeader.iWidth * oHeader.iHeight;
+			if (iPixelCount > iSize / sizeof(PixelInt))
+				return;
+			const uint64_t iRegionsSize = (uint64_t)oHeader.iRegionCount * sizeof(Rect);
+			const uint64_t iPixelsSize  = iPixelCount * sizeof(PixelInt);
+			if (iSize - sizeof(oHeader) != iRegionsSize + iPixelsSize)
+				return;
+
+			const uint8_t *pRegions = static_cast<const uint8_t *>(pData) + sizeof(oHeader);
+			m_oRegions.resize(oHeader.iRegionCount);
+			memcpy_s(m_oRegions.data(), m_oRegions.size() * sizeof(Rect),
+				pRegions, (size_t)iRegionsSize);
+			for (const auto &rect : m_oRegions)
+			{
+				if (rect.iLeft > rect.iRight  || rect.iRight  > oHeader.iWidth ||
+					rect.iTop  > rect.iBottom || rect.iBottom > oHeader.iHeight)
+				{
+					m_oRegions.clear();
+					return;
+				}
+			}
+
+			m_oPixels.resize((size_t)oHeader.iWidth * oHeader.iHeight);
+			memcpy_s(m_oPixels.data(), m_oPixels.size() * sizeof(PixelInt),
+				pRegions + iRegionsSize, (size_t)iPixelsSize);
+
+			m_bmp    = { m_oPixels.data(), { oHeader.iWidth, oHeader.iHeight } };
+			m_bValid = true;
+		}
+
+		bool valid() const { return m_bValid; }
+
+		const Bitmap &bitmap() const { return m_bmp; }
+
+		UInt regionCount() const { return UInt(m_oRegions.size()); }
+		const Rect &region(UInt iRegion) const { return m_oRegions[iRegion]; }
+
+		size_t saveSize() const
+		{
+			return sizeof(SaveHeader) + m_oRegions.size() * sizeof(Rect) +
+				m_oPixels.size() * sizeof(PixelInt);
+		}
+
+		// iDestSize must be at least saveSize().
+		void save(uint8_t *pDest, size_t iDestSize) const
+		{
+			SaveHeader oHeader = {};
+			memcpy_s(oHeader.szMagic, sizeof(oHeader.szMagic), szSaveMagic, sizeof(szSaveMagic));
+			oHeader.iVersion     = iSaveVersion;
+			oHeader.iWidth       = m_bmp.size.x;
+			oHeader.iHeight      = m_bmp.size.y;
+			oHeader.iRegionCount = regionCount();
+
+			const size_t iRegionsSize = m_oRegions.size() * sizeof(Rect);
+			const size_t iPixelsSize  = m_oPixels.size()  * sizeof(PixelInt);
+
+			memcpy_s(pDest, iDestSize, &oHeader, sizeof(oHeader));
+			pDest     += sizeof(oHeader);
+			iDestSize -= sizeof(oHeader);
+			memcpy_s(pDest, iDestSize, m_oRegions.data(), iRegionsSize);
+			pDest     += iRegionsSize;
+			iDestSize -= iRegionsSize;
+			memcpy_s(pDest, iDestSize, m_oPixels.data(), iPixelsSize);
+		}
+
+
+	private: // variables
+
+		bool                  m_bValid = false;
+		Bitmap                m_bmp    = {};
+		std::vector<Rect>     m_oRegions;
+		std::vector<PixelInt> m_oPixels;
+
+	};
+
+
+
+	Atlas::Atlas(const Bitmap *pcoBitmaps, UInt iBitmapCount, UInt iMaxWidth, UInt iPadding) :
+		m_pPIMPL(new PIMPL(pcoBitmaps, iBitmapCount, iMaxWidth, iPadding))
+	{}
+
+	Atlas::Atlas(const void *pData, size_t iSize) : m_pPIMPL(new PIMPL(pData, iSize)) {}
+
+	Atlas::Atlas(Atlas &&rval) noexcept : m_pPIMPL(rval.m_pPIMPL)
+	{
+		rval.m_pPIMPL = nullptr;
+	}
+
+	Atlas::~Atlas() { delete m_pPIMPL; }
+
+	Atlas &Atlas::operator=(Atlas &&rval) noexcept
+	{
+		if (&rval == this)
+			return *this;
+
+		delete m_pPIMPL;
+		m_pPIMPL      = rval.m_pPIMPL;
+		rval.m_pPIMPL = nullptr;
+
+		return *this;
+	}
+
+	bool Atlas::valid() const { return m_pPIMPL != nullptr && m_pPIMPL->valid(); }
+
+	const Bitmap &Atlas::bitmap() const
+	{
+		if (m_pPIMPL == nullptr)
+			return bmpEmpty;
+
+		return m_pPIMPL->bitmap();
+	}
+
+	UInt Atlas::regionCount() const { return m_pPIMPL ? m_pPIMPL->regionCount() : 0; }
+
+	const Rect &Atlas::region(UInt iRegion) const
+	{
+		if (m_pPIMPL == nullptr || iRegion >= m_pPIMPL->regionCount())
+			return rectEmpty;
+
+		return m_pPIMPL->region(iRegion);
+	}
+
+	BitmapView Atlas::regionView(UInt iRegion) const
+	{
+		return GetBitmapSubView(GetBitmapView(bitmap()), region(iRegion));
+	}
+
+	size_t Atlas::saveSize() const { return valid() ? m_pPIMPL->saveSize() : 0; }
+
+	bool Atlas::save(void *pBuffer, size_t iBufferSize) const
+	{
+		if (!valid() || pBuffer == nullptr || iBufferSize < m_pPIMPL->saveSize())
+			return false;
+
+		m_pPIMPL->save(static_cast<uint8_t *>(pBuffer), iBufferSize);
+		return true;
+	}
+
+
+
+	bool ApplyAtlasRegionOverlay(
+		Bitmap               *poBase,
+		const Atlas          &oAtlas,
+		UInt                  iRegion,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || !oAtlas.valid() || iRegion >= oAtlas.regionCount())
+			return false;
+
+		return ApplyBitmapOverlay(GetBitmapView(*poBase), oAtlas.regionView(iRegion),
+			iOverlayX, iOverlayY, eOverlayStrategy, poDirtyRects);
+	}
+
+	bool ApplyAtlasRegionOverlay_Scaled(
+		Bitmap               *poBase,
+		const Atlas          &oAtlas,
+		UInt                  iRegion,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		UInt                  iOverlayScaledWidth,
+		UInt                  iOverlayScaledHeight,
+		BitmapOverlayStrategy eOverlayStrategy,
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || !oAtlas.valid() || iRegion >= oAtlas.regionCount())
+			return false;
+
+		return ApplyBitmapOverlay_Scaled(GetBitmapView(*poBase), oAtlas.regionView(iRegion),
+			iOverlayX, iOverlayY, iOverlayScaledWidth, iOverlayScaledHeight,
+			eOverlayStrategy, eScalingStrategy, poDirtyRects);
+	}
+
+}
@@ -1,9 +1,14 @@
-#include <rlGameCanvas++/Bitmap.hpp>
-#include "private/PrivateTypes.hpp" // Rect
-
-#include <algorithm> // std::min
-#include <cmath>     // std::round
+﻿#include <rlGameCanvas++/Bitmap.hpp>
+#include <rlGameCanvas++/Blit.hpp>
+#include "private/PixelKernels.hpp" // BlendRow, AddRow, TintRow, LerpColumns, [...]
+#include "private/Clipping.hpp"     // DeFactoCoords
+#include "private/WorkerPool.hpp"
+
+#include <algorithm> // std::min, std::max, std::swap, std::fill
+#include <atomic>
 #include <memory>    // std::unique_ptr
+#include <mutex>
+#include <vector>
 
 
 
@@ -13,179 +18,342 @@ namespace rlGameCanvasLib
 	namespace
 	{
 
-		// as a C++17 replacement for C++20's std::lerp
-		constexpr double lerp(double a, double b, double t) noexcept
+		// Get a buffer for temporary data with room for at least iCount values.
+		// Every thread has its own buffer that only ever grows, so once it's big enough, no more
+		// memory is allocated.
+		// The data is only valid until the next call on the same thread.
+		uint32_t *GetScratchBuffer(size_t iCount)
 		{
-			return a * (1.0 - t) + (b * t);
+			thread_local std::unique_ptr<uint32_t[]> up_iBuffer;
+			thread_local size_t                      iCapacity = 0;
+
+			if (iCount > iCapacity)
+			{
+				up_iBuffer.reset(new uint32_t[iCount]);
+				iCapacity = iCount;
+			}
+			return up_iBuffer.get();
 		}
 
-		Pixel PixelLerp(const Pixel &px1, const Pixel &px2, double dOffset)
+		// Settings for splitting ApplyBitmapOverlay[_Tinted/_Scaled] into bands of rows, see
+		// SetBitmapParallelism.
+		struct RowBandSettings
 		{
-			Pixel pxResult;
-
-			pxResult.rgba.a = (uint8_t)lerp(px1.rgba.a, px2.rgba.a, dOffset);
-			pxResult.rgba.r = (uint8_t)lerp(px1.rgba.r, px2.rgba.r, dOffset);
-			pxResult.rgba.g = (uint8_t)lerp(px1.rgba.g, px2.rgba.g, dOffset);
-			pxResult.rgba.b = (uint8_t)lerp(px1.rgba.b, px2.rgba.b, dOffset);
+			std::mutex                  mux; // locked while the pool is in use
+			std::unique_ptr<WorkerPool> up_oPool;
+			std::atomic<uint64_t>       iMinPixels = ~uint64_t(0); // disabled
+		};
 
-			return pxResult;
+		RowBandSettings &GetRowBandSettings()
+		{
+			static RowBandSettings oSettings;
+			return oSettings;
 		}
 
+		// Call fnRows(iTop, iBottom) for bands of rows that together cover the rows 0 to
+		// iRowCount - 1 of an area.
+		// If the area is big enough, the bands are processed in parallel. Otherwise, or if the
+		// pool is already in use by another thread, fnRows is called once for all rows.
+		// fnRows must write the same pixels to a row no matter which band the row is part of.
+		template <typename TFunc>
+		void ForEachRowBand(UInt iWidth, UInt iRowCount, const TFunc &fnRows)
+		{
+			auto &oSettings = GetRowBandSettings();
+			if (iRowCount > 1 && (uint64_t)iWidth * iRowCount >= oSettings.iMinPixels)
+			{
+				std::unique_lock lock(oSettings.mux, std::try_to_lock);
+				if (lock.owns_lock() && oSettings.up_oPool)
+				{
+					// a few bands per thread, so a thread that starts late doesn't hold up the
+					// others
+					const size_t iBandCount =
+						std::min<size_t>(iRowCount, oSettings.up_oPool->threadCount() * 4);
+					oSettings.up_oPool->run(iBandCount, [&](size_t iBand, size_t)
+						{
+							fnRows(UInt(iBand * iRowCount / iBandCount),
+								UInt((iBand + 1) * iRowCount / iBandCount));
+						}
+					);
+					return;
+				}
+			}
+
+			fnRows(0, iRowCount);
+		}
 
-		bool DeFactoCoords(
-			const Resolution &resDest,
-			Int iOverlayX, Int iOverlayY, const Resolution &resOverlay,
-			UInt &iStartX, UInt &iStartY,       Resolution &resVisible,
-			Rect &rectVisible
-		)
+		// Blit(), with the visible rows split into bands via ForEachRowBand.
+		template <typename TOp>
+		bool BlitBands(const BitmapView &oDest, const BitmapView &oSrc, Int iX, Int iY,
+			const TOp &op, DirtyRects *poDirtyRects)
 		{
-			// check if too far right and/or down
-			if (
-				(iOverlayX > 0 && UInt(iOverlayX) >= resDest.x) ||
-				(iOverlayY > 0 && UInt(iOverlayY) >= resDest.y)
-			)
+			if (!IsValidBitmapView(oDest) || !IsValidBitmapView(oSrc))
 				return false;
 
+			BlitClipping oClipping;
+			if (!ClipBlit(oDest.size, iX, iY, oSrc.size, oClipping))
+				return true;
 
-			iStartX = (iOverlayX < 0) ? UInt(-iOverlayX) : 0;
-			iStartY = (iOverlayY < 0) ? UInt(-iOverlayY) : 0;
+			const auto &rect = oClipping.rectDest;
+			ForEachRowBand(rect.iRight - rect.iLeft, rect.iBottom - rect.iTop,
+				[&](UInt iTop, UInt iBottom)
+				{
+					BlitRows(oDest, oSrc, oClipping, rect.iTop + iTop, rect.iTop + iBottom, op);
+				}
+			);
 
-			if (iStartX >= resOverlay.x || iStartY >= resOverlay.y)
-				return false; // too far left and/or up
+			AddDirtyRect(poDirtyRects, rect);
+			return true;
+		}
 
+		// Steps through the source indices for nearest neighbor scaling, using the source pixel
+		// that contains the center of the destination pixel:
+		//   iSource = floor((iDest + 0.5) * iSourceSize / iDestSize)
+		// The indices are calculated incrementally, without any rounding errors or divisions.
+		class NearestNeighborStepper final
+		{
+		public: // methods
 
-			resVisible =
+			NearestNeighborStepper(UInt iSourceSize, UInt iDestSize, UInt iFirstDest) :
+				m_iDenominator(2 * (uint64_t)iDestSize),
+				m_iStepWhole((2 * (uint64_t)iSourceSize) / m_iDenominator),
+				m_iStepFraction((2 * (uint64_t)iSourceSize) % m_iDenominator)
 			{
-				/* x */ resOverlay.x - iStartX,
-				/* y */ resOverlay.y - iStartY
-			};
-
-			const UInt iRightmost  = UInt(iOverlayX + Int(resOverlay.x));
-			const UInt iBottommost = UInt(iOverlayY + Int(resOverlay.y));
-
-			if (iRightmost >= resDest.x)
-				resVisible.x -= iRightmost  - resDest.x;
-			if (iBottommost >= resDest.y)
-				resVisible.y -= iBottommost - resDest.y;
+				const uint64_t iNumerator = (2 * (uint64_t)iFirstDest + 1) * iSourceSize;
+				m_iIndex    = UInt(iNumerator / m_iDenominator);
+				m_iFraction = iNumerator % m_iDenominator;
+			}
 
-			rectVisible.iLeft   = UInt(iOverlayX + Int(iStartX));
-			rectVisible.iTop    = UInt(iOverlayY + Int(iStartY));
-			rectVisible.iRight  = rectVisible.iLeft + resVisible.x;
-			rectVisible.iBottom = rectVisible.iTop  + resVisible.y;
+			UInt index() const { return m_iIndex; }
 
-			return true;
-		}
+			void next()
+			{
+				m_iIndex    += UInt(m_iStepWhole);
+				m_iFraction += m_iStepFraction;
+				if (m_iFraction >= m_iDenominator)
+				{
+					m_iFraction -= m_iDenominator;
+					++m_iIndex;
+				}
+			}
 
-	}
 
+		private: // variables
 
+			const uint64_t m_iDenominator;
+			const uint64_t m_iStepWhole;
+			const uint64_t m_iStepFraction;
+			UInt     m_iIndex;
+			uint64_t m_iFraction;
 
-	bool ApplyBitmapOverlay(
-		Bitmap               *poBase,
-		const Bitmap         *poOverlay,
-		Int                   iOverlayX,
-		Int                   iOverlayY,
-		BitmapOverlayStrategy eOverlayStrategy
-	)
-	{
-		if (poBase == nullptr || poOverlay == nullptr)
-			return false;
+		};
 
-		UInt       iStartX, iStartY;
-		Resolution resVisible;
-		Rect       rectVisible;
-		if (!DeFactoCoords(poBase->size, iOverlayX, iOverlayY, poOverlay->size,
-			iStartX, iStartY, resVisible, rectVisible)
-		)
-			return true;
+		// Get the row function for an overlay strategy.
+		// fnBlendRow is nullptr for BitmapOverlayStrategy::Replace.
+		// Returns false if the strategy is invalid.
+		bool GetBlendRowFunc(BitmapOverlayStrategy eOverlayStrategy, BlendRowFunc &fnBlendRow)
+		{
+			switch (eOverlayStrategy)
+			{
+			case BitmapOverlayStrategy::Replace:
+				fnBlendRow = nullptr;
+				return true;
+			case BitmapOverlayStrategy::Blend:
+				fnBlendRow = BlendRow;
+				return true;
+			case BitmapOverlayStrategy::BlendPremultiplied:
+				fnBlendRow = BlendPremultipliedRow;
+				return true;
+			case BitmapOverlayStrategy::Add:
+				fnBlendRow = AddRow;
+				return true;
+			case BitmapOverlayStrategy::Multiply:
+				fnBlendRow = MultiplyRow;
+				return true;
+			case BitmapOverlayStrategy::Screen:
+				fnBlendRow = ScreenRow;
+				return true;
+			default:
+				return false;
+			}
+		}
 
 
 
-		switch (eOverlayStrategy)
-		{
-		case BitmapOverlayStrategy::Replace:
+		// An overlay that was already clipped to the base bitmap.
+		struct ClippedOverlay
 		{
-			const size_t iRowDataSize = resVisible.x * sizeof(Pixel);
-			size_t iOffsetBase    = (size_t)rectVisible.iTop * poBase->size.x + rectVisible.iLeft;
-			size_t iOffsetOverlay = (size_t)iStartY       * poOverlay->size.x + iStartX;
+			const uint32_t *pSrc;       // first visible pixel of the overlay
+			UInt            iSrcStride; // width of the overlay
+			Rect            rect;       // visible area, in coordinates of the base bitmap
+			BlendRowFunc    fnBlendRow; // nullptr --> replace
+		};
 
-			for (size_t iY = iStartY; iY < poOverlay->size.y; ++iY)
-			{
-				if (UInt(iOverlayY + (Int)iY) >= poBase->size.y)
-					break;
+		// Apply the rows iTop to iBottom - 1 (in coordinates of the base bitmap) of a clipped
+		// overlay.
+		void ApplyClippedOverlayRows(Bitmap &oBase, const ClippedOverlay &oOverlay,
+			UInt iTop, UInt iBottom)
+		{
+			const size_t iWidth = oOverlay.rect.iRight - oOverlay.rect.iLeft;
 
-				memcpy_s(
-					poBase->ppxData    + iOffsetBase,    iRowDataSize,
-					poOverlay->ppxData + iOffsetOverlay, iRowDataSize
-				);
+			const uint32_t *pSrc = oOverlay.pSrc +
+				(size_t)(iTop - oOverlay.rect.iTop) * oOverlay.iSrcStride;
+			uint32_t *pDest = oBase.ppxData + ((size_t)iTop * oBase.size.x + oOverlay.rect.iLeft);
 
-				iOffsetBase    += poBase->size.x;
-				iOffsetOverlay += poOverlay->size.x;
+			for (UInt iY = iTop; iY < iBottom;
+				++iY, pSrc += oOverlay.iSrcStride, pDest += oBase.size.x)
+			{
+				if (oOverlay.fnBlendRow)
+					oOverlay.fnBlendRow(pDest, pSrc, iWidth);
+				else
+					memcpy_s(pDest, iWidth * sizeof(Pixel), pSrc, iWidth * sizeof(Pixel));
 			}
-			break;
 		}
 
-		case BitmapOverlayStrategy::Blend:
-		{
-			const size_t iIgnoredPixels_Overlay = (size_t)poOverlay->size.x - resVisible.x;
-			const size_t iIgnoredPixels_Base    = (size_t)poBase   ->size.x - resVisible.x;
+	}
 
 
-			const Pixel *pSrc = reinterpret_cast<Pixel *>(poOverlay->ppxData) +
-				(iStartY * poOverlay->size.x + iStartX);
-			Pixel *pDest = reinterpret_cast<Pixel *>(poBase->ppxData +
-				(rectVisible.iTop * poBase->size.x + rectVisible.iLeft));
 
-			for (size_t iY = iStartY; iY < poOverlay->size.y; ++iY)
-			{
-				if (UInt(iOverlayY + (Int)iY) >= poBase->size.y)
-					break;
+	void BlitOp::Replace::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		memcpy_s(pDest, iCount * sizeof(Pixel), pSrc, iCount * sizeof(Pixel));
+	}
 
-				for (size_t iX = iStartX; iX < poOverlay->size.x; ++iX, ++pSrc, ++pDest)
-				{
-					if (UInt(iOverlayX + (Int)iX) >= poBase->size.x)
-						break;
+	void BlitOp::Blend::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		BlendRow(pDest, pSrc, iCount);
+	}
 
-					switch (pSrc->rgba.a)
-					{
-					case 0: // transparent --> do nothing
-						break;
+	void BlitOp::BlendPremultiplied::operator()(PixelInt *pDest, const PixelInt *pSrc,
+		size_t iCount) const
+	{
+		BlendPremultipliedRow(pDest, pSrc, iCount);
+	}
 
-					case 255: // fully opaque --> override
-						*pDest = *pSrc;
-						break;
+	void BlitOp::Add::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		AddRow(pDest, pSrc, iCount);
+	}
 
-					default: // partially transparent --> mix
-					{
-						const double dVisibility_Top    = pSrc->rgba.a / 255.0;
-						const double dVisibility_Bottom = 1.0 - dVisibility_Top;
-
-						pDest->rgba.a =
-							uint8_t(std::min(255.0, (double)pDest->rgba.a + pSrc->rgba.a));
-						pDest->rgba.r = uint8_t(std::min(255.0,
-							dVisibility_Top * pDest->rgba.r + dVisibility_Bottom * pSrc->rgba.r));
-						pDest->rgba.g = uint8_t(std::min(255.0,
-							dVisibility_Top * pDest->rgba.g + dVisibility_Bottom * pSrc->rgba.g));
-						pDest->rgba.b = uint8_t(std::min(255.0,
-							dVisibility_Top * pDest->rgba.b + dVisibility_Bottom * pSrc->rgba.b));
-
-						break;
-					}
-					}
-				}
+	void BlitOp::Multiply::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		MultiplyRow(pDest, pSrc, iCount);
+	}
 
-				pSrc  += iIgnoredPixels_Overlay;
-				pDest += iIgnoredPixels_Base;
-			}
-			break;
-		}
+	void BlitOp::Screen::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		ScreenRow(pDest, pSrc, iCount);
+	}
 
+	void BlitOp::Tint::operator()(PixelInt *pDest, const PixelInt *pSrc, size_t iCount) const
+	{
+		// the row is tinted into a temporary row, which is then blended onto the destination
+		// while it's still in the cache.
+		uint32_t *const pRowTemp = GetScratchBuffer(iCount);
+		TintRow(pRowTemp, pSrc, pxTint, iCount);
+		BlendRow(pDest, pRowTemp, iCount);
+	}
+
+
+
+	BitmapView GetBitmapView(const Bitmap &bmp)
+	{
+		return { bmp.ppxData, bmp.size, bmp.size.x };
+	}
+
+	BitmapView GetBitmapSubView(const BitmapView &oView, const Rect &rect)
+	{
+		const UInt iLeft   = std::min(rect.iLeft, oView.size.x);
+		const UInt iTop    = std::min(rect.iTop,  oView.size.y);
+		const UInt iRight  = std::max(std::min(rect.iRight,  oView.size.x), iLeft);
+		const UInt iBottom = std::max(std::min(rect.iBottom, oView.size.y), iTop);
+
+		BitmapView oSubView = {};
+		oSubView.size    = { iRight - iLeft, iBottom - iTop };
+		oSubView.iStride = oView.iStride;
+		if (oView.ppxData != nullptr && oSubView.size.x > 0 && oSubView.size.y > 0)
+			oSubView.ppxData = oView.ppxData + ((size_t)iTop * oView.iStride + iLeft);
+		return oSubView;
+	}
+
+
+
+	bool ApplyBitmapOverlay(
+		Bitmap               *poBase,
+		const Bitmap         *poOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || poOverlay == nullptr)
+			return false;
+
+		return ApplyBitmapOverlay(GetBitmapView(*poBase), GetBitmapView(*poOverlay),
+			iOverlayX, iOverlayY, eOverlayStrategy, poDirtyRects);
+	}
+
+	bool ApplyBitmapOverlay(
+		const BitmapView     &oBase,
+		const BitmapView     &oOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		switch (eOverlayStrategy)
+		{
+		case BitmapOverlayStrategy::Replace:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Replace(),
+				poDirtyRects);
+		case BitmapOverlayStrategy::Blend:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Blend(),
+				poDirtyRects);
+		case BitmapOverlayStrategy::BlendPremultiplied:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::BlendPremultiplied(),
+				poDirtyRects);
+		case BitmapOverlayStrategy::Add:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Add(),
+				poDirtyRects);
+		case BitmapOverlayStrategy::Multiply:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Multiply(),
+				poDirtyRects);
+		case BitmapOverlayStrategy::Screen:
+			return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Screen(),
+				poDirtyRects);
 		default:
 			return false;
 		}
+	}
 
+	bool ApplyBitmapOverlay_Tinted(
+		Bitmap       *poBase,
+		const Bitmap *poOverlay,
+		Int           iOverlayX,
+		Int           iOverlayY,
+		PixelInt      pxTint,
+		DirtyRects   *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || poOverlay == nullptr)
+			return false;
 
-		return true;
+		return ApplyBitmapOverlay_Tinted(GetBitmapView(*poBase), GetBitmapView(*poOverlay),
+			iOverlayX, iOverlayY, pxTint, poDirtyRects);
+	}
+
+	bool ApplyBitmapOverlay_Tinted(
+		const BitmapView &oBase,
+		const BitmapView &oOverlay,
+		Int               iOverlayX,
+		Int               iOverlayY,
+		PixelInt          pxTint,
+		DirtyRects       *poDirtyRects
+	)
+	{
+		return BlitBands(oBase, oOverlay, iOverlayX, iOverlayY, BlitOp::Tint{ pxTint },
+			poDirtyRects);
 	}
 
 	bool ApplyBitmapOverlay_Scaled(
@@ -196,15 +364,38 @@ namespace rlGameCanvasLib
 		UInt                  iOverlayScaledWidth,
 		UInt                  iOverlayScaledHeight,
 		BitmapOverlayStrategy eOverlayStrategy,
-		BitmapScalingStrategy eScalingStrategy
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || poOverlay == nullptr)
+			return false;
+
+		return ApplyBitmapOverlay_Scaled(GetBitmapView(*poBase), GetBitmapView(*poOverlay),
+			iOverlayX, iOverlayY, iOverlayScaledWidth, iOverlayScaledHeight,
+			eOverlayStrategy, eScalingStrategy, poDirtyRects);
+	}
+
+	bool ApplyBitmapOverlay_Scaled(
+		const BitmapView     &oBase,
+		const BitmapView     &oOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		UInt                  iOverlayScaledWidth,
+		UInt                  iOverlayScaledHeight,
+		BitmapOverlayStrategy eOverlayStrategy,
+		BitmapScalingStrategy eScalingStrategy,
+		DirtyRects           *poDirtyRects
 	)
 	{
-		if (iOverlayScaledWidth == 0 || iOverlayScaledHeight == 0)
+		if (!IsValidBitmapView(oBase) || !IsValidBitmapView(oOverlay) ||
+			iOverlayScaledWidth == 0 || iOverlayScaledHeight == 0)
 			return false;
 
 		// same size --> draw directly
-		if (iOverlayScaledWidth == poOverlay->size.x && iOverlayScaledHeight == poOverlay->size.y)
-			return ApplyBitmapOverlay(poBase, poOverlay, iOverlayX, iOverlayY, eOverlayStrategy);
+		if (iOverlayScaledWidth == oOverlay.size.x && iOverlayScaledHeight == oOverlay.size.y)
+			return ApplyBitmapOverlay(oBase, oOverlay, iOverlayX, iOverlayY, eOverlayStrategy,
+				poDirtyRects);
 
 		const Resolution resScaled =
 		{
@@ -215,138 +406,461 @@ namespace rlGameCanvasLib
 		Resolution resVisible;
 		Rect       rectVisible;
 		if (!DeFactoCoords(
-			poBase->size, iOverlayX, iOverlayY, resScaled,
+			oBase.size, iOverlayX, iOverlayY, resScaled,
 			iStartX, iStartY, resVisible, rectVisible
 		))
 			return true;
 
 
-		// create temporary bitmap
-		auto up_pxScaled = std::make_unique<Pixel[]>(
-			(size_t)resVisible.x * resVisible.y
-		);
-		Bitmap bmpTemp =
-		{
-			/* ppxData */ reinterpret_cast<rlGameCanvas_Pixel *>(up_pxScaled.get()),
-			/* size */
-			{
-				/* x */ resVisible.x,
-				/* y */ resVisible.y
-			}
-		};
+		uint32_t *const pDestBase = oBase.ppxData +
+			((size_t)rectVisible.iTop * oBase.iStride + rectVisible.iLeft);
+		const uint32_t *const src = oOverlay.ppxData;
 
-		const auto &src = poOverlay->ppxData;
+		// Replace: the scaled rows are written directly into the base bitmap.
+		// Blend:   every scaled row is written into a temporary row, which is then blended onto the
+		//          base bitmap while it's still in the cache.
+		BlendRowFunc fnBlendRow;
+		if (!GetBlendRowFunc(eOverlayStrategy, fnBlendRow))
+			return false;
+		const bool bBlend = fnBlendRow != nullptr;
+
+		// nothing to sample from
+		if (oOverlay.size.x == 0 || oOverlay.size.y == 0)
+			return true;
 
 
 
-		// scale to temporary bitmap
-		const double dHalfPixelWidth  = 1.0 / (2.0 * poOverlay->size.x);
-		const double dHalfPixelHeight = 1.0 / (2.0 * poOverlay->size.y);
 		switch (eScalingStrategy)
 		{
 		case BitmapScalingStrategy::NearestNeighbor:
 		{
-			auto up_oSamplePixels = std::make_unique<UInt[]>(resVisible.x);
-			for (size_t iX = 0; iX < resVisible.x; ++iX)
-			{
-				size_t iAbsX = iStartX + iX;
-				const double dX = (double)iAbsX / iOverlayScaledWidth;
-				up_oSamplePixels[iX] =
-					(UInt)std::min<double>(
-						poOverlay->size.x - 1,
-						std::round(dX * poOverlay->size.x + dHalfPixelWidth)
-					);
-			}
-
-			Pixel *pDest = up_pxScaled.get();
-			for (size_t iY = iStartY; iY < resVisible.y; ++iY)
-			{
-				const double dY       = (double)iY / iOverlayScaledHeight;
-				const UInt   iSampleY =
-					(UInt)std::min<double>(
-						poOverlay->size.y - 1,
-						std::round(dY * poOverlay->size.y + dHalfPixelHeight)
-					);
-				const size_t iSampleOffset = (size_t)iSampleY * poOverlay->size.x;
+			// integer horizontal factor (pixel art zoom) --> every source pixel is simply repeated.
+			// otherwise, the pixels are sampled via a column table.
+			const bool bIntegerX = iOverlayScaledWidth % oOverlay.size.x == 0;
+			const UInt iFactorX  = iOverlayScaledWidth / oOverlay.size.x;
 
-				for (size_t iX = 0; iX < resVisible.x; ++iX, ++pDest)
+			ForEachRowBand(resVisible.x, resVisible.y, [&](UInt iTop, UInt iBottom)
 				{
-					*pDest = src[iSampleOffset + up_oSamplePixels[iX]];
+					// scratch layout: source column table (non-integer factor only), temporary row
+					// (Blend only)
+					const size_t iColumnCount = bIntegerX ? 0 : resVisible.x;
+					uint32_t *const piColumns =
+						GetScratchBuffer(iColumnCount + (bBlend ? resVisible.x : 0));
+					uint32_t *const pRowTemp  = piColumns + iColumnCount;
+
+					if (!bIntegerX)
+					{
+						NearestNeighborStepper oStepX(oOverlay.size.x, iOverlayScaledWidth,
+							iStartX);
+						for (size_t iX = 0; iX < resVisible.x; ++iX, oStepX.next())
+						{
+							piColumns[iX] = oStepX.index();
+						}
+					}
+
+					const auto fnScaleRow = [&](uint32_t *pRow, const uint32_t *pSrcRow)
+					{
+						if (!bIntegerX)
+						{
+							SampleRow(pRow, pSrcRow, piColumns, resVisible.x);
+							return;
+						}
+
+						// partially visible first pixel
+						const uint32_t *pSrc       = pSrcRow + iStartX / iFactorX;
+						size_t          iRemaining = resVisible.x;
+						const UInt      iSkipped   = iStartX % iFactorX;
+						if (iSkipped > 0)
+						{
+							const size_t iCount =
+								std::min<size_t>(iFactorX - iSkipped, iRemaining);
+							std::fill(pRow, pRow + iCount, *pSrc++);
+							pRow       += iCount;
+							iRemaining -= iCount;
+						}
+
+						const size_t iFullPixels = iRemaining / iFactorX;
+						ScaleRowInteger(pRow, pSrc, iFactorX, iFullPixels);
+						pRow       += iFullPixels * iFactorX;
+						iRemaining -= iFullPixels * iFactorX;
+
+						// partially visible last pixel
+						if (iRemaining > 0)
+							std::fill(pRow, pRow + iRemaining, pSrc[iFullPixels]);
+					};
+
+					// consecutive rows with the same source row are only scaled once and then
+					// copied
+					constexpr UInt iNoRow = ~UInt(0);
+					UInt iPrevSampleY     = iNoRow;
+
+					NearestNeighborStepper oStepY(oOverlay.size.y, iOverlayScaledHeight,
+						iStartY + iTop);
+					uint32_t *pDest = pDestBase + (size_t)iTop * oBase.iStride;
+					for (UInt iY = iTop; iY < iBottom; ++iY, pDest += oBase.iStride, oStepY.next())
+					{
+						const UInt iSampleY = oStepY.index();
+						const uint32_t *const pSrcRow = src + (size_t)iSampleY * oOverlay.iStride;
+
+						if (bBlend)
+						{
+							if (iSampleY != iPrevSampleY)
+								fnScaleRow(pRowTemp, pSrcRow);
+							fnBlendRow(pDest, pRowTemp, resVisible.x);
+						}
+						else if (iSampleY == iPrevSampleY)
+							memcpy_s(pDest, resVisible.x * sizeof(Pixel),
+								pDest - oBase.iStride, resVisible.x * sizeof(Pixel));
+						else
+							fnScaleRow(pDest, pSrcRow);
+
+						iPrevSampleY = iSampleY;
+					}
 				}
-			}
+			);
 			break;
 		}
 
 
 		case BitmapScalingStrategy::Bilinear:
 		{
-			const double dScaleX = (double)poOverlay->size.x / iOverlayScaledWidth;
-			const double dScaleY = (double)poOverlay->size.y / iOverlayScaledHeight;
+			// 16.16 fixed point distance between two sample positions
+			const uint64_t iStepX = ((uint64_t)oOverlay.size.x << 16) / iOverlayScaledWidth;
+			const uint64_t iStepY = ((uint64_t)oOverlay.size.y << 16) / iOverlayScaledHeight;
 
-			struct HSamplingInfo
-			{
-				UInt   iIndexLeft, iIndexRight;
-				// positive values that sum up to 0.5
-				double dOffsetX;
-			};
-
-			auto up_oSamplePixels = std::make_unique<HSamplingInfo[]>(resVisible.x);
-			{
-				auto pDest = up_oSamplePixels.get();
-				for (size_t iX = 0; iX < resVisible.x; ++iX, ++pDest)
+			ForEachRowBand(resVisible.x, resVisible.y, [&](UInt iTop, UInt iBottom)
 				{
-					const double dXAbs = dScaleX * (iStartX + iX);
+					// scratch layout: horizontal sampling table (left column, right column and
+					// weight of the right one), two interpolated source rows, temporary row (Blend
+					// only)
+					uint32_t *const piLeft   =
+						GetScratchBuffer((size_t)resVisible.x * (bBlend ? 6 : 5));
+					uint32_t *const piRight  = piLeft   + resVisible.x;
+					uint32_t *const piWeight = piRight  + resVisible.x;
+					uint32_t *const pRowTemp = piWeight + resVisible.x * 3;
+					for (size_t iX = 0; iX < resVisible.x; ++iX)
+					{
+						const uint64_t iPos = iStepX * (iStartX + iX);
 
-					pDest->iIndexLeft  = UInt(dXAbs);
-					pDest->iIndexRight =
-						UInt(std::min<double>(poOverlay->size.x - 1, pDest->iIndexLeft + 1));
+						piLeft  [iX] = uint32_t(iPos >> 16);
+						piRight [iX] = std::min(piLeft[iX] + 1, oOverlay.size.x - 1);
+						piWeight[iX] = uint32_t(iPos >> 8) & 0xFF;
+					}
 
-					pDest->dOffsetX = dXAbs - pDest->iIndexLeft;
+					// horizontally interpolated source rows.
+					// when upscaling, consecutive output rows mostly use the same pair of source
+					// rows, so the rows are only interpolated again when the source row changes.
+					constexpr UInt iNoRow = ~UInt(0);
+					uint32_t *pRowTop    = piWeight + resVisible.x;
+					uint32_t *pRowBottom = pRowTop  + resVisible.x;
+					UInt iRowTop    = iNoRow;
+					UInt iRowBottom = iNoRow;
+
+					uint32_t *pDest = pDestBase + (size_t)iTop * oBase.iStride;
+					for (UInt iY = iTop; iY < iBottom; ++iY, pDest += oBase.iStride)
+					{
+						const uint64_t iPos = iStepY * (iStartY + iY);
+
+						const UInt iIndexTop    = UInt(iPos >> 16);
+						const UInt iIndexBottom = std::min(iIndexTop + 1, oOverlay.size.y - 1);
+
+						if (iIndexTop != iRowTop && iIndexTop == iRowBottom)
+						{
+							std::swap(pRowTop, pRowBottom);
+							iRowTop    = iRowBottom;
+							iRowBottom = iNoRow;
+						}
+						if (iIndexTop != iRowTop)
+						{
+							LerpColumns(pRowTop, src + (size_t)iIndexTop * oOverlay.iStride,
+								piLeft, piRight, piWeight, resVisible.x);
+							iRowTop = iIndexTop;
+						}
+						if (iIndexBottom != iRowBottom)
+						{
+							LerpColumns(pRowBottom, src + (size_t)iIndexBottom * oOverlay.iStride,
+								piLeft, piRight, piWeight, resVisible.x);
+							iRowBottom = iIndexBottom;
+						}
+
+						const uint32_t iWeight = uint32_t(iPos >> 8) & 0xFF;
+						if (bBlend)
+						{
+							LerpRows(pRowTemp, pRowTop, pRowBottom, iWeight, resVisible.x);
+							fnBlendRow(pDest, pRowTemp, resVisible.x);
+						}
+						else
+							LerpRows(pDest, pRowTop, pRowBottom, iWeight, resVisible.x);
+					}
 				}
-			}
+			);
+			break;
+		}
+			
+		default:
+			return false;
+		}
 
-			Pixel *pDest = up_pxScaled.get();
-			for (size_t iY = 0; iY < resVisible.y; ++iY)
-			{
-				const double dYAbs = dScaleY * (iStartY + iY);
 
-				const UInt iIndexTop    = UInt(dYAbs);
-				const UInt iIndexBottom = UInt(std::min<double>(
-					poOverlay->size.y - 1,
-					iIndexTop + 1
-				));
+		AddDirtyRect(poDirtyRects, rectVisible);
+		return true;
+	}
 
-				const double dOffsetY = dYAbs - iIndexTop;
+	bool SetBitmapParallelism(UInt iThreadCount, UInt iMinPixelCount)
+	{
+		auto &oSettings = GetRowBandSettings();
+		std::unique_lock lock(oSettings.mux); // wait for the pool to be unused
+
+		oSettings.iMinPixels = ~uint64_t(0);
+		oSettings.up_oPool.reset();
+		if (iThreadCount == 1)
+			return true;
 
-				for (size_t iX = 0; iX < resVisible.x; ++iX, ++pDest)
+		try
+		{
+			oSettings.up_oPool = std::make_unique<WorkerPool>(iThreadCount);
+		}
+		catch (...)
+		{
+			return false;
+		}
+		if (oSettings.up_oPool->threadCount() == 1)
+		{
+			oSettings.up_oPool.reset(); // single logical processor/no threads could be created
+			return true;
+		}
+
+		oSettings.iMinPixels = iMinPixelCount;
+		return true;
+	}
+
+
+
+	bool ApplyBitmapOverlayBatch(
+		Bitmap                        *poBase,
+		const BitmapOverlayBatchEntry *pcoEntries,
+		UInt                           iEntryCount,
+		bool                           bMultithreaded,
+		DirtyRects                    *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || !IsValidBitmapView(GetBitmapView(*poBase)) ||
+			(pcoEntries == nullptr && iEntryCount > 0))
+			return false;
+
+		// validate and clip all entries before anything is drawn
+		std::vector<ClippedOverlay> oOverlays;
+		oOverlays.reserve(iEntryCount);
+		for (UInt iEntry = 0; iEntry < iEntryCount; ++iEntry)
+		{
+			const auto &entry = pcoEntries[iEntry];
+			if (entry.poOverlay == nullptr || !IsValidBitmapView(GetBitmapView(*entry.poOverlay)))
+				return false;
+
+			ClippedOverlay oOverlay;
+			if (!GetBlendRowFunc(entry.eOverlayStrategy, oOverlay.fnBlendRow))
+				return false;
+
+			UInt       iStartX, iStartY;
+			Resolution resVisible;
+			if (!DeFactoCoords(poBase->size, entry.iX, entry.iY, entry.poOverlay->size,
+				iStartX, iStartY, resVisible, oOverlay.rect)
+			)
+				continue; // invisible
+
+			oOverlay.pSrc       = entry.poOverlay->ppxData +
+				((size_t)iStartY * entry.poOverlay->size.x + iStartX);
+			oOverlay.iSrcStride = entry.poOverlay->size.x;
+			oOverlays.push_back(oOverlay);
+		}
+		// nothing visible on an empty base bitmap, even if an entry was clipped to an empty area
+		if (oOverlays.empty() || poBase->size.x == 0 || poBase->size.y == 0)
+			return true;
+
+		for (const auto &o : oOverlays)
+		{
+			AddDirtyRect(poDirtyRects, o.rect);
+		}
+
+
+
+		// The base bitmap is processed in bands of rows that fit into the cache.
+		// Within a band, the overlays are applied in their original order. Different bands never
+		// share any pixels, so they can be processed in any order/in parallel.
+		constexpr size_t iBandBytes = 64 * 1024;
+		const UInt iBandHeight = (UInt)std::max<size_t>(1,
+			iBandBytes / ((size_t)poBase->size.x * sizeof(Pixel)));
+		const UInt iBandCount  = (poBase->size.y + iBandHeight - 1) / iBandHeight;
+
+		// indices of the overlays per band (iBandStart[i] to iBandStart[i + 1] - 1)
+		std::vector<size_t> oBandStart((size_t)iBandCount + 1, 0);
+		for (const auto &o : oOverlays)
+		{
+			for (UInt iBand = o.rect.iTop / iBandHeight; iBand * iBandHeight < o.rect.iBottom;
+				++iBand)
+			{
+				++oBandStart[iBand + 1];
+			}
+		}
+		for (size_t iBand = 0; iBand < iBandCount; ++iBand)
+		{
+			oBandStart[iBand + 1] += oBandStart[iBand];
+		}
+		std::vector<size_t> oBandOverlays(oBandStart.back());
+		{
+			std::vector<size_t> oBandFill(oBandStart.begin(), oBandStart.end() - 1);
+			for (size_t iOverlay = 0; iOverlay < oOverlays.size(); ++iOverlay)
+			{
+				const auto &o = oOverlays[iOverlay];
+				for (UInt iBand = o.rect.iTop / iBandHeight; iBand * iBandHeight < o.rect.iBottom;
+					++iBand)
 				{
-					const auto &si = up_oSamplePixels[iX];
+					oBandOverlays[oBandFill[iBand]++] = iOverlay;
+				}
+			}
+		}
 
-					const Pixel pxSample[4] =
-					{
-						src[iIndexTop    * poOverlay->size.x + si.iIndexLeft ],
-						src[iIndexTop    * poOverlay->size.x + si.iIndexRight],
-						src[iIndexBottom * poOverlay->size.x + si.iIndexLeft ],
-						src[iIndexBottom * poOverlay->size.x + si.iIndexRight]
-					};
+		// the rows iTop to iBottom - 1 of the base bitmap, band by band.
+		// the bands of the shared pool (see SetBitmapParallelism) don't have to line up with the
+		// cache-sized bands, every row is drawn the same way no matter how the rows are split.
+		const auto fnApplyRows = [&](UInt iTop, UInt iBottom)
+		{
+			for (UInt iBand = iTop / iBandHeight; iBand * iBandHeight < iBottom; ++iBand)
+			{
+				const UInt iBandTop    = std::max(iBand * iBandHeight, iTop);
+				const UInt iBandBottom = std::min((iBand + 1) * iBandHeight, iBottom);
 
-					const Pixel pxTop    = PixelLerp(pxSample[0], pxSample[1], si.dOffsetX);
-					const Pixel pxBottom = PixelLerp(pxSample[2], pxSample[3], si.dOffsetX);
+				for (size_t i = oBandStart[iBand]; i < oBandStart[iBand + 1]; ++i)
+				{
+					const auto &o = oOverlays[oBandOverlays[i]];
 
-					*pDest = PixelLerp(pxTop, pxBottom, dOffsetY);
+					const UInt iOverlayTop    = std::max(o.rect.iTop,    iBandTop);
+					const UInt iOverlayBottom = std::min(o.rect.iBottom, iBandBottom);
+					if (iOverlayTop < iOverlayBottom)
+						ApplyClippedOverlayRows(*poBase, o, iOverlayTop, iOverlayBottom);
 				}
 			}
-			break;
+		};
+
+		if (bMultithreaded)
+			ForEachRowBand(poBase->size.x, poBase->size.y, fnApplyRows);
+		else
+			fnApplyRows(0, poBase->size.y);
+
+		return true;
+	}
+
+
+	bool ApplyIndexedBitmapOverlay(
+		IndexedBitmap        *poBase,
+		const IndexedBitmap  *poOverlay,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || poOverlay == nullptr)
+			return false;
+
+		if (eOverlayStrategy != BitmapOverlayStrategy::Replace &&
+			eOverlayStrategy != BitmapOverlayStrategy::Blend)
+			return false;
+
+		UInt       iStartX, iStartY;
+		Resolution resVisible;
+		Rect       rectVisible;
+		if (!DeFactoCoords(poBase->size, iOverlayX, iOverlayY, poOverlay->size,
+			iStartX, iStartY, resVisible, rectVisible)
+		)
+			return true;
+
+		const uint8_t *piSrc = poOverlay->piData +
+			((size_t)iStartY * poOverlay->size.x + iStartX);
+		uint8_t *piDest = poBase->piData +
+			((size_t)rectVisible.iTop * poBase->size.x + rectVisible.iLeft);
+
+		for (size_t iY = 0; iY < resVisible.y;
+			++iY, piSrc += poOverlay->size.x, piDest += poBase->size.x)
+		{
+			if (eOverlayStrategy == BitmapOverlayStrategy::Replace)
+				memcpy_s(piDest, resVisible.x, piSrc, resVisible.x);
+			else
+				CopyIndexedRowKeyed(piDest, piSrc, resVisible.x);
 		}
-			
-		default:
+
+		AddDirtyRect(poDirtyRects, rectVisible);
+		return true;
+	}
+
+	bool ApplyIndexedBitmapOverlayRGBA(
+		Bitmap               *poBase,
+		const IndexedBitmap  *poOverlay,
+		const PixelInt       *pcpxPalette,
+		Int                   iOverlayX,
+		Int                   iOverlayY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || poOverlay == nullptr || pcpxPalette == nullptr)
 			return false;
+
+		BlendRowFunc fnBlendRow;
+		if (!GetBlendRowFunc(eOverlayStrategy, fnBlendRow))
+			return false;
+
+		UInt       iStartX, iStartY;
+		Resolution resVisible;
+		Rect       rectVisible;
+		if (!DeFactoCoords(poBase->size, iOverlayX, iOverlayY, poOverlay->size,
+			iStartX, iStartY, resVisible, rectVisible)
+		)
+			return true;
+
+		// Replace: the colors are looked up directly into the base bitmap.
+		// Blend:   every row is looked up into a temporary row, which is then blended onto the base
+		//          bitmap.
+		uint32_t *const pRowTemp = fnBlendRow ? GetScratchBuffer(resVisible.x) : nullptr;
+
+		const uint8_t *piSrc = poOverlay->piData +
+			((size_t)iStartY * poOverlay->size.x + iStartX);
+		uint32_t *pDest = poBase->ppxData +
+			((size_t)rectVisible.iTop * poBase->size.x + rectVisible.iLeft);
+
+		for (size_t iY = 0; iY < resVisible.y;
+			++iY, piSrc += poOverlay->size.x, pDest += poBase->size.x)
+		{
+			if (fnBlendRow)
+			{
+				ExpandIndexedRow(pRowTemp, piSrc, pcpxPalette, resVisible.x);
+				fnBlendRow(pDest, pRowTemp, resVisible.x);
+			}
+			else
+				ExpandIndexedRow(pDest, piSrc, pcpxPalette, resVisible.x);
 		}
 
+		AddDirtyRect(poDirtyRects, rectVisible);
+		return true;
+	}
 
 
-		return ApplyBitmapOverlay(poBase, &bmpTemp, rectVisible.iLeft, rectVisible.iTop,
-			eOverlayStrategy);
+	bool PremultiplyBitmap(Bitmap *poBitmap)
+	{
+		if (poBitmap == nullptr)
+			return false;
+
+		PremultiplyRow(poBitmap->ppxData, (size_t)poBitmap->size.x * poBitmap->size.y);
+		return true;
+	}
+
+	bool UnpremultiplyBitmap(Bitmap *poBitmap)
+	{
+		if (poBitmap == nullptr)
+			return false;
+
+		UnpremultiplyRow(poBitmap->ppxData, (size_t)poBitmap->size.x * poBitmap->size.y);
+		return true;
 	}
 
 }
@@ -1,11 +1,18 @@
 #include <rlGameCanvas/Core.h>
 #include <rlGameCanvas/Bitmap.h>
+#include <rlGameCanvas/Sprite.h>
+#include <rlGameCanvas/Atlas.h>
+#include <rlGameCanvas/Font.h>
 
 #include <rlGameCanvas++/GameCanvas.hpp>
 #include <rlGameCanvas++/Bitmap.hpp>
+#include <rlGameCanvas++/Sprite.hpp>
+#include <rlGameCanvas++/Atlas.hpp>
+#include <rlGameCanvas++/Font.hpp>
 
 #include <exception>
 #include <string>
+#include <vector>
 
 namespace lib = rlGameCanvasLib;
 
@@ -42,6 +49,92 @@ namespace
 		return reinterpret_cast<lib::GameCanvas *>(handle);
 	}
 
+	inline rlGameCanvas_Sprite PointerToHandle(lib::Sprite *pointer)
+	{
+		return reinterpret_cast<rlGameCanvas_Sprite>(pointer);
+	}
+
+	inline lib::Sprite *HandleToPointer(rlGameCanvas_Sprite handle)
+	{
+		return reinterpret_cast<lib::Sprite *>(handle);
+	}
+
+	inline rlGameCanvas_Atlas PointerToHandle(lib::Atlas *pointer)
+	{
+		return reinterpret_cast<rlGameCanvas_Atlas>(pointer);
+	}
+
+	inline lib::Atlas *HandleToPointer(rlGameCanvas_Atlas handle)
+	{
+		return reinterpret_cast<lib::Atlas *>(handle);
+	}
+
+	inline rlGameCanvas_Font PointerToHandle(lib::Font *pointer)
+	{
+		return reinterpret_cast<rlGameCanvas_Font>(pointer);
+	}
+
+	inline lib::Font *HandleToPointer(rlGameCanvas_Font handle)
+	{
+		return reinterpret_cast<lib::Font *>(handle);
+	}
+
+
+
+	// Convert a RL_GAMECANVAS_BMP_OVERLAY_[...] value.
+	bool GetOverlayStrategy(rlGameCanvas_UInt iOverlayStrategy,
+		lib::BitmapOverlayStrategy &eOverlayStrategy)
+	{
+		switch (iOverlayStrategy)
+		{
+		case RL_GAMECANVAS_BMP_OVERLAY_REPLACE:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::Replace;
+			return true;
+
+		case RL_GAMECANVAS_BMP_OVERLAY_BLEND:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::Blend;
+			return true;
+
+		case RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::BlendPremultiplied;
+			return true;
+
+		case RL_GAMECANVAS_BMP_OVERLAY_ADD:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::Add;
+			return true;
+
+		case RL_GAMECANVAS_BMP_OVERLAY_MULTIPLY:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::Multiply;
+			return true;
+
+		case RL_GAMECANVAS_BMP_OVERLAY_SCREEN:
+			eOverlayStrategy = lib::BitmapOverlayStrategy::Screen;
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
+	// Convert a RL_GAMECANVAS_BMP_SCALE_[...] value.
+	bool GetScalingStrategy(rlGameCanvas_UInt iScalingStrategy,
+		lib::BitmapScalingStrategy &eScalingStrategy)
+	{
+		switch (iScalingStrategy)
+		{
+		case RL_GAMECANVAS_BMP_SCALE_NEAREST_NEIGHBOR:
+			eScalingStrategy = lib::BitmapScalingStrategy::NearestNeighbor;
+			return true;
+
+		case RL_GAMECANVAS_BMP_SCALE_BILINEAR:
+			eScalingStrategy = lib::BitmapScalingStrategy::Bilinear;
+			return true;
+
+		default:
+			return false;
+		}
+	}
+
 }
 
 
@@ -97,8 +190,56 @@ RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_Quit(
 	HandleToPointer(canvas)->quit();
 }
 
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetUploadStatistics(
+	rlGameCanvas                   canvas,
+	rlGameCanvas_UploadStatistics *pStatistics
+)
+{
+	if (!canvas || !pStatistics)
+		return false;
+
+	*pStatistics = HandleToPointer(canvas)->getUploadStatistics();
+	return true;
+}
 
 
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_AddDirtyRect(
+	rlGameCanvas_DirtyRects *poDirtyRects,
+	const rlGameCanvas_Rect *pcoRect
+)
+{
+	if (pcoRect == nullptr)
+		return 0;
+
+	return lib::AddDirtyRect(poDirtyRects, *pcoRect);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetBitmapView(
+	const rlGameCanvas_Bitmap *pcoBitmap,
+	rlGameCanvas_BitmapView   *poView
+)
+{
+	if (pcoBitmap == nullptr || poView == nullptr)
+		return 0;
+
+	*poView = lib::GetBitmapView(*pcoBitmap);
+	return 1;
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetBitmapSubView(
+	const rlGameCanvas_BitmapView *pcoView,
+	const rlGameCanvas_Rect       *pcoRect,
+	rlGameCanvas_BitmapView       *poSubView
+)
+{
+	if (pcoView == nullptr || pcoRect == nullptr || poSubView == nullptr)
+		return 0;
+
+	*poSubView = lib::GetBitmapSubView(*pcoView, *pcoRect);
+	return 1;
+}
+
 RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlay(
 	rlGameCanvas_Bitmap       *poBase,
 	const rlGameCanvas_Bitmap *poOverlay,
@@ -107,24 +248,66 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 	rlGameCanvas_UInt          iOverlayStrategy
 )
 {
+	if (poBase == nullptr || poOverlay == nullptr)
+		return 0;
+
+	const auto oBase    = lib::GetBitmapView(*poBase);
+	const auto oOverlay = lib::GetBitmapView(*poOverlay);
+	return rlGameCanvas_ApplyBitmapViewOverlay(&oBase, &oOverlay, iOverlayX, iOverlayY,
+		iOverlayStrategy);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_UInt              iOverlayStrategy
+)
+{
+	if (pcoBase == nullptr || pcoOverlay == nullptr)
+		return 0;
+
+
 	lib::BitmapOverlayStrategy eOverlayStrategy;
-	switch (iOverlayStrategy)
-	{
-	case RL_GAMECANVAS_BMP_OVERLAY_REPLACE:
-		eOverlayStrategy = lib::BitmapOverlayStrategy::Replace;
-		break;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy))
+		return 0;
 
-	case RL_GAMECANVAS_BMP_OVERLAY_BLEND:
-		eOverlayStrategy = lib::BitmapOverlayStrategy::Blend;
-		break;
 
-	default:
+
+	return lib::ApplyBitmapOverlay(*pcoBase, *pcoOverlay, iOverlayX, iOverlayY,
+		eOverlayStrategy);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlay_Tinted(
+	rlGameCanvas_Bitmap       *poBase,
+	const rlGameCanvas_Bitmap *poOverlay,
+	rlGameCanvas_Int           iOverlayX,
+	rlGameCanvas_Int           iOverlayY,
+	rlGameCanvas_Pixel         pxTint
+)
+{
+	if (poBase == nullptr || poOverlay == nullptr)
 		return 0;
-	}
 
+	const auto oBase    = lib::GetBitmapView(*poBase);
+	const auto oOverlay = lib::GetBitmapView(*poOverlay);
+	return rlGameCanvas_ApplyBitmapViewOverlay_Tinted(&oBase, &oOverlay, iOverlayX, iOverlayY,
+		pxTint);
+}
 
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay_Tinted(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_Pixel             pxTint
+)
+{
+	if (pcoBase == nullptr || pcoOverlay == nullptr)
+		return 0;
 
-	return lib::ApplyBitmapOverlay(poBase, poOverlay, iOverlayX, iOverlayY, eOverlayStrategy);
+	return lib::ApplyBitmapOverlay_Tinted(*pcoBase, *pcoOverlay, iOverlayX, iOverlayY, pxTint);
 }
 
 RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlay_Scaled(
@@ -137,6 +320,97 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 	rlGameCanvas_UInt          iOverlayStrategy,
 	rlGameCanvas_UInt          iScalingStrategy
 )
+{
+	if (poBase == nullptr || poOverlay == nullptr)
+		return 0;
+
+	const auto oBase    = lib::GetBitmapView(*poBase);
+	const auto oOverlay = lib::GetBitmapView(*poOverlay);
+	return rlGameCanvas_ApplyBitmapViewOverlay_Scaled(&oBase, &oOverlay, iOverlayX, iOverlayY,
+		iOverlayScaledWidth, iOverlayScaledHeight, iOverlayStrategy, iScalingStrategy);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapViewOverlay_Scaled(
+	const rlGameCanvas_BitmapView *pcoBase,
+	const rlGameCanvas_BitmapView *pcoOverlay,
+	rlGameCanvas_Int               iOverlayX,
+	rlGameCanvas_Int               iOverlayY,
+	rlGameCanvas_UInt              iOverlayScaledWidth,
+	rlGameCanvas_UInt              iOverlayScaledHeight,
+	rlGameCanvas_UInt              iOverlayStrategy,
+	rlGameCanvas_UInt              iScalingStrategy
+)
+{
+	if (pcoBase == nullptr || pcoOverlay == nullptr)
+		return 0;
+
+
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy))
+		return 0;
+
+
+	lib::BitmapScalingStrategy eScalingStrategy;
+	if (!GetScalingStrategy(iScalingStrategy, eScalingStrategy))
+		return 0;
+
+
+
+	return lib::ApplyBitmapOverlay_Scaled(
+		*pcoBase, *pcoOverlay, iOverlayX, iOverlayY,
+		iOverlayScaledWidth, iOverlayScaledHeight, eOverlayStrategy, eScalingStrategy
+	);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_SetBitmapParallelism(
+	rlGameCanvas_UInt iThreadCount,
+	rlGameCanvas_UInt iMinPixelCount
+)
+{
+	return lib::SetBitmapParallelism(iThreadCount, iMinPixelCount);
+}
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOverlayBatch(
+	rlGameCanvas_Bitmap                        *poBase,
+	const rlGameCanvas_BitmapOverlayBatchEntry *pcoEntries,
+	rlGameCanvas_UInt                           iEntryCount,
+	rlGameCanvas_UInt                           iFlags
+)
+{
+	if (!pcoEntries && iEntryCount > 0)
+		return 0;
+
+	std::vector<lib::BitmapOverlayBatchEntry> oEntries(iEntryCount);
+	for (size_t i = 0; i < iEntryCount; ++i)
+	{
+		const auto &entryC = pcoEntries[i];
+		auto       &entry  = oEntries[i];
+
+		entry.poOverlay = entryC.poOverlay;
+		entry.iX        = entryC.iX;
+		entry.iY        = entryC.iY;
+
+		if (!GetOverlayStrategy(entryC.iOverlayStrategy, entry.eOverlayStrategy))
+			return 0;
+	}
+
+
+
+	return lib::ApplyBitmapOverlayBatch(poBase, oEntries.data(), iEntryCount,
+		iFlags & RL_GAMECANVAS_BMP_BATCH_MULTITHREADED);
+}
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyIndexedBitmapOverlay(
+	rlGameCanvas_IndexedBitmap       *poBase,
+	const rlGameCanvas_IndexedBitmap *poOverlay,
+	rlGameCanvas_Int                  iOverlayX,
+	rlGameCanvas_Int                  iOverlayY,
+	rlGameCanvas_UInt                 iOverlayStrategy
+)
 {
 	lib::BitmapOverlayStrategy eOverlayStrategy;
 	switch (iOverlayStrategy)
@@ -154,15 +428,98 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 	}
 
 
-	lib::BitmapScalingStrategy eScalingStrategy;
-	switch (iScalingStrategy)
+
+	return lib::ApplyIndexedBitmapOverlay(poBase, poOverlay, iOverlayX, iOverlayY,
+		eOverlayStrategy);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyIndexedBitmapOverlayRGBA(
+	rlGameCanvas_Bitmap              *poBase,
+	const rlGameCanvas_IndexedBitmap *poOverlay,
+	const rlGameCanvas_Pixel         *pcpxPalette,
+	rlGameCanvas_Int                  iOverlayX,
+	rlGameCanvas_Int                  iOverlayY,
+	rlGameCanvas_UInt                 iOverlayStrategy
+)
+{
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy))
+		return 0;
+
+
+
+	return lib::ApplyIndexedBitmapOverlayRGBA(poBase, poOverlay, pcpxPalette,
+		iOverlayX, iOverlayY, eOverlayStrategy);
+}
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_PremultiplyBitmap(
+	rlGameCanvas_Bitmap *poBitmap
+)
+{
+	return lib::PremultiplyBitmap(poBitmap);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_UnpremultiplyBitmap(
+	rlGameCanvas_Bitmap *poBitmap
+)
+{
+	return lib::UnpremultiplyBitmap(poBitmap);
+}
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Sprite RLGAMECANVAS_LIB rlGameCanvas_CreateSprite(
+	const rlGameCanvas_Bitmap *poBitmap
+)
+{
+	if (!poBitmap || (!poBitmap->ppxData && poBitmap->size.x * poBitmap->size.y > 0))
+		return nullptr;
+
+	lib::Sprite *pResult = nullptr;
+	try
+	{
+		pResult = new lib::Sprite(*poBitmap);
+	}
+	catch (const std::exception &)
+	{
+		return nullptr;
+	}
+
+	return PointerToHandle(pResult);
+}
+
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroySprite(
+	rlGameCanvas_Sprite sprite
+)
+{
+	if (!sprite)
+		return;
+
+	delete HandleToPointer(sprite);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplySpriteOverlay(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Sprite  sprite,
+	rlGameCanvas_Int     iSpriteX,
+	rlGameCanvas_Int     iSpriteY,
+	rlGameCanvas_UInt    iOverlayStrategy
+)
+{
+	if (!sprite)
+		return 0;
+
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	switch (iOverlayStrategy)
 	{
-	case RL_GAMECANVAS_BMP_SCALE_NEAREST_NEIGHBOR:
-		eScalingStrategy = lib::BitmapScalingStrategy::NearestNeighbor;
+	case RL_GAMECANVAS_BMP_OVERLAY_BLEND:
+		eOverlayStrategy = lib::BitmapOverlayStrategy::Blend;
 		break;
 
-	case RL_GAMECANVAS_BMP_SCALE_BILINEAR:
-		eScalingStrategy = lib::BitmapScalingStrategy::Bilinear;
+	case RL_GAMECANVAS_BMP_OVERLAY_BLEND_PREMULTIPLIED:
+		eOverlayStrategy = lib::BitmapOverlayStrategy::BlendPremultiplied;
 		break;
 
 	default:
@@ -171,8 +528,298 @@ RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyBitmapOver
 
 
 
-	return lib::ApplyBitmapOverlay_Scaled(
-		poBase, poOverlay, iOverlayX, iOverlayY,
+	return lib::ApplySpriteOverlay(
+		poBase, *HandleToPointer(sprite), iSpriteX, iSpriteY, eOverlayStrategy
+	);
+}
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Atlas RLGAMECANVAS_LIB rlGameCanvas_CreateAtlas(
+	const rlGameCanvas_Bitmap *pcoBitmaps,
+	rlGameCanvas_UInt          iBitmapCount,
+	rlGameCanvas_UInt          iMaxWidth,
+	rlGameCanvas_UInt          iPadding
+)
+{
+	if (!pcoBitmaps && iBitmapCount > 0)
+		return nullptr;
+
+	lib::Atlas *pResult = nullptr;
+	try
+	{
+		pResult = new lib::Atlas(pcoBitmaps, iBitmapCount, iMaxWidth, iPadding);
+	}
+	catch (const std::exception &)
+	{
+		return nullptr;
+	}
+
+	if (!pResult->valid())
+	{
+		delete pResult;
+		return nullptr;
+	}
+
+	return PointerToHandle(pResult);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Atlas RLGAMECANVAS_LIB rlGameCanvas_LoadAtlas(
+	const void *pcData,
+	size_t      iSize
+)
+{
+	if (!pcData)
+		return nullptr;
+
+	lib::Atlas *pResult = nullptr;
+	try
+	{
+		pResult = new lib::Atlas(pcData, iSize);
+	}
+	catch (const std::exception &)
+	{
+		return nullptr;
+	}
+
+	if (!pResult->valid())
+	{
+		delete pResult;
+		return nullptr;
+	}
+
+	return PointerToHandle(pResult);
+}
+
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroyAtlas(
+	rlGameCanvas_Atlas atlas
+)
+{
+	if (!atlas)
+		return;
+
+	delete HandleToPointer(atlas);
+}
+
+RLGAMECANVAS_API size_t RLGAMECANVAS_LIB rlGameCanvas_GetAtlasSaveSize(
+	rlGameCanvas_Atlas atlas
+)
+{
+	if (!atlas)
+		return 0;
+
+	return HandleToPointer(atlas)->saveSize();
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_SaveAtlas(
+	rlGameCanvas_Atlas atlas,
+	void              *pBuffer,
+	size_t             iBufferSize
+)
+{
+	if (!atlas)
+		return 0;
+
+	return HandleToPointer(atlas)->save(pBuffer, iBufferSize);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetAtlasBitmap(
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_Bitmap *poBitmap
+)
+{
+	if (!atlas || !poBitmap)
+		return 0;
+
+	*poBitmap = HandleToPointer(atlas)->bitmap();
+	return 1;
+}
+
+RLGAMECANVAS_API rlGameCanvas_UInt RLGAMECANVAS_LIB rlGameCanvas_GetAtlasRegionCount(
+	rlGameCanvas_Atlas atlas
+)
+{
+	if (!atlas)
+		return 0;
+
+	return HandleToPointer(atlas)->regionCount();
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_GetAtlasRegion(
+	rlGameCanvas_Atlas       atlas,
+	rlGameCanvas_UInt        iRegion,
+	rlGameCanvas_Rect       *poRect,
+	rlGameCanvas_BitmapView *poView
+)
+{
+	if (!atlas || iRegion >= HandleToPointer(atlas)->regionCount())
+		return 0;
+
+	const auto &oAtlas = *HandleToPointer(atlas);
+	if (poRect)
+		*poRect = oAtlas.region(iRegion);
+	if (poView)
+		*poView = oAtlas.regionView(iRegion);
+	return 1;
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyAtlasRegionOverlay(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_UInt    iRegion,
+	rlGameCanvas_Int     iOverlayX,
+	rlGameCanvas_Int     iOverlayY,
+	rlGameCanvas_UInt    iOverlayStrategy
+)
+{
+	if (!atlas)
+		return 0;
+
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy))
+		return 0;
+
+	return lib::ApplyAtlasRegionOverlay(
+		poBase, *HandleToPointer(atlas), iRegion, iOverlayX, iOverlayY, eOverlayStrategy
+	);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyAtlasRegionOverlay_Scaled(
+	rlGameCanvas_Bitmap *poBase,
+	rlGameCanvas_Atlas   atlas,
+	rlGameCanvas_UInt    iRegion,
+	rlGameCanvas_Int     iOverlayX,
+	rlGameCanvas_Int     iOverlayY,
+	rlGameCanvas_UInt    iOverlayScaledWidth,
+	rlGameCanvas_UInt    iOverlayScaledHeight,
+	rlGameCanvas_UInt    iOverlayStrategy,
+	rlGameCanvas_UInt    iScalingStrategy
+)
+{
+	if (!atlas)
+		return 0;
+
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	lib::BitmapScalingStrategy eScalingStrategy;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy) ||
+		!GetScalingStrategy(iScalingStrategy, eScalingStrategy))
+		return 0;
+
+	return lib::ApplyAtlasRegionOverlay_Scaled(
+		poBase, *HandleToPointer(atlas), iRegion, iOverlayX, iOverlayY,
 		iOverlayScaledWidth, iOverlayScaledHeight, eOverlayStrategy, eScalingStrategy
 	);
 }
+
+
+
+RLGAMECANVAS_API rlGameCanvas_Font RLGAMECANVAS_LIB rlGameCanvas_CreateFixedFont(
+	const rlGameCanvas_Bitmap     *poBitmap,
+	const rlGameCanvas_Resolution *poCellSize,
+	rlGameCanvas_UInt              iFirstCodePoint,
+	rlGameCanvas_UInt              iCacheSize
+)
+{
+	if (!poBitmap || !poCellSize)
+		return nullptr;
+
+	lib::Font *pResult = nullptr;
+	try
+	{
+		pResult = new lib::Font(*poBitmap, *poCellSize, iFirstCodePoint, iCacheSize);
+	}
+	catch (const std::exception &)
+	{
+		return nullptr;
+	}
+
+	if (!pResult->valid())
+	{
+		delete pResult;
+		return nullptr;
+	}
+
+	return PointerToHandle(pResult);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Font RLGAMECANVAS_LIB rlGameCanvas_CreateFont(
+	const rlGameCanvas_Bitmap *poBitmap,
+	const rlGameCanvas_Glyph  *pcoGlyphs,
+	rlGameCanvas_UInt          iGlyphCount,
+	rlGameCanvas_UInt          iLineHeight,
+	rlGameCanvas_UInt          iCacheSize
+)
+{
+	if (!poBitmap || (!pcoGlyphs && iGlyphCount > 0))
+		return nullptr;
+
+	lib::Font *pResult = nullptr;
+	try
+	{
+		pResult = new lib::Font(*poBitmap, pcoGlyphs, iGlyphCount, iLineHeight, iCacheSize);
+	}
+	catch (const std::exception &)
+	{
+		return nullptr;
+	}
+
+	if (!pResult->valid())
+	{
+		delete pResult;
+		return nullptr;
+	}
+
+	return PointerToHandle(pResult);
+}
+
+RLGAMECANVAS_API void RLGAMECANVAS_LIB rlGameCanvas_DestroyFont(
+	rlGameCanvas_Font font
+)
+{
+	if (!font)
+		return;
+
+	delete HandleToPointer(font);
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_MeasureText(
+	rlGameCanvas_Font          font,
+	const rlGameCanvas_U8Char *szText,
+	rlGameCanvas_Resolution   *poSize
+)
+{
+	if (!font || !szText || !poSize)
+		return 0;
+
+	*poSize = lib::MeasureText(*HandleToPointer(font), szText);
+	return 1;
+}
+
+RLGAMECANVAS_API rlGameCanvas_Bool RLGAMECANVAS_LIB rlGameCanvas_ApplyTextOverlay(
+	rlGameCanvas_Bitmap       *poBase,
+	rlGameCanvas_Font          font,
+	const rlGameCanvas_U8Char *szText,
+	rlGameCanvas_Pixel         pxColor,
+	rlGameCanvas_Int           iX,
+	rlGameCanvas_Int           iY,
+	rlGameCanvas_UInt          iOverlayStrategy
+)
+{
+	if (!font)
+		return 0;
+
+	lib::BitmapOverlayStrategy eOverlayStrategy;
+	if (!GetOverlayStrategy(iOverlayStrategy, eOverlayStrategy))
+		return 0;
+
+	try
+	{
+		return lib::ApplyTextOverlay(
+			poBase, *HandleToPointer(font), szText, pxColor, iX, iY, eOverlayStrategy
+		);
+	}
+	catch (const std::exception &)
+	{
+		return 0; // rendering a new text failed
+	}
+}
@@ -0,0 +1,92 @@
+#include "private/CPUFeatures.hpp"
+
+#include <cstdint>
+
+#ifdef RLGAMECANVAS_X86
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif // RLGAMECANVAS_X86
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+#ifdef RLGAMECANVAS_X86
+		// iRegisters = { EAX, EBX, ECX, EDX }
+		void CPUID(unsigned iLeaf, unsigned iSubLeaf, unsigned (&iRegisters)[4])
+		{
+#ifdef _MSC_VER
+			int iResult[4];
+			__cpuidex(iResult, int(iLeaf), int(iSubLeaf));
+			for (size_t i = 0; i < 4; ++i)
+			{
+				iRegisters[i] = unsigned(iResult[i]);
+			}
+#else
+			__cpuid_count(iLeaf, iSubLeaf,
+				iRegisters[0], iRegisters[1], iRegisters[2], iRegisters[3]);
+#endif
+		}
+
+		// Get the extended control register XCR0.
+		// Must only be called if CPUID reports OSXSAVE.
+		uint64_t GetXCR0()
+		{
+#ifdef _MSC_VER
+			return _xgetbv(0);
+#else
+			uint32_t iLow, iHigh;
+			__asm__ volatile("xgetbv" : "=a"(iLow), "=d"(iHigh) : "c"(0));
+			return (uint64_t(iHigh) << 32) | iLow;
+#endif
+		}
+#endif // RLGAMECANVAS_X86
+
+		CPUFeatures DetectCPUFeatures()
+		{
+			CPUFeatures oResult;
+
+#ifdef RLGAMECANVAS_X86
+			unsigned iRegisters[4];
+
+			CPUID(0, 0, iRegisters);
+			const unsigned iMaxLeaf = iRegisters[0];
+			if (iMaxLeaf < 1)
+				return oResult;
+
+			CPUID(1, 0, iRegisters);
+			oResult.bSSE2 = iRegisters[3] & (1u << 26);
+
+			const bool bOSXSAVE = iRegisters[2] & (1u << 27);
+			const bool bAVX     = iRegisters[2] & (1u << 28);
+
+			// the YMM registers can only be used if the OS saves them on a context switch
+			// (which e.g. Windows XP doesn't do).
+			if (bOSXSAVE && bAVX && (GetXCR0() & 0x6) == 0x6 && iMaxLeaf >= 7)
+			{
+				CPUID(7, 0, iRegisters);
+				oResult.bAVX2 = iRegisters[1] & (1u << 5);
+			}
+#endif // RLGAMECANVAS_X86
+
+			return oResult;
+		}
+
+	}
+
+
+
+	const CPUFeatures &GetCPUFeatures()
+	{
+		static const CPUFeatures oFeatures = DetectCPUFeatures();
+		return oFeatures;
+	}
+
+}
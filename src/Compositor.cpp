@@ -0,0 +1,269 @@
+#include "private/Compositor.hpp"
+#include "private/OpenGL.hpp"
+
+#include <cstdio>
+#include <string>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		// The vertices are already given in normalized device coordinates.
+		constexpr char szVertexShader[] = R"(
+void main()
+{
+	gl_Position = gl_Vertex;
+}
+)";
+
+		// Requires "#define MAX_LAYERS" and optionally "#define PREMULTIPLIED_ALPHA" in front.
+		constexpr char szFragmentShader[] = R"(
+uniform sampler2DArray u_oLayers;
+uniform int            u_iLayerCount;
+uniform ivec4          u_viLayers[MAX_LAYERS]; // xy = screen position, zw = layer size
+uniform int            u_iSlices[MAX_LAYERS];
+uniform vec3           u_vBackground;
+uniform ivec2          u_viScreenSize;
+uniform vec2           u_vDrawOrigin; // window coordinates of the top left of the drawing area
+uniform vec2           u_vDrawScale;  // window pixels per canvas pixel
+uniform float          u_fPixelSize;  // integer scaling factor
+
+// Blend all layers at a single canvas pixel.
+vec3 compose(ivec2 viPixel)
+{
+	vec3 vColor = u_vBackground;
+	for (int i = 0; i < u_iLayerCount; ++i)
+	{
+		// layers repeat infinitely
+		ivec2 viTexel = (viPixel + u_viLayers[i].xy) % u_viLayers[i].zw;
+		vec4  v       = texelFetch(u_oLayers, ivec3(viTexel, u_iSlices[i]), 0);
+
+#ifdef PREMULTIPLIED_ALPHA
+		vColor = v.rgb + vColor * (1.0 - v.a);
+#else
+		vColor = mix(vColor, v.rgb, v.a);
+#endif
+	}
+
+	return vColor;
+}
+
+void main()
+{
+	// position on the canvas, in pixels
+	vec2 vPos = vec2(gl_FragCoord.x - u_vDrawOrigin.x, u_vDrawOrigin.y - gl_FragCoord.y) /
+		u_vDrawScale;
+
+	// sharp bilinear: find the two nearest pixels of the integer scaled canvas on both axes,
+	// then look up the canvas pixels they belong to.
+	vec2  vScaled = vPos * u_fPixelSize - 0.5;
+	vec2  vFirst  = floor(vScaled);
+	vec2  vWeight = vScaled - vFirst;
+	ivec2 viMax   = u_viScreenSize - 1;
+	ivec2 viA     = clamp(ivec2(floor( vFirst        / u_fPixelSize)), ivec2(0), viMax);
+	ivec2 viB     = clamp(ivec2(floor((vFirst + 1.0) / u_fPixelSize)), ivec2(0), viMax);
+
+	// most of the time, both are the same pixel --> no need to compose it again
+	vec3 v00 = compose(viA);
+	vec3 v10 = (viB.x != viA.x) ? compose(ivec2(viB.x, viA.y)) : v00;
+	vec3 v01 = (viB.y != viA.y) ? compose(ivec2(viA.x, viB.y)) : v00;
+	vec3 v11 = (viB.y != viA.y) ? ((viB.x != viA.x) ? compose(viB) : v01) : v10;
+
+	gl_FragColor = vec4(mix(mix(v00, v10, vWeight.x), mix(v01, v11, vWeight.x), vWeight.y), 1.0);
+}
+)";
+
+	}
+
+
+
+	Compositor::Compositor(const OpenGL &gl, bool bPremultipliedAlpha) : m_oGL(gl)
+	{
+		if (!gl.supportsShaderCompositor())
+			return;
+
+		const std::string sDefines =
+			"#define MAX_LAYERS " + std::to_string(iMaxLayers) + "\n" +
+			(bPremultipliedAlpha ? "#define PREMULTIPLIED_ALPHA\n" : "");
+		const std::string sFragmentShader = sDefines + szFragmentShader;
+
+		const GLuint iVertexShader   = compileShader(GL_VERTEX_SHADER,   szVertexShader);
+		const GLuint iFragmentShader = compileShader(GL_FRAGMENT_SHADER, sFragmentShader.c_str());
+		if (iVertexShader == 0 || iFragmentShader == 0)
+		{
+			if (iVertexShader)
+				gl.glDeleteShader(iVertexShader);
+			if (iFragmentShader)
+				gl.glDeleteShader(iFragmentShader);
+			return;
+		}
+
+		m_iProgram = gl.glCreateProgram();
+		gl.glAttachShader(m_iProgram, iVertexShader);
+		gl.glAttachShader(m_iProgram, iFragmentShader);
+		gl.glLinkProgram(m_iProgram);
+
+		// the program keeps the shaders alive as long as it needs them
+		gl.glDeleteShader(iVertexShader);
+		gl.glDeleteShader(iFragmentShader);
+
+		GLint iLinked = GL_FALSE;
+		gl.glGetProgramiv(m_iProgram, GL_LINK_STATUS, &iLinked);
+		if (iLinked != GL_TRUE)
+		{
+			char szLog[1024] = {};
+			gl.glGetProgramInfoLog(m_iProgram, sizeof(szLog), nullptr, szLog);
+			fprintf(stderr, "Compositor shader failed to link:\n%s\n", szLog);
+
+			gl.glDeleteProgram(m_iProgram);
+			m_iProgram = 0;
+			return;
+		}
+
+		m_iUniLayerCount = gl.glGetUniformLocation(m_iProgram, "u_iLayerCount");
+		m_iUniLayers     = gl.glGetUniformLocation(m_iProgram, "u_viLayers");
+		m_iUniSlices     = gl.glGetUniformLocation(m_iProgram, "u_iSlices");
+		m_iUniBackground = gl.glGetUniformLocation(m_iProgram, "u_vBackground");
+		m_iUniScreenSize = gl.glGetUniformLocation(m_iProgram, "u_viScreenSize");
+		m_iUniDrawOrigin = gl.glGetUniformLocation(m_iProgram, "u_vDrawOrigin");
+		m_iUniDrawScale  = gl.glGetUniformLocation(m_iProgram, "u_vDrawScale");
+		m_iUniPixelSize  = gl.glGetUniformLocation(m_iProgram, "u_fPixelSize");
+
+		// the texture array is always bound to texture unit 0
+		gl.glUseProgram(m_iProgram);
+		gl.glUniform1i(gl.glGetUniformLocation(m_iProgram, "u_oLayers"), 0);
+		gl.glUseProgram(0);
+	}
+
+	Compositor::~Compositor()
+	{
+		if (m_iTextureArray)
+			glDeleteTextures(1, &m_iTextureArray);
+		if (m_iProgram)
+			m_oGL.glDeleteProgram(m_iProgram);
+	}
+
+	bool Compositor::createTextureArray(GLsizei iWidth, GLsizei iHeight, GLsizei iSlices)
+	{
+		if (m_iTextureArray == 0)
+		{
+			glGenTextures(1, &m_iTextureArray);
+			if (m_iTextureArray == 0)
+				return false;
+
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_iTextureArray);
+
+			// the shader only uses texelFetch, but the texture must be complete anyway
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		}
+		else
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_iTextureArray);
+
+		m_oGL.glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, iWidth, iHeight, iSlices, 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		return glGetError() == GL_NO_ERROR;
+	}
+
+	void Compositor::bindTextureArray() const
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_iTextureArray);
+	}
+
+	void Compositor::texSubImage(GLint iSlice, GLint iX, GLint iY, GLsizei iWidth,
+		GLsizei iHeight, const void *pData) const
+	{
+		m_oGL.glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, iX, iY, iSlice, iWidth, iHeight, 1,
+			GL_RGBA, GL_UNSIGNED_BYTE, pData);
+	}
+
+	void Compositor::draw(const FrameParams &oFrame, const LayerParams *pcoLayers,
+		size_t iLayerCount)
+	{
+		GLint iLayers[iMaxLayers * 4] = {};
+		GLint iSlices[iMaxLayers]     = {};
+		for (size_t i = 0; i < iLayerCount; ++i)
+		{
+			const auto &layer = pcoLayers[i];
+
+			iLayers[i * 4 + 0] = GLint(layer.oScreenPos.x % layer.oSize.x);
+			iLayers[i * 4 + 1] = GLint(layer.oScreenPos.y % layer.oSize.y);
+			iLayers[i * 4 + 2] = GLint(layer.oSize.x);
+			iLayers[i * 4 + 3] = GLint(layer.oSize.y);
+			iSlices[i]         = layer.iSlice;
+		}
+
+		const auto &rect = oFrame.oDrawRect;
+
+		glViewport(0, 0, oFrame.oClientSize.x, oFrame.oClientSize.y);
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f); // black bars
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		m_oGL.glUseProgram(m_iProgram);
+		m_oGL.glUniform1i (m_iUniLayerCount, GLint(iLayerCount));
+		m_oGL.glUniform4iv(m_iUniLayers, GLsizei(iMaxLayers), iLayers);
+		m_oGL.glUniform1iv(m_iUniSlices, GLsizei(iMaxLayers), iSlices);
+		m_oGL.glUniform3f (m_iUniBackground,
+			oFrame.pxBackground.rgba.r / 255.0f,
+			oFrame.pxBackground.rgba.g / 255.0f,
+			oFrame.pxBackground.rgba.b / 255.0f
+		);
+		m_oGL.glUniform2i (m_iUniScreenSize,
+			GLint(oFrame.oScreenSize.x), GLint(oFrame.oScreenSize.y));
+		m_oGL.glUniform2f (m_iUniDrawOrigin,
+			float(rect.iLeft), float(oFrame.oClientSize.y) - rect.iTop);
+		m_oGL.glUniform2f (m_iUniDrawScale,
+			float(rect.iRight  - rect.iLeft) / oFrame.oScreenSize.x,
+			float(rect.iBottom - rect.iTop)  / oFrame.oScreenSize.y
+		);
+		m_oGL.glUniform1f (m_iUniPixelSize, float(oFrame.iPixelSize));
+
+		bindTextureArray();
+
+		// the drawing area, in normalized device coordinates
+		const float fLeft   = 2.0f * rect.iLeft   / oFrame.oClientSize.x - 1.0f;
+		const float fRight  = 2.0f * rect.iRight  / oFrame.oClientSize.x - 1.0f;
+		const float fTop    = 1.0f - 2.0f * rect.iTop    / oFrame.oClientSize.y;
+		const float fBottom = 1.0f - 2.0f * rect.iBottom / oFrame.oClientSize.y;
+
+		glBegin(GL_TRIANGLE_STRIP);
+		{
+			glVertex2f(fLeft,  fBottom);
+			glVertex2f(fLeft,  fTop);
+			glVertex2f(fRight, fBottom);
+			glVertex2f(fRight, fTop);
+		}
+		glEnd();
+
+		m_oGL.glUseProgram(0);
+	}
+
+	GLuint Compositor::compileShader(GLenum eType, const char *szSource)
+	{
+		const char *szSources[] = { "#version 130\n", szSource };
+
+		const GLuint iShader = m_oGL.glCreateShader(eType);
+		m_oGL.glShaderSource(iShader, 2, szSources, nullptr);
+		m_oGL.glCompileShader(iShader);
+
+		GLint iCompiled = GL_FALSE;
+		m_oGL.glGetShaderiv(iShader, GL_COMPILE_STATUS, &iCompiled);
+		if (iCompiled != GL_TRUE)
+		{
+			char szLog[1024] = {};
+			m_oGL.glGetShaderInfoLog(iShader, sizeof(szLog), nullptr, szLog);
+			fprintf(stderr, "Compositor shader failed to compile:\n%s\n", szLog);
+
+			m_oGL.glDeleteShader(iShader);
+			return 0;
+		}
+
+		return iShader;
+	}
+
+}
@@ -0,0 +1,93 @@
+#include "private/DirtyRects.hpp"
+#include <rlGameCanvas++/Bitmap.hpp>
+
+#include <algorithm> // std::min, std::max
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		size_t Area(const Rect &rect)
+		{
+			return (size_t)(rect.iRight - rect.iLeft) * (rect.iBottom - rect.iTop);
+		}
+
+		Rect BoundingBox(const Rect &a, const Rect &b)
+		{
+			return
+			{
+				/* iLeft   */ std::min(a.iLeft,   b.iLeft),
+				/* iTop    */ std::min(a.iTop,    b.iTop),
+				/* iRight  */ std::max(a.iRight,  b.iRight),
+				/* iBottom */ std::max(a.iBottom, b.iBottom)
+			};
+		}
+
+	}
+
+
+
+	bool AddDirtyRect(DirtyRects *poDirtyRects, const Rect &rect)
+	{
+		if (poDirtyRects == nullptr)
+			return false;
+
+		if (poDirtyRects->bAll || rect.iLeft >= rect.iRight || rect.iTop >= rect.iBottom)
+			return true; // nothing to do
+
+		if (poDirtyRects->iCount >= poDirtyRects->iCapacity)
+		{
+			// out of space --> just mark everything as changed
+			poDirtyRects->bAll = true;
+			return true;
+		}
+
+		poDirtyRects->poRects[poDirtyRects->iCount++] = rect;
+		return true;
+	}
+
+
+
+	bool ClipRect(Rect &rect, const Resolution &size)
+	{
+		rect.iRight  = std::min(rect.iRight,  size.x);
+		rect.iBottom = std::min(rect.iBottom, size.y);
+
+		return rect.iLeft < rect.iRight && rect.iTop < rect.iBottom;
+	}
+
+	void MergeDirtyRects(std::vector<Rect> &oRects, size_t iOverheadPixels)
+	{
+		// separate uploads: area(a) + area(b) + 2 * overhead
+		// bounding box:     area(a | b)       + 1 * overhead
+		bool bMerged;
+		do
+		{
+			bMerged = false;
+			for (size_t i = 0; i < oRects.size(); ++i)
+			{
+				for (size_t j = i + 1; j < oRects.size();)
+				{
+					const Rect rectMerged = BoundingBox(oRects[i], oRects[j]);
+					if (Area(rectMerged) > Area(oRects[i]) + Area(oRects[j]) + iOverheadPixels)
+					{
+						++j;
+						continue;
+					}
+
+					oRects[i] = rectMerged;
+					oRects[j] = oRects.back();
+					oRects.pop_back();
+					bMerged = true;
+
+					j = i + 1; // the merged rectangle might now be worth merging with others
+				}
+			}
+		} while (bMerged);
+	}
+
+}
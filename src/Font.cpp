@@ -0,0 +1,517 @@
+#include <rlGameCanvas++/Font.hpp>
+#include <rlGameCanvas++/Sprite.hpp>
+#include "private/PixelKernels.hpp" // Div255, BlendRow, BlendPremultipliedRow, PremultiplyRow
+
+#include <algorithm>     // std::fill, std::max
+#include <iterator>      // std::begin, std::end, std::size
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		constexpr UInt iReplacementChar = 0xFFFD;
+
+		// Decode the next code point of a UTF-8 string and move past it.
+		// Returns 0 at the end of the string. Invalid sequences are returned as U+FFFD.
+		UInt NextCodePoint(const uint8_t *&pText)
+		{
+			const uint8_t iLead = *pText;
+			if (iLead == 0)
+				return 0;
+			++pText;
+
+			if (iLead < 0x80)
+				return iLead;
+
+			UInt iCodePoint;
+			UInt iContinuationCount;
+			UInt iMin;
+			if ((iLead & 0xE0) == 0xC0)
+			{
+				iCodePoint         = iLead & 0x1F;
+				iContinuationCount = 1;
+				iMin               = 0x80;
+			}
+			else if ((iLead & 0xF0) == 0xE0)
+			{
+				iCodePoint         = iLead & 0x0F;
+				iContinuationCount = 2;
+				iMin               = 0x800;
+			}
+			else if ((iLead & 0xF8) == 0xF0)
+			{
+				iCodePoint         = iLead & 0x07;
+				iContinuationCount = 3;
+				iMin               = 0x10000;
+			}
+			else
+				return iReplacementChar; // stray continuation byte or invalid lead byte
+
+			for (UInt i = 0; i < iContinuationCount; ++i)
+			{
+				if ((*pText & 0xC0) != 0x80)
+					return iReplacementChar; // truncated --> the byte is the start of the next one
+				iCodePoint = (iCodePoint << 6) | (*pText++ & 0x3F);
+			}
+
+			// overlong encodings, surrogates and values beyond the Unicode range are invalid
+			if (iCodePoint < iMin || iCodePoint > 0x10FFFF ||
+				(iCodePoint >= 0xD800 && iCodePoint <= 0xDFFF))
+				return iReplacementChar;
+
+			return iCodePoint;
+		}
+
+		// Multiply a pixel with a color, channel by channel.
+		PixelInt TintPixel(PixelInt px, PixelInt pxColor)
+		{
+			PixelInt pxResult = 0;
+			for (UInt iShift = 0; iShift < 32; iShift += 8)
+			{
+				const uint32_t iChannel =
+					Div255(((px >> iShift) & 0xFF) * ((pxColor >> iShift) & 0xFF));
+				pxResult |= iChannel << iShift;
+			}
+			return pxResult;
+		}
+
+	}
+
+
+
+	class Font::PIMPL final
+	{
+	private: // types
+
+		// A run of consecutive visible pixels within a row of a glyph.
+		struct Run
+		{
+			UInt   iX;
+			UInt   iY;
+			UInt   iLength;
+			size_t iDataOffset; // index of the first pixel in m_oPixels
+		};
+
+		struct CompiledGlyph
+		{
+			Resolution oSize;
+			UInt       iAdvance;
+			size_t     iFirstRun; // runs iFirstRun to iEndRun - 1 of m_oRuns
+			size_t     iEndRun;
+		};
+
+		struct CacheKey
+		{
+			std::string sText;
+			PixelInt    pxColor;
+			bool        bPremultiplied;
+
+			bool operator==(const CacheKey &other) const
+			{
+				return pxColor == other.pxColor && bPremultiplied == other.bPremultiplied &&
+					sText == other.sText;
+			}
+		};
+
+		struct CacheKeyHash
+		{
+			size_t operator()(const CacheKey &key) const
+			{
+				return std::hash<std::string>()(key.sText) ^
+					(std::hash<PixelInt>()(key.pxColor) * 31) ^ size_t(key.bPremultiplied);
+			}
+		};
+
+		struct CacheEntry
+		{
+			CacheKey key;
+			Sprite   oSprite;
+		};
+
+
+	private: // static variables
+
+		static constexpr size_t iNoGlyph = ~size_t(0);
+
+
+	public: // methods
+
+		PIMPL(const Bitmap &bmp, const Resolution &oCellSize, UInt iFirstCodePoint,
+			UInt iCacheSize)
+			:
+			m_iLineHeight(oCellSize.y), m_iCacheSize(iCacheSize)
+		{
+			std::fill(std::begin(m_iASCII), std::end(m_iASCII), iNoGlyph);
+
+			if (bmp.ppxData == nullptr || oCellSize.x == 0 || oCellSize.y == 0)
+				return;
+
+			const UInt iColumns = bmp.size.x / oCellSize.x;
+			const UInt iRows    = bmp.size.y / oCellSize.y;
+			if ((uint64_t)iFirstCodePoint + (uint64_t)iColumns * iRows > 0x110000)
+				return;
+
+			for (UInt iRow = 0; iRow < iRows; ++iRow)
+			{
+				for (UInt iColumn = 0; iColumn < iColumns; ++iColumn)
+				{
+					const Rect rect =
+					{
+						/* iLeft   */ iColumn * oCellSize.x,
+						/* iTop    */ iRow    * oCellSize.y,
+						/* iRight  */ (iColumn + 1) * oCellSize.x,
+						/* iBottom */ (iRow    + 1) * oCellSize.y
+					};
+					addGlyph(bmp, iFirstCodePoint + iRow * iColumns + iColumn, rect, oCellSize.x);
+				}
+			}
+
+			finishGlyphs();
+		}
+
+		PIMPL(const Bitmap &bmp, const Glyph *pcoGlyphs, UInt iGlyphCount, UInt iLineHeight,
+			UInt iCacheSize)
+			:
+			m_iLineHeight(iLineHeight), m_iCacheSize(iCacheSize)
+		{
+			std::fill(std::begin(m_iASCII), std::end(m_iASCII), iNoGlyph);
+
+			if ((bmp.ppxData == nullptr && bmp.size.x * bmp.size.y > 0) ||
+				(pcoGlyphs == nullptr && iGlyphCount > 0))
+				return;
+
+			for (UInt i = 0; i < iGlyphCount; ++i)
+			{
+				const auto &glyph = pcoGlyphs[i];
+				if (glyph.rect.iLeft > glyph.rect.iRight  || glyph.rect.iRight  > bmp.size.x ||
+					glyph.rect.iTop  > glyph.rect.iBottom || glyph.rect.iBottom > bmp.size.y)
+					return;
+
+				addGlyph(bmp, glyph.iCodePoint, glyph.rect, glyph.iAdvance);
+			}
+
+			finishGlyphs();
+		}
+
+		bool valid() const { return m_bValid; }
+
+		UInt lineHeight() const { return m_iLineHeight; }
+
+		UInt cacheSize() const { return m_iCacheSize; }
+
+		UInt cachedTextCount() const { return UInt(m_oCache.size()); }
+
+		size_t renderCount() const { return m_iRenderCount; }
+
+		void clearCache()
+		{
+			m_oCacheIndex.clear();
+			m_oCache.clear();
+		}
+
+		Resolution measure(const U8Char *szText) const
+		{
+			Resolution oSize = {};
+			if (szText == nullptr)
+				return oSize;
+
+			UInt iPenX = 0;
+			UInt iPenY = 0;
+			oSize.y = m_iLineHeight;
+			const uint8_t *pText = reinterpret_cast<const uint8_t *>(szText);
+			for (UInt iCodePoint = NextCodePoint(pText); iCodePoint != 0;
+				iCodePoint = NextCodePoint(pText))
+			{
+				if (iCodePoint == '\n')
+				{
+					iPenX    = 0;
+					iPenY   += m_iLineHeight;
+					oSize.y  = std::max(oSize.y, iPenY + m_iLineHeight);
+					continue;
+				}
+
+				const size_t iGlyph = findGlyph(iCodePoint);
+				if (iGlyph == iNoGlyph)
+					continue;
+
+				const auto &glyph = m_oGlyphs[iGlyph];
+				oSize.x = std::max(oSize.x, iPenX + std::max(glyph.iAdvance, glyph.oSize.x));
+				oSize.y = std::max(oSize.y, iPenY + glyph.oSize.y);
+				iPenX  += glyph.iAdvance;
+			}
+
+			return oSize;
+		}
+
+		bool draw(Bitmap *poBase, const U8Char *szText, Pixel pxColor, Int iX, Int iY,
+			BitmapOverlayStrategy eOverlayStrategy, DirtyRects *poDirtyRects)
+		{
+			const bool bPremultiplied =
+				eOverlayStrategy == BitmapOverlayStrategy::BlendPremultiplied;
+
+			if (m_iCacheSize == 0)
+			{
+				++m_iRenderCount;
+				const Sprite oSprite = render(szText, pxColor, bPremultiplied);
+				return ApplySpriteOverlay(poBase, oSprite, iX, iY, eOverlayStrategy,
+					poDirtyRects);
+			}
+
+			CacheKey key = { reinterpret_cast<const char *>(szText), pxColor, bPremultiplied };
+
+			auto it = m_oCacheIndex.find(key);
+			if (it != m_oCacheIndex.end())
+				m_oCache.splice(m_oCache.begin(), m_oCache, it->second); // most recently used
+			else
+			{
+				++m_iRenderCount;
+				Sprite oSprite = render(szText, pxColor, bPremultiplied);
+				m_oCache.push_front({ std::move(key), std::move(oSprite) });
+				m_oCacheIndex.emplace(m_oCache.front().key, m_oCache.begin());
+
+				if (m_oCache.size() > m_iCacheSize)
+				{
+					m_oCacheIndex.erase(m_oCache.back().key);
+					m_oCache.pop_back();
+				}
+			}
+
+			return ApplySpriteOverlay(poBase, m_oCache.front().oSprite, iX, iY,
+				eOverlayStrategy, poDirtyRects);
+		}
+
+
+	private: // methods
+
+		// Compile the visible pixels of an area of bmp.
+		void addGlyph(const Bitmap &bmp, UInt iCodePoint, const Rect &rect, UInt iAdvance)
+		{
+			CompiledGlyph glyph;
+			glyph.oSize     = { rect.iRight - rect.iLeft, rect.iBottom - rect.iTop };
+			glyph.iAdvance  = iAdvance;
+			glyph.iFirstRun = m_oRuns.size();
+
+			for (UInt iY = 0; iY < glyph.oSize.y; ++iY)
+			{
+				const PixelInt *pRow =
+					bmp.ppxData + ((size_t)(rect.iTop + iY) * bmp.size.x + rect.iLeft);
+				for (UInt iX = 0; iX < glyph.oSize.x;)
+				{
+					if ((pRow[iX] >> 24) == 0)
+					{
+						++iX;
+						continue;
+					}
+
+					const UInt iStart = iX;
+					while (iX < glyph.oSize.x && (pRow[iX] >> 24) != 0)
+					{
+						++iX;
+					}
+					m_oRuns.push_back({ iStart, iY, iX - iStart, m_oPixels.size() });
+					m_oPixels.insert(m_oPixels.end(), pRow + iStart, pRow + iX);
+				}
+			}
+			glyph.iEndRun = m_oRuns.size();
+
+			// later glyphs for the same code point replace earlier ones
+			if (iCodePoint < std::size(m_iASCII))
+				m_iASCII[iCodePoint] = m_oGlyphs.size();
+			else
+				m_oGlyphIndices[iCodePoint] = m_oGlyphs.size();
+			m_oGlyphs.push_back(glyph);
+		}
+
+		void finishGlyphs()
+		{
+			m_iFallbackGlyph = findGlyph('?');
+
+			m_oGlyphs.shrink_to_fit();
+			m_oRuns.shrink_to_fit();
+			m_oPixels.shrink_to_fit();
+			m_bValid = true;
+		}
+
+		size_t findGlyph(UInt iCodePoint) const
+		{
+			if (iCodePoint < std::size(m_iASCII))
+			{
+				if (m_iASCII[iCodePoint] != iNoGlyph)
+					return m_iASCII[iCodePoint];
+			}
+			else
+			{
+				auto it = m_oGlyphIndices.find(iCodePoint);
+				if (it != m_oGlyphIndices.end())
+					return it->second;
+			}
+
+			return m_iFallbackGlyph;
+		}
+
+		// Draw a text into a new bitmap with the tinted glyphs and compile it to a sprite.
+		// Where glyphs overlap, the later one is blended on top of the earlier ones.
+		Sprite render(const U8Char *szText, Pixel pxColor, bool bPremultiplied) const
+		{
+			const Resolution oSize = measure(szText);
+
+			// premultiplied glyphs are tinted with a premultiplied color
+			PixelInt pxTint = pxColor.val;
+			if (bPremultiplied)
+				PremultiplyRow(&pxTint, 1);
+
+			std::vector<PixelInt> oPixels((size_t)oSize.x * oSize.y, 0);
+			std::vector<PixelInt> oTinted; // the current run
+			UInt iPenX = 0;
+			UInt iPenY = 0;
+			const uint8_t *pText = reinterpret_cast<const uint8_t *>(szText);
+			for (UInt iCodePoint = NextCodePoint(pText); iCodePoint != 0;
+				iCodePoint = NextCodePoint(pText))
+			{
+				if (iCodePoint == '\n')
+				{
+					iPenX  = 0;
+					iPenY += m_iLineHeight;
+					continue;
+				}
+
+				const size_t iGlyph = findGlyph(iCodePoint);
+				if (iGlyph == iNoGlyph)
+					continue;
+
+				const auto &glyph = m_oGlyphs[iGlyph];
+				for (size_t iRun = glyph.iFirstRun; iRun < glyph.iEndRun; ++iRun)
+				{
+					const auto &run = m_oRuns[iRun];
+
+					const PixelInt *pSrc  = m_oPixels.data() + run.iDataOffset;
+					PixelInt       *pDest = oPixels.data() +
+						((size_t)(iPenY + run.iY) * oSize.x + iPenX + run.iX);
+					oTinted.resize(run.iLength);
+					for (UInt i = 0; i < run.iLength; ++i)
+					{
+						oTinted[i] = TintPixel(pSrc[i], pxTint);
+					}
+
+					if (bPremultiplied)
+						BlendPremultipliedRow(pDest, oTinted.data(), run.iLength);
+					else
+						BlendRow(pDest, oTinted.data(), run.iLength);
+				}
+				iPenX += glyph.iAdvance;
+			}
+
+			return Sprite({ oPixels.data(), oSize });
+		}
+
+
+	private: // variables
+
+		bool       m_bValid = false;
+		const UInt m_iLineHeight;
+		const UInt m_iCacheSize;
+
+		std::vector<CompiledGlyph>       m_oGlyphs;
+		std::vector<Run>                 m_oRuns;
+		std::vector<PixelInt>            m_oPixels;   // pixel data of all runs
+		size_t                           m_iASCII[128]; // glyph indices of code points 0-127
+		std::unordered_map<UInt, size_t> m_oGlyphIndices; // all code points beyond ASCII
+		size_t                           m_iFallbackGlyph = iNoGlyph;
+
+		// most recently used first
+		std::list<CacheEntry> m_oCache;
+		std::unordered_map<CacheKey, std::list<CacheEntry>::iterator, CacheKeyHash> m_oCacheIndex;
+		size_t m_iRenderCount = 0; // cache misses
+
+	};
+
+
+
+	Font::Font(const Bitmap &bmp, const Resolution &oCellSize, UInt iFirstCodePoint,
+		UInt iCacheSize)
+		:
+		m_pPIMPL(new PIMPL(bmp, oCellSize, iFirstCodePoint, iCacheSize))
+	{}
+
+	Font::Font(const Bitmap &bmp, const Glyph *pcoGlyphs, UInt iGlyphCount, UInt iLineHeight,
+		UInt iCacheSize)
+		:
+		m_pPIMPL(new PIMPL(bmp, pcoGlyphs, iGlyphCount, iLineHeight, iCacheSize))
+	{}
+
+	Font::Font(Font &&rval) noexcept : m_pPIMPL(rval.m_pPIMPL)
+	{
+		rval.m_pPIMPL = nullptr;
+	}
+
+	Font::~Font() { delete m_pPIMPL; }
+
+	Font &Font::operator=(Font &&rval) noexcept
+	{
+		if (&rval == this)
+			return *this;
+
+		delete m_pPIMPL;
+		m_pPIMPL      = rval.m_pPIMPL;
+		rval.m_pPIMPL = nullptr;
+
+		return *this;
+	}
+
+	bool Font::valid() const { return m_pPIMPL != nullptr && m_pPIMPL->valid(); }
+
+	UInt Font::lineHeight() const { return m_pPIMPL ? m_pPIMPL->lineHeight() : 0; }
+
+	UInt Font::cacheSize() const { return m_pPIMPL ? m_pPIMPL->cacheSize() : 0; }
+
+	UInt Font::cachedTextCount() const { return m_pPIMPL ? m_pPIMPL->cachedTextCount() : 0; }
+
+	size_t Font::renderCount() const { return m_pPIMPL ? m_pPIMPL->renderCount() : 0; }
+
+	void Font::clearCache()
+	{
+		if (m_pPIMPL != nullptr)
+			m_pPIMPL->clearCache();
+	}
+
+
+
+	Resolution MeasureText(const Font &oFont, const U8Char *szText)
+	{
+		if (!oFont.valid())
+			return {};
+
+		return oFont.m_pPIMPL->measure(szText);
+	}
+
+	bool ApplyTextOverlay(
+		Bitmap               *poBase,
+		Font                 &oFont,
+		const U8Char         *szText,
+		Pixel                 pxColor,
+		Int                   iX,
+		Int                   iY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || szText == nullptr || !oFont.valid())
+			return false;
+
+		if (eOverlayStrategy != BitmapOverlayStrategy::Blend &&
+			eOverlayStrategy != BitmapOverlayStrategy::BlendPremultiplied)
+			return false;
+
+		return oFont.m_pPIMPL->draw(poBase, szText, pxColor, iX, iY, eOverlayStrategy,
+			poDirtyRects);
+	}
+
+}
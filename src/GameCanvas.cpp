@@ -24,4 +24,9 @@ namespace rlGameCanvasLib
 
 	void GameCanvas::quit() { m_pPIMPL->quit(); }
 
+	UploadStatistics GameCanvas::getUploadStatistics() const
+	{
+		return m_pPIMPL->getUploadStatistics();
+	}
+
 }
\ No newline at end of file
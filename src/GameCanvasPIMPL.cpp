@@ -220,10 +220,16 @@ namespace rlGameCanvasLib
 		m_fnOnWinMsg           (config.fnOnWinMsg),
 		m_oModes               (config.iModeCount), // set values later
 		m_bPreferPixelPerfect  (config.iFlags & RL_GAMECANVAS_SUP_PREFER_PIXELPERFECT),
+		m_bPremultipliedAlpha  (config.iFlags & RL_GAMECANVAS_SUP_PREMULTIPLIED_ALPHA),
+		m_bDirtyRects          (config.iFlags & RL_GAMECANVAS_SUP_DIRTY_RECTS        ),
+		m_bSoftwareCompositing (config.iFlags & RL_GAMECANVAS_SUP_SOFTWARE_COMPOSITING),
+		m_oArenaAllocator      ({ config.fnAllocate, config.fnFree,
+			(config.iFlags & RL_GAMECANVAS_SUP_LARGE_PAGES) != 0 }),
 		m_bRestrictCursor      (config.iFlags & RL_GAMECANVAS_SUP_RESTRICT_CURSOR    ),
 		m_bHideCursor          (config.iFlags & RL_GAMECANVAS_SUP_HIDE_CURSOR        ),
 		m_bMaximized           (config.iFlags & RL_GAMECANVAS_SUP_MAXIMIZED          ),
-		m_bFullscreen          (config.iFlags & RL_GAMECANVAS_SUP_FULLSCREEN         )
+		m_bFullscreen          (config.iFlags & RL_GAMECANVAS_SUP_FULLSCREEN         ),
+		m_oGraphicsDataCache   (config.iModeCacheSize)
 	{
 		// check if the configuration is valid
 		bool bValidConfig =
@@ -232,6 +238,7 @@ namespace rlGameCanvasLib
 			m_fnDestroyState != nullptr &&
 			m_fnUpdateState  != nullptr &&
 			m_fnDrawState    != nullptr &&
+			(config.fnAllocate != nullptr) == (config.fnFree != nullptr) &&
 			!m_oModes.empty();
 
 		if (bValidConfig)
@@ -249,6 +256,7 @@ namespace rlGameCanvasLib
 
 				output.oScreenSize = input.oScreenSize;
 				output.oLayerMetadata.reserve(input.iLayerCount);
+				output.oTilesets     .reserve(input.iLayerCount);
 				for (size_t iLayer = 0; iLayer < input.iLayerCount; ++iLayer)
 				{
 					const auto &layer = input.pcoLayerMetadata[iLayer];
@@ -273,6 +281,51 @@ namespace rlGameCanvasLib
 						bValidConfig = false;
 						break;
 					}
+
+					// check if the layer format is known
+					if (layer.iFormat != RL_GAMECANVAS_LAY_FORMAT_RGBA &&
+						layer.iFormat != RL_GAMECANVAS_LAY_FORMAT_INDEXED8 &&
+						layer.iFormat != RL_GAMECANVAS_LAY_FORMAT_TILEMAP)
+					{
+						bValidConfig = false;
+						break;
+					}
+
+					// check if the layer flags are known and supported by the format
+					constexpr UInt iRGBAFlags =
+						RL_GAMECANVAS_LAY_DETECT_CHANGES | RL_GAMECANVAS_LAY_ALIGNED_ROWS;
+					if ((layer.iFlags & ~iRGBAFlags) ||
+						((layer.iFlags & iRGBAFlags) &&
+							layer.iFormat != RL_GAMECANVAS_LAY_FORMAT_RGBA))
+					{
+						bValidConfig = false;
+						break;
+					}
+
+					output.oTilesets.emplace_back();
+					if (layer.iFormat == RL_GAMECANVAS_LAY_FORMAT_TILEMAP)
+					{
+						const auto &oTileSize  = layer.oTileSize;
+						const auto  pcoTileset = layer.pcoTileset;
+
+						// check if the tilemap is valid
+						if (oTileSize.x == 0 || oTileSize.y == 0 ||
+							oLayerSize.x % oTileSize.x != 0 || oLayerSize.y % oTileSize.y != 0 ||
+							pcoTileset == nullptr || pcoTileset->ppxData == nullptr ||
+							pcoTileset->size.x < oTileSize.x || pcoTileset->size.y < oTileSize.y)
+						{
+							bValidConfig = false;
+							break;
+						}
+
+						auto &oTileset = output.oTilesets.back();
+						oTileset.oSize     = pcoTileset->size;
+						oTileset.oTileSize = oTileSize;
+						oTileset.oPixels.assign(pcoTileset->ppxData,
+							pcoTileset->ppxData + (size_t)pcoTileset->size.x * pcoTileset->size.y);
+					}
+					// the tileset doesn't have to outlive the canvas --> only use the copy
+					output.oLayerMetadata.back().pcoTileset = nullptr;
 				}
 
 				if (!bValidConfig)
@@ -482,7 +535,10 @@ namespace rlGameCanvasLib
 
 					glEnable(GL_TEXTURE_2D);
 					glEnable(GL_BLEND);
-					glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+					if (m_bPremultipliedAlpha)
+						glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+					else
+						glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 				}
 				catch (...)
 				{
@@ -502,9 +558,24 @@ namespace rlGameCanvasLib
 
 			m_upOpenGL = std::make_unique<OpenGL>();
 			m_bFBO     = m_upOpenGL->glGenFramebuffers;
+			if (m_upOpenGL->supportsPixelBuffers())
+				m_upPixelBufferAPI = std::make_unique<OpenGLPixelBufferAPI>(*m_upOpenGL);
+			if (m_bSoftwareCompositing)
+				m_upSoftwareCompositor = std::make_unique<SoftwareCompositor>(m_bPremultipliedAlpha);
+			else
+			{
+				m_upCompositor = std::make_unique<Compositor>(*m_upOpenGL, m_bPremultipliedAlpha);
+				if (!m_upCompositor->valid())
+					m_upCompositor.reset(); // not supported or shader didn't compile --> old paths
+			}
 #ifndef NDEBUG
 			printf("> OpenGL Version String: \"%s\"\n", m_upOpenGL->versionStr().c_str());
 			printf("> OpenGL framebuffers available: %s\n", m_bFBO ? "Yes" : "No");
+			printf("> OpenGL pixel buffers available: %s\n", m_upPixelBufferAPI ? "Yes" : "No");
+			printf("> OpenGL shader compositor available: %s\n", m_upCompositor ? "Yes" : "No");
+			if (m_upSoftwareCompositor)
+				printf("> Software compositing with %zu threads\n",
+					m_upSoftwareCompositor->threadCount());
 #endif // NDEBUG
 
 			if (m_bFBO)
@@ -610,6 +681,10 @@ namespace rlGameCanvasLib
 
 		m_upOpenGL.release();
 		m_oGraphicsData.destroy();
+		m_oGraphicsDataCache.clear();
+		m_upPixelBufferAPI.reset();
+		m_upCompositor.reset();
+		m_upSoftwareCompositor.reset();
 		wglMakeCurrent(NULL, NULL);
 		wglDeleteContext(m_hOpenGL);
 
@@ -629,6 +704,12 @@ namespace rlGameCanvasLib
 		PostMessageW(m_hWnd, WM_CLOSE, 0, 0);
 	}
 
+	UploadStatistics GameCanvas::PIMPL::getUploadStatistics() const
+	{
+		std::unique_lock lock(m_muxStatistics);
+		return m_oStatistics;
+	}
+
 	void GameCanvas::PIMPL::initializeCurrentMode()
 	{
 		createGraphicsData();
@@ -644,7 +725,26 @@ namespace rlGameCanvasLib
 	{
 		const auto &mode = m_oModes[m_iCurrentMode];
 
-		m_oGraphicsData.create(mode); // todo: error handling
+		// look up the new mode first, so it isn't dropped to make room for the previous one
+		auto up_oCached = m_oGraphicsDataCache.take(m_iCurrentMode);
+
+		if (m_oGraphicsDataCache.budget() > 0 && !m_oGraphicsData.empty())
+		{
+			auto up_oPrevious = std::make_unique<GraphicsData>();
+			up_oPrevious->swapModeData(m_oGraphicsData);
+			m_oGraphicsDataCache.put(m_iGraphicsDataMode, std::move(up_oPrevious));
+		}
+
+		m_bRestoredMode = false;
+		if (up_oCached)
+		{
+			m_oGraphicsData.swapModeData(*up_oCached);
+			m_bRestoredMode = m_oGraphicsData.restore();
+		}
+		if (!m_bRestoredMode)
+			m_oGraphicsData.create(mode, m_upPixelBufferAPI.get(), m_upCompositor.get(),
+				m_upSoftwareCompositor.get(), m_oArenaAllocator); // todo: error handling
+		m_iGraphicsDataMode = m_iCurrentMode;
 
 		const size_t iLayerCount = mode.oLayerMetadata.size();
 
@@ -658,8 +758,23 @@ namespace rlGameCanvasLib
 			const auto &oLayerSpecs = mode.oLayerMetadata[iLayer];
 			auto &oLayerSettings    = m_oLayerSettings[iLayer];
 
-			oLayerSettings.bVisible   = oLayerSpecs.bHide == 0;
-			oLayerSettings.oScreenPos = oLayerSpecs.oScreenPos;
+			if (m_bRestoredMode)
+			{
+				oLayerSettings.bVisible   = m_oGraphicsData.isVisible(iLayer);
+				oLayerSettings.oScreenPos = m_oGraphicsData.getScreenPos(iLayer);
+			}
+			else
+			{
+				oLayerSettings.bVisible   = oLayerSpecs.bHide == 0;
+				oLayerSettings.oScreenPos = oLayerSpecs.oScreenPos;
+			}
+			oLayerSettings.oDirtyRects =
+			{
+				/* poRects   */ oLayerSettings.oDirtyRectStorage,
+				/* iCapacity */ iMaxDirtyRectsPerFrame,
+				/* iCount    */ 0,
+				/* bAll      */ false
+			};
 
 			m_oLayersForCallback[iLayer] =
 			{
@@ -670,7 +785,21 @@ namespace rlGameCanvasLib
 					/* size */ oLayerSpecs.oLayerSize,
 				},
 				/* poScreenPos */ &oLayerSettings.oScreenPos,
-				/* pbVisible   */ &oLayerSettings.bVisible
+				/* pbVisible   */ &oLayerSettings.bVisible,
+				/* bmpIndexed */
+				{
+					/* piData */ m_oGraphicsData.indexedScanline(iLayer, 0),
+					/* size   */ oLayerSpecs.oLayerSize,
+				},
+				/* ppxPalette */
+					reinterpret_cast<rlGameCanvas_Pixel*>(m_oGraphicsData.palette(iLayer)),
+				/* tilemap */
+				{
+					/* piTiles */ m_oGraphicsData.tiles(iLayer),
+					/* size    */ m_oGraphicsData.tilemapSize(iLayer),
+				},
+				/* poDirtyRects */ &oLayerSettings.oDirtyRects,
+				/* iStride      */ m_oGraphicsData.stride(iLayer)
 			};
 		}
 	}
@@ -1200,17 +1329,26 @@ namespace rlGameCanvasLib
 		}
 
 		// update the canvas
+		auto &mode = m_oModes[m_iCurrentMode];
+
+		// persistently mapped layers write to a different part of their buffer on every frame
+		for (size_t iLayer = 0; iLayer < mode.oLayerMetadata.size(); ++iLayer)
+		{
+			m_oLayersForCallback[iLayer].bmp.ppxData =
+				reinterpret_cast<rlGameCanvas_Pixel *>(m_oGraphicsData.scanline(iLayer, 0));
+		}
+
 		memcpy_s(
 			m_oLayersForCallback_Copy.get(), m_iLayersForCallback_Size,
 			m_oLayersForCallback     .get(), m_iLayersForCallback_Size
 		);
-		auto &mode = m_oModes[m_iCurrentMode];
 
 		UInt iDrawFlags = 0;
 		if (m_bNewMode)
 		{
 			m_bNewMode = false;
-			iDrawFlags |= RL_GAMECANVAS_DRW_NEWMODE;
+			iDrawFlags |=
+				m_bRestoredMode ? RL_GAMECANVAS_DRW_RESTOREDMODE : RL_GAMECANVAS_DRW_NEWMODE;
 		}
 
 		m_fnDrawState(
@@ -1239,6 +1377,20 @@ namespace rlGameCanvasLib
 			m_oLayerSettings[iLayer].oScreenPos = newPos;
 		}
 
+		// pass the changed areas on to the layers
+		for (size_t iLayer = 0; iLayer < mode.oLayerMetadata.size(); ++iLayer)
+		{
+			auto &oDirtyRects = m_oLayerSettings[iLayer].oDirtyRects;
+
+			if (!m_bDirtyRects || oDirtyRects.bAll)
+				m_oGraphicsData.markAllDirty(iLayer);
+			else
+				m_oGraphicsData.markDirty(iLayer, oDirtyRects.poRects, oDirtyRects.iCount);
+
+			oDirtyRects.iCount = 0;
+			oDirtyRects.bAll   = false;
+		}
+
 		m_pxBackground = RLGAMECANVAS_MAKEPIXELOPAQUE(m_pxBackground);
 
 		glClearColor(
@@ -1249,8 +1401,26 @@ namespace rlGameCanvasLib
 		);
 
 
+		// flatten the layers on the CPU, only the result is drawn below
+		if (m_upSoftwareCompositor)
+			m_oGraphicsData.compose(m_pxBackground);
+
+		// single pass via shader
+		if (m_oGraphicsData.composited())
+		{
+			const Compositor::FrameParams oFrame =
+			{
+				/* oScreenSize  */ mode.oScreenSize,
+				/* oClientSize  */ m_oClientSize,
+				/* oDrawRect    */ m_oDrawRect,
+				/* iPixelSize   */ m_iPixelSize,
+				/* pxBackground */ m_pxBackground
+			};
+			m_oGraphicsData.draw_Composited(oFrame);
+		}
+
 		// use FBO
-		if (m_bFBO)
+		else if (m_bFBO)
 		{
 			auto &gl = *m_upOpenGL;
 
@@ -1344,6 +1514,11 @@ namespace rlGameCanvasLib
 			m_oGraphicsData.draw_Legacy(m_oDrawRect);
 		}
 
+		{
+			std::unique_lock lock(m_muxStatistics);
+			m_oStatistics = m_oGraphicsData.statistics();
+		}
+
 
 
 		SwapBuffers(m_hDC);
@@ -1,36 +1,277 @@
 #include "private/GraphicsData.hpp"
+#include <rlGameCanvas/Definitions.h>
+#include "private/DirtyRects.hpp"   // ClipRect, MergeDirtyRects
+#include "private/PixelKernels.hpp" // ExpandIndexedRow, DiffRowBlocks
 #include "include-thirdparty/gl/glext.h"
 
+#include <algorithm> // std::max, std::min, std::fill
 #include <cassert>
+#include <utility>   // std::swap
 
 
 
 
 
-GraphicsData::Layer::Layer(const Layer &other) :
+namespace
+{
+
+	// The number of pixels expanded from an indexed layer before they're uploaded.
+	// Small enough for the staging rows to stay in the cache.
+	constexpr size_t iExpandPixels = 16384;
+
+	// The estimated cost of a single glTexSubImage2D call, in pixels.
+	// Dirty rectangles are merged when uploading their bounding box is cheaper.
+	constexpr size_t iUploadOverheadPixels = 1024;
+
+	// If more dirty rectangles are collected, the whole layer is uploaded instead.
+	constexpr size_t iMaxDirtyRects = 256;
+
+	// The number of pixel buffers per layer.
+	// While the CPU writes to one of them, the GPU can still read the previous ones.
+	constexpr size_t iPixelBufferCount = 3;
+
+	// The height of the tiles compared by the change detection.
+	// The width is one cache line (lib::iDiffBlockPixels).
+	constexpr GLsizei iDiffTileRows = 16;
+
+	using Format = GraphicsData::LayerFormat;
+
+	// The tileset of all non-tilemap layers that aren't part of a mode.
+	const lib::Tileset oNoTileset = {};
+
+	Format GetLayerFormat(const lib::LayerMetadata &oSetup)
+	{
+		switch (oSetup.iFormat)
+		{
+		case RL_GAMECANVAS_LAY_FORMAT_INDEXED8:
+			return Format::Indexed8;
+		case RL_GAMECANVAS_LAY_FORMAT_TILEMAP:
+			return Format::Tilemap;
+		default:
+			return Format::RGBA;
+		}
+	}
+
+	// Get the number of rows that are staged at once.
+	GLsizei GetStagingRows(Format eFormat, GLsizei iWidth, GLsizei iHeight,
+		const lib::Resolution &oTileSize)
+	{
+		switch (eFormat)
+		{
+		case Format::Indexed8:
+			return std::max<GLsizei>(1,
+				std::min<GLsizei>(iHeight, GLsizei(iExpandPixels / iWidth)));
+		case Format::Tilemap:
+			return GLsizei(oTileSize.y); // a single row of tiles
+		default:
+			return 0;
+		}
+	}
+
+	lib::Resolution GetTilemapSize(Format eFormat, GLsizei iWidth, GLsizei iHeight,
+		const lib::Resolution &oTileSize)
+	{
+		if (eFormat != Format::Tilemap)
+			return {};
+
+		return { lib::UInt(iWidth) / oTileSize.x, lib::UInt(iHeight) / oTileSize.y };
+	}
+
+	bool DetectsChanges(Format eFormat, const lib::LayerMetadata &oSetup)
+	{
+		return eFormat == Format::RGBA && (oSetup.iFlags & RL_GAMECANVAS_LAY_DETECT_CHANGES);
+	}
+
+	// Get the distance between two rows of an RGBA layer, in pixels.
+	GLsizei GetStride(Format eFormat, GLsizei iWidth, const lib::LayerMetadata &oSetup)
+	{
+		if (eFormat != Format::RGBA || !(oSetup.iFlags & RL_GAMECANVAS_LAY_ALIGNED_ROWS))
+			return iWidth;
+
+		constexpr GLsizei iAlignmentPixels = GLsizei(lib::Arena::iAlignment / sizeof(lib::Pixel));
+		return (iWidth + iAlignmentPixels - 1) / iAlignmentPixels * iAlignmentPixels;
+	}
+
+	size_t GetDiffBlocksPerRow(GLsizei iWidth)
+	{
+		return (iWidth + lib::iDiffBlockPixels - 1) / lib::iDiffBlockPixels;
+	}
+
+	std::unique_ptr<lib::PersistentPixelBuffer> MakeMappedData(lib::PixelBufferAPI *pAPI,
+		Format eFormat, GLsizei iWidth, GLsizei iHeight)
+	{
+		if (pAPI == nullptr || eFormat != Format::RGBA || !pAPI->supportsPersistentMapping())
+			return nullptr;
+
+		auto up_oBuffer = std::make_unique<lib::PersistentPixelBuffer>(*pAPI,
+			(size_t)iWidth * iHeight * sizeof(lib::PixelInt), iPixelBufferCount);
+		if (!up_oBuffer->valid())
+			return nullptr;
+
+		return up_oBuffer;
+	}
+
+	std::unique_ptr<lib::PixelBufferRing> MakePixelBufferRing(lib::PixelBufferAPI *pAPI,
+		Format eFormat, GLsizei iWidth, GLsizei iHeight)
+	{
+		if (pAPI == nullptr || eFormat == Format::Tilemap)
+			return nullptr;
+
+		return std::make_unique<lib::PixelBufferRing>(*pAPI,
+			(size_t)iWidth * iHeight * sizeof(lib::PixelInt), iPixelBufferCount);
+	}
+
+}
+
+
+
+
+
+GraphicsData::Layer::Layer(const lib::LayerMetadata &oSetup, const lib::Tileset &oTileset,
+	const lib::Resolution &oScreenSize, lib::PixelBufferAPI *pPixelBufferAPI,
+	lib::Compositor *pCompositor, GLint iSlice)
+	:
+	m_pCompositor(pCompositor),
+	m_iSlice(iSlice),
+	m_iWidth (GLsizei(oSetup.oLayerSize.x)),
+	m_iHeight(GLsizei(oSetup.oLayerSize.y)),
+	m_oScreenSize(oScreenSize),
+	m_eFormat(GetLayerFormat(oSetup)),
+	m_bDetectChanges(DetectsChanges(m_eFormat, oSetup)),
+	m_iStride(GetStride(m_eFormat, m_iWidth, oSetup)),
+	m_up_oMappedData(MakeMappedData(pPixelBufferAPI, m_eFormat, m_iStride, m_iHeight)),
+	m_oTileset(oTileset),
+	m_oMapSize(GetTilemapSize(m_eFormat, m_iWidth, m_iHeight, oTileset.oTileSize)),
+	m_iTilesetColumns  (m_eFormat == Format::Tilemap ?
+		oTileset.oSize.x / oTileset.oTileSize.x : 0),
+	m_iTilesetTileCount(m_eFormat == Format::Tilemap ?
+		m_iTilesetColumns * (oTileset.oSize.y / oTileset.oTileSize.y) : 0),
+	m_iStagingRows(GetStagingRows(m_eFormat, m_iWidth, m_iHeight, oTileset.oTileSize)),
+	m_up_oPixelBuffers(MakePixelBufferRing(m_up_oMappedData ? nullptr : pPixelBufferAPI,
+		m_eFormat, m_iWidth, m_iHeight))
+{
+	setScreenPos(oSetup.oScreenPos);
+	initPixelPointer();
+}
+
+GraphicsData::Layer::Layer(Layer &&other) noexcept :
+	m_iTextureID (std::exchange(other.m_iTextureID, 0)),
+	m_pCompositor(other.m_pCompositor),
+	m_iSlice     (other.m_iSlice),
+	m_bUploaded  (other.m_bUploaded),
 	m_iWidth     (other.m_iWidth),
 	m_iHeight    (other.m_iHeight),
 	m_oScreenSize(other.m_oScreenSize),
-	m_up_pxData  (std::make_unique<lib::Pixel[]>(m_iWidth * m_iHeight)),
+	m_eFormat    (other.m_eFormat),
+	m_bDetectChanges(other.m_bDetectChanges),
+	m_iStride       (other.m_iStride),
+	m_up_oMappedData(std::move(other.m_up_oMappedData)),
+	m_pxHeapData     (other.m_pxHeapData),
+	m_pxData         (other.m_pxData),
+	m_piIndexData    (other.m_piIndexData),
+	m_pxPalette      (other.m_pxPalette),
+	m_pxShadow       (other.m_pxShadow),
+	m_pbChangedBlocks(other.m_pbChangedBlocks),
+	m_oTileset         (other.m_oTileset),
+	m_oMapSize         (other.m_oMapSize),
+	m_iTilesetColumns  (other.m_iTilesetColumns),
+	m_iTilesetTileCount(other.m_iTilesetTileCount),
+	m_piTiles          (other.m_piTiles),
+	m_piUploadedTiles  (other.m_piUploadedTiles),
+	m_bTilesUploaded   (other.m_bTilesUploaded),
+	m_iStagingRows(other.m_iStagingRows),
+	m_pxStaging   (other.m_pxStaging),
+	m_up_oPixelBuffers(std::move(other.m_up_oPixelBuffers)),
+	m_oDirtyRects(std::move(other.m_oDirtyRects)),
+	m_bAllDirty  (other.m_bAllDirty),
 	m_oScreenPos (other.m_oScreenPos),
 	m_fTexLeft   (other.m_fTexLeft),
 	m_fTexTop    (other.m_fTexTop),
 	m_fTexRight  (other.m_fTexRight),
 	m_fTexBottom (other.m_fTexBottom)
 {
-	const size_t iDataSize = (size_t)m_iWidth * m_iHeight * sizeof(lib::Pixel);
-	memcpy_s(m_up_pxData.get(), iDataSize, other.m_up_pxData.get(), iDataSize);
+	for (size_t i = 0; i < lib::PersistentPixelBuffer::iMaxFrameCount; ++i)
+	{
+		m_oMissingRects[i] = std::move(other.m_oMissingRects[i]);
+		m_bMissingAll[i]   = other.m_bMissingAll[i];
+	}
 }
 
-GraphicsData::Layer::Layer(GLsizei iWidth, GLsizei iHeight, const lib::Resolution &oScreenPos,
-	const lib::Resolution &oScreenSize)
-	:
-	m_iWidth (iWidth ),
-	m_iHeight(iHeight),
-	m_oScreenSize(oScreenSize),
-	m_up_pxData(std::make_unique<lib::Pixel[]>(iWidth * iHeight))
+GraphicsData::Layer::BufferSizes GraphicsData::Layer::bufferSizes() const
+{
+	const size_t iPixelCount = (size_t)m_iWidth * m_iHeight;
+	const size_t iRGBASize   = (size_t)m_iStride * m_iHeight * sizeof(lib::Pixel);
+	const bool   bRGBA       = m_eFormat == Format::RGBA;
+	const bool   bIndexed    = m_eFormat == Format::Indexed8;
+
+	BufferSizes oSizes = {};
+	oSizes.iPixels        = bRGBA && !m_up_oMappedData ? iRGBASize : 0;
+	oSizes.iIndexData     = bIndexed ? iPixelCount : 0;
+	oSizes.iPalette       = bIndexed ? 256 * sizeof(lib::Pixel) : 0;
+	oSizes.iShadow        = m_bDetectChanges ? iRGBASize : 0;
+	oSizes.iChangedBlocks = m_bDetectChanges ? GetDiffBlocksPerRow(m_iWidth) * sizeof(bool) : 0;
+	oSizes.iTiles         = (size_t)m_oMapSize.x * m_oMapSize.y * sizeof(lib::TileIndex);
+	oSizes.iStaging       = (size_t)m_iWidth * m_iStagingRows * sizeof(lib::Pixel);
+	return oSizes;
+}
+
+size_t GraphicsData::Layer::memorySize() const
 {
-	setScreenPos(oScreenPos);
+	const auto oSizes = bufferSizes();
+	return
+		lib::Arena::AlignSize(oSizes.iPixels) +
+		lib::Arena::AlignSize(oSizes.iIndexData) +
+		lib::Arena::AlignSize(oSizes.iPalette) +
+		lib::Arena::AlignSize(oSizes.iShadow) +
+		lib::Arena::AlignSize(oSizes.iChangedBlocks) +
+		lib::Arena::AlignSize(oSizes.iTiles) * 2 +
+		lib::Arena::AlignSize(oSizes.iStaging);
+}
+
+void GraphicsData::Layer::assignMemory(uint8_t *pMemory)
+{
+	const auto oSizes = bufferSizes();
+
+	// unused buffers stay nullptr
+	const auto fnTake = [&](size_t iSize) -> void *
+	{
+		if (iSize == 0)
+			return nullptr;
+
+		void *pResult = pMemory;
+		pMemory += lib::Arena::AlignSize(iSize);
+		return pResult;
+	};
+
+	m_pxHeapData      = static_cast<lib::Pixel *>    (fnTake(oSizes.iPixels));
+	m_piIndexData     = static_cast<uint8_t *>       (fnTake(oSizes.iIndexData));
+	m_pxPalette       = static_cast<lib::Pixel *>    (fnTake(oSizes.iPalette));
+	m_pxShadow        = static_cast<lib::Pixel *>    (fnTake(oSizes.iShadow));
+	m_pbChangedBlocks = static_cast<bool *>          (fnTake(oSizes.iChangedBlocks));
+	m_piTiles         = static_cast<lib::TileIndex *>(fnTake(oSizes.iTiles));
+	m_piUploadedTiles = static_cast<lib::TileIndex *>(fnTake(oSizes.iTiles));
+	m_pxStaging       = static_cast<lib::Pixel *>    (fnTake(oSizes.iStaging));
+
+	if (m_up_oMappedData == nullptr)
+		m_pxData = m_pxHeapData;
+
+	if (m_eFormat == Format::Tilemap)
+		std::fill(m_piTiles, m_piTiles + (size_t)m_oMapSize.x * m_oMapSize.y,
+			lib::TileIndex(RL_GAMECANVAS_LAY_TILE_EMPTY));
+}
+
+void GraphicsData::Layer::initPixelPointer()
+{
+	if (m_up_oMappedData == nullptr)
+	{
+		m_pxData = m_pxHeapData; // nullptr until the memory is assigned
+		return;
+	}
+
+	// start with the same blank pixels in all frames
+	auto &oBuffer = *m_up_oMappedData;
+	memset(oBuffer.frameData(0), 0, oBuffer.frameSize() * oBuffer.frameCount());
+	m_pxData = static_cast<lib::Pixel *>(oBuffer.frameData(oBuffer.currentFrame()));
 }
 
 GraphicsData::Layer::~Layer()
@@ -41,21 +282,117 @@ GraphicsData::Layer::~Layer()
 
 void GraphicsData::Layer::setScreenPos(const lib::Resolution &oScreenPos)
 {
+	// the layer repeats infinitely --> only the position within the layer matters
 	m_oScreenPos =
 	{
-		/* x */ oScreenPos.x % m_oScreenSize.x,
-		/* y */ oScreenPos.y % m_oScreenSize.y
+		/* x */ oScreenPos.x % lib::UInt(m_iWidth),
+		/* y */ oScreenPos.y % lib::UInt(m_iHeight)
 	};
 
-	m_fTexLeft   =        (float(m_oScreenPos.x                  ) / m_iWidth );
-	m_fTexTop    = 1.0f - (float(m_oScreenPos.y                  ) / m_iHeight);
-	m_fTexRight  =        (float(m_oScreenPos.x + m_oScreenSize.x) / m_iWidth );
-	m_fTexBottom = 1.0f - (float(m_oScreenPos.y + m_oScreenSize.y) / m_iHeight);
+	// the texture is drawn upside down --> the top texture coordinate is used for the bottom of
+	// the screen
+	m_fTexLeft   = float(m_oScreenPos.x                  ) / m_iWidth;
+	m_fTexTop    = float(m_oScreenPos.y + m_oScreenSize.y) / m_iHeight;
+	m_fTexRight  = float(m_oScreenPos.x + m_oScreenSize.x) / m_iWidth;
+	m_fTexBottom = float(m_oScreenPos.y                  ) / m_iHeight;
+}
+
+lib::SoftwareCompositor::Layer GraphicsData::Layer::softwareLayer() const
+{
+	lib::SoftwareCompositor::GetRowFunc fnGetRow = nullptr;
+	switch (m_eFormat)
+	{
+	case Format::RGBA:
+		fnGetRow = GetRowRGBA;
+		break;
+	case Format::Indexed8:
+		fnGetRow = GetRowIndexed;
+		break;
+	case Format::Tilemap:
+		fnGetRow = GetRowTilemap;
+		break;
+	}
+
+	return { { lib::UInt(m_iWidth), lib::UInt(m_iHeight) }, m_oScreenPos, fnGetRow, this };
+}
+
+void GraphicsData::Layer::invalidateTexture()
+{
+	m_bUploaded      = false;
+	m_bTilesUploaded = false;
+}
+
+size_t GraphicsData::Layer::memoryUsage() const
+{
+	size_t iSize = memorySize();
+	if (m_up_oMappedData)
+		iSize += m_up_oMappedData->frameSize() * m_up_oMappedData->frameCount();
+	if (m_up_oPixelBuffers)
+		iSize += m_up_oPixelBuffers->bufferSize() * m_up_oPixelBuffers->bufferCount();
+
+	// slices of the compositor's texture array don't belong to the layer
+	if (!m_pCompositor)
+		iSize += (size_t)m_iWidth * m_iHeight * sizeof(lib::PixelInt);
+
+	return iSize;
+}
+
+const lib::PixelInt *GraphicsData::Layer::GetRowRGBA(const void *pvLayer, lib::UInt iX,
+	lib::UInt iY, lib::UInt /* iCount */, lib::PixelInt * /* pBuffer */)
+{
+	const auto &layer = *static_cast<const Layer *>(pvLayer);
+
+	// no copy needed
+	return reinterpret_cast<const lib::PixelInt *>(layer.m_pxData) +
+		((size_t)iY * layer.m_iStride + iX);
+}
+
+const lib::PixelInt *GraphicsData::Layer::GetRowIndexed(const void *pvLayer, lib::UInt iX,
+	lib::UInt iY, lib::UInt iCount, lib::PixelInt *pBuffer)
+{
+	const auto &layer = *static_cast<const Layer *>(pvLayer);
+
+	lib::ExpandIndexedRow(pBuffer,
+		layer.m_piIndexData + ((size_t)iY * layer.m_iWidth + iX),
+		reinterpret_cast<const uint32_t *>(layer.m_pxPalette), iCount);
+	return pBuffer;
 }
 
-void GraphicsData::Layer::drawFilling()
+const lib::PixelInt *GraphicsData::Layer::GetRowTilemap(const void *pvLayer, lib::UInt iX,
+	lib::UInt iY, lib::UInt iCount, lib::PixelInt *pBuffer)
 {
-	upload();
+	const auto &layer = *static_cast<const Layer *>(pvLayer);
+
+	const lib::UInt iTileWidth  = layer.m_oTileset.oTileSize.x;
+	const lib::UInt iTileHeight = layer.m_oTileset.oTileSize.y;
+	const lib::UInt iTileY      = iY / iTileHeight;
+
+	const lib::TileIndex *pTiles = layer.m_piTiles + (size_t)iTileY * layer.m_oMapSize.x;
+	const size_t iTilesetRowOffset = (size_t)(iY % iTileHeight) * layer.m_oTileset.oSize.x;
+
+	lib::PixelInt *pDest = pBuffer;
+	for (lib::UInt iEnd = iX + iCount; iX < iEnd;)
+	{
+		const lib::UInt iOffsetX    = iX % iTileWidth;
+		const lib::UInt iPixelCount = std::min(iTileWidth - iOffsetX, iEnd - iX);
+
+		const lib::PixelInt *pSrc = layer.tilePixels(pTiles[iX / iTileWidth]);
+		if (pSrc)
+			memcpy_s(pDest, iPixelCount * sizeof(lib::PixelInt),
+				pSrc + iTilesetRowOffset + iOffsetX, iPixelCount * sizeof(lib::PixelInt));
+		else
+			std::fill(pDest, pDest + iPixelCount, lib::PixelInt(0));
+
+		pDest += iPixelCount;
+		iX    += iPixelCount;
+	}
+
+	return pBuffer;
+}
+
+void GraphicsData::Layer::drawFilling(lib::UploadStatistics &oStatistics)
+{
+	upload(oStatistics);
 
 	// draw texture (upside down)
 	glBegin(GL_TRIANGLE_STRIP);
@@ -86,9 +423,10 @@ void GraphicsData::Layer::drawFilling()
 	glEnd();
 }
 
-void GraphicsData::Layer::drawAtIntCoords(GLint iLeft, GLint iTop, GLint iRight, GLint iBottom)
+void GraphicsData::Layer::drawAtIntCoords(GLint iLeft, GLint iTop, GLint iRight, GLint iBottom,
+	lib::UploadStatistics &oStatistics)
 {
-	upload();
+	upload(oStatistics);
 
 	// draw texture (but upside down)
 	glBegin(GL_TRIANGLE_STRIP);
@@ -119,9 +457,11 @@ void GraphicsData::Layer::drawAtIntCoords(GLint iLeft, GLint iTop, GLint iRight,
 	glEnd();
 }
 
-void GraphicsData::Layer::upload()
+void GraphicsData::Layer::upload(lib::UploadStatistics &oStatistics)
 {
-	if (m_iTextureID == 0)
+	if (m_pCompositor)
+		m_pCompositor->bindTextureArray(); // allocated by the compositor
+	else if (m_iTextureID == 0)
 	{
 		glGenTextures(1, &m_iTextureID);
 
@@ -135,28 +475,502 @@ void GraphicsData::Layer::upload()
 
 		glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
 
+		// only allocate the texture, the data is uploaded below
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_iWidth, m_iHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-			m_up_pxData.get());
+			nullptr);
 	}
 	else
-	{
 		glBindTexture(GL_TEXTURE_2D, m_iTextureID);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_iWidth, m_iHeight, GL_RGBA, GL_UNSIGNED_BYTE,
-			m_up_pxData.get());
+
+	// first upload --> everything
+	if (!m_bUploaded)
+	{
+		if (m_pxShadow)
+		{
+			const size_t iDataSize = (size_t)m_iStride * m_iHeight * sizeof(lib::Pixel);
+			memcpy_s(m_pxShadow, iDataSize, m_pxData, iDataSize);
+		}
+		m_bAllDirty = true;
+		m_bUploaded = true;
+	}
+
+	switch (m_eFormat)
+	{
+	case Format::RGBA:
+		if (m_pxShadow && !m_bAllDirty)
+		{
+			detectChanges(oStatistics);
+
+			const uint64_t iUploadedBefore = oStatistics.iUploadedPixels;
+			uploadRGBA(oStatistics);
+			oStatistics.iSkippedPixels += (uint64_t)m_iWidth * m_iHeight -
+				(oStatistics.iUploadedPixels - iUploadedBefore);
+		}
+		else
+			uploadRGBA(oStatistics);
+		break;
+	case Format::Indexed8:
+		uploadIndexed(oStatistics);
+		break;
+	case Format::Tilemap:
+		uploadTilemap(oStatistics);
+		break;
+	}
+
+	m_oDirtyRects.clear();
+	m_bAllDirty = false;
+}
+
+void GraphicsData::Layer::texSubImage(lib::UploadStatistics &oStatistics, GLint iX, GLint iY,
+	GLsizei iWidth, GLsizei iHeight, const void *pData)
+{
+	if (m_pCompositor)
+		m_pCompositor->texSubImage(m_iSlice, iX, iY, iWidth, iHeight, pData);
+	else
+		glTexSubImage2D(GL_TEXTURE_2D, 0, iX, iY, iWidth, iHeight,
+			GL_RGBA, GL_UNSIGNED_BYTE, pData);
+	oStatistics.iUploadedPixels += (uint64_t)iWidth * iHeight;
+}
+
+template <typename TCopyRow>
+bool GraphicsData::Layer::uploadStreamed(lib::UploadStatistics &oStatistics, TCopyRow fnCopyRow)
+{
+	// the rectangles are packed tightly, so they must fit into a single buffer
+	size_t iTotalSize = 0;
+	for (const auto &rect : m_oDirtyRects)
+	{
+		iTotalSize += (size_t)(rect.iRight - rect.iLeft) * (rect.iBottom - rect.iTop);
+	}
+	iTotalSize *= sizeof(uint32_t);
+	if (iTotalSize > m_up_oPixelBuffers->bufferSize())
+		return false; // the rectangles overlap a lot --> rare, not worth a bigger buffer
+
+	auto pBuffer = static_cast<uint32_t *>(m_up_oPixelBuffers->map());
+	if (pBuffer == nullptr)
+		return false;
+
+	// write all rectangles to the buffer first, so the GPU can start reading it right away
+	uint32_t *pDest = pBuffer;
+	for (const auto &rect : m_oDirtyRects)
+	{
+		for (lib::UInt iY = rect.iTop; iY < rect.iBottom; ++iY, pDest += rect.iRight - rect.iLeft)
+		{
+			fnCopyRow(pDest, rect, iY);
+		}
+	}
+	if (!m_up_oPixelBuffers->unmap())
+		return false;
+
+	// the "pointers" are byte offsets into the bound pixel buffer
+	size_t iOffset = 0;
+	for (const auto &rect : m_oDirtyRects)
+	{
+		const GLsizei iWidth  = GLsizei(rect.iRight  - rect.iLeft);
+		const GLsizei iHeight = GLsizei(rect.iBottom - rect.iTop);
+
+		texSubImage(oStatistics, GLint(rect.iLeft), GLint(rect.iTop), iWidth, iHeight,
+			reinterpret_cast<const void *>(iOffset));
+		iOffset += (size_t)iWidth * iHeight * sizeof(uint32_t);
+	}
+	m_up_oPixelBuffers->submit();
+
+	return true;
+}
+
+void GraphicsData::Layer::markDirty(const lib::Rect *pcoRects, size_t iCount)
+{
+	if (m_bAllDirty || m_eFormat == Format::Tilemap || m_pxShadow)
+		return;
+
+	const lib::Resolution oSize = { lib::UInt(m_iWidth), lib::UInt(m_iHeight) };
+	for (size_t i = 0; i < iCount; ++i)
+	{
+		lib::Rect rect = pcoRects[i];
+		if (lib::ClipRect(rect, oSize))
+			m_oDirtyRects.push_back(rect);
+	}
+
+	if (m_oDirtyRects.size() > iMaxDirtyRects)
+	{
+		m_oDirtyRects.clear();
+		m_bAllDirty = true;
+	}
+}
+
+void GraphicsData::Layer::markAllDirty()
+{
+	if (m_pxShadow)
+		return;
+
+	m_oDirtyRects.clear();
+	m_bAllDirty = true;
+}
+
+void GraphicsData::Layer::uploadRGBA(lib::UploadStatistics &oStatistics)
+{
+	if (m_bAllDirty)
+		m_oDirtyRects = { { 0, 0, lib::UInt(m_iWidth), lib::UInt(m_iHeight) } };
+	else if (m_oDirtyRects.empty())
+		return; // nothing changed
+	else
+		lib::MergeDirtyRects(m_oDirtyRects, iUploadOverheadPixels);
+
+	if (m_up_oMappedData)
+	{
+		uploadMapped(oStatistics);
+		return;
+	}
+
+	const bool bStreamed = m_up_oPixelBuffers && uploadStreamed(oStatistics,
+		[&](uint32_t *pDest, const lib::Rect &rect, lib::UInt iY)
+		{
+			const size_t iRowSize = (size_t)(rect.iRight - rect.iLeft) * sizeof(uint32_t);
+			memcpy_s(pDest, iRowSize,
+				m_pxData + ((size_t)iY * m_iStride + rect.iLeft), iRowSize);
+		}
+	);
+	if (bStreamed)
+		return;
+
+	// fallback: upload the rectangles directly from the layer data
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, m_iStride);
+	for (const auto &rect : m_oDirtyRects)
+	{
+		texSubImage(oStatistics, GLint(rect.iLeft), GLint(rect.iTop),
+			GLsizei(rect.iRight - rect.iLeft), GLsizei(rect.iBottom - rect.iTop),
+			m_pxData + ((size_t)rect.iTop * m_iStride + rect.iLeft));
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+}
+
+void GraphicsData::Layer::uploadMapped(lib::UploadStatistics &oStatistics)
+{
+	auto &oBuffer = *m_up_oMappedData;
+	const size_t iFrame = oBuffer.currentFrame();
+
+	// upload directly from the buffer, the "pointers" are byte offsets
+	oBuffer.bind();
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, m_iStride);
+	for (const auto &rect : m_oDirtyRects)
+	{
+		const size_t iOffset = oBuffer.frameOffset(iFrame) +
+			((size_t)rect.iTop * m_iStride + rect.iLeft) * sizeof(lib::PixelInt);
+		texSubImage(oStatistics, GLint(rect.iLeft), GLint(rect.iTop),
+			GLsizei(rect.iRight - rect.iLeft), GLsizei(rect.iBottom - rect.iTop),
+			reinterpret_cast<const void *>(iOffset));
+	}
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	oBuffer.unbind();
+
+	// the other frames are missing the changes of this frame
+	for (size_t i = 0; i < oBuffer.frameCount(); ++i)
+	{
+		if (i == iFrame || m_bMissingAll[i])
+			continue;
+
+		auto &oMissing = m_oMissingRects[i];
+		if (m_bAllDirty || oMissing.size() + m_oDirtyRects.size() > iMaxDirtyRects)
+		{
+			oMissing.clear();
+			m_bMissingAll[i] = true;
+		}
+		else
+			oMissing.insert(oMissing.end(), m_oDirtyRects.begin(), m_oDirtyRects.end());
+	}
+
+	// the GPU might still read this frame --> continue with the next one
+	oBuffer.advance();
+
+	// bring the next frame up to date
+	const size_t iNext = oBuffer.currentFrame();
+	const auto pSrc  = static_cast<const lib::Pixel *>(oBuffer.frameData(iFrame));
+	const auto pDest = static_cast<lib::Pixel *>(oBuffer.frameData(iNext));
+	if (m_bMissingAll[iNext])
+		memcpy_s(pDest, oBuffer.frameSize(), pSrc, oBuffer.frameSize());
+	else
+	{
+		// overlapping areas would be copied multiple times
+		lib::MergeDirtyRects(m_oMissingRects[iNext], 0);
+
+		for (const auto &rect : m_oMissingRects[iNext])
+		{
+			const size_t iRowSize = (size_t)(rect.iRight - rect.iLeft) * sizeof(lib::Pixel);
+			for (lib::UInt iY = rect.iTop; iY < rect.iBottom; ++iY)
+			{
+				const size_t iOffset = (size_t)iY * m_iStride + rect.iLeft;
+				memcpy_s(pDest + iOffset, iRowSize, pSrc + iOffset, iRowSize);
+			}
+		}
+	}
+	m_oMissingRects[iNext].clear();
+	m_bMissingAll[iNext] = false;
+
+	m_pxData = pDest;
+}
+
+void GraphicsData::Layer::uploadIndexed(lib::UploadStatistics &oStatistics)
+{
+	if (m_bAllDirty)
+		m_oDirtyRects = { { 0, 0, lib::UInt(m_iWidth), lib::UInt(m_iHeight) } };
+	else if (m_oDirtyRects.empty())
+		return; // nothing changed
+	else
+		lib::MergeDirtyRects(m_oDirtyRects, iUploadOverheadPixels);
+
+	// expand the indices directly into the pixel buffer
+	const auto pPalette = reinterpret_cast<const uint32_t *>(m_pxPalette);
+	const bool bStreamed = m_up_oPixelBuffers && uploadStreamed(oStatistics,
+		[&](uint32_t *pDest, const lib::Rect &rect, lib::UInt iY)
+		{
+			lib::ExpandIndexedRow(pDest,
+				m_piIndexData + ((size_t)iY * m_iWidth + rect.iLeft), pPalette,
+				rect.iRight - rect.iLeft);
+		}
+	);
+	if (bStreamed)
+		return;
+
+	// fallback: expand the indices via the staging area
+	for (const auto &rect : m_oDirtyRects)
+	{
+		uploadIndexedRect(rect, oStatistics);
+	}
+}
+
+void GraphicsData::Layer::uploadIndexedRect(const lib::Rect &rect,
+	lib::UploadStatistics &oStatistics)
+{
+	const GLsizei iWidth = GLsizei(rect.iRight - rect.iLeft);
+	const GLsizei iBandRows =
+		std::max<GLsizei>(1, GLsizei((size_t)m_iWidth * m_iStagingRows / iWidth));
+
+	// expand the indices with the current palette, one band of rows at a time
+	const auto pPalette = reinterpret_cast<const uint32_t *>(m_pxPalette);
+	const auto pStaging = reinterpret_cast<uint32_t *>(m_pxStaging);
+	for (GLsizei iTop = GLsizei(rect.iTop); iTop < GLsizei(rect.iBottom); iTop += iBandRows)
+	{
+		const GLsizei iRows = std::min(iBandRows, GLsizei(rect.iBottom) - iTop);
+
+		for (GLsizei iRow = 0; iRow < iRows; ++iRow)
+		{
+			lib::ExpandIndexedRow(pStaging + (size_t)iRow * iWidth,
+				m_piIndexData + ((size_t)(iTop + iRow) * m_iWidth + rect.iLeft),
+				pPalette, iWidth);
+		}
+		texSubImage(oStatistics, GLint(rect.iLeft), iTop, iWidth, iRows, pStaging);
+	}
+}
+
+void GraphicsData::Layer::uploadTilemap(lib::UploadStatistics &oStatistics)
+{
+	const lib::UInt iTileWidth  = m_oTileset.oTileSize.x;
+	const lib::UInt iTileHeight = m_oTileset.oTileSize.y;
+	const size_t    iRowSize    = m_oMapSize.x * sizeof(lib::TileIndex);
+
+	// if many tiles of a row changed, one upload of the whole row is cheaper than many small ones
+	const lib::UInt iMinChangedForRowUpload = std::max<lib::UInt>(4, m_oMapSize.x / 4);
+
+	auto pStaging = reinterpret_cast<lib::PixelInt *>(m_pxStaging);
+
+	for (lib::UInt iTileY = 0; iTileY < m_oMapSize.y; ++iTileY)
+	{
+		const lib::TileIndex *pTiles         = m_piTiles + (size_t)iTileY * m_oMapSize.x;
+		lib::TileIndex       *pUploadedTiles =
+			m_piUploadedTiles + (size_t)iTileY * m_oMapSize.x;
+
+		lib::UInt iChanged = m_oMapSize.x;
+		if (m_bTilesUploaded)
+		{
+			if (memcmp(pTiles, pUploadedTiles, iRowSize) == 0)
+				continue; // nothing changed
+
+			iChanged = 0;
+			for (lib::UInt iTileX = 0; iTileX < m_oMapSize.x; ++iTileX)
+			{
+				if (pTiles[iTileX] != pUploadedTiles[iTileX])
+					++iChanged;
+			}
+		}
+
+		const GLint iTop = GLint(iTileY * iTileHeight);
+
+		if (!m_bTilesUploaded || iChanged >= iMinChangedForRowUpload)
+		{
+			// rasterize the whole row of tiles
+			for (lib::UInt iTileX = 0; iTileX < m_oMapSize.x; ++iTileX)
+			{
+				const lib::PixelInt *pSrc  = tilePixels(pTiles[iTileX]);
+				lib::PixelInt       *pDest = pStaging + (size_t)iTileX * iTileWidth;
+				for (lib::UInt iY = 0; iY < iTileHeight; ++iY, pDest += m_iWidth)
+				{
+					if (pSrc)
+					{
+						memcpy_s(pDest, iTileWidth * sizeof(lib::PixelInt),
+							pSrc, iTileWidth * sizeof(lib::PixelInt));
+						pSrc += m_oTileset.oSize.x;
+					}
+					else
+						std::fill(pDest, pDest + iTileWidth, lib::PixelInt(0));
+				}
+			}
+			texSubImage(oStatistics, 0, iTop, m_iWidth, GLsizei(iTileHeight), pStaging);
+		}
+		else
+		{
+			// upload the changed tiles directly from the tileset
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, GLint(m_oTileset.oSize.x));
+			for (lib::UInt iTileX = 0; iTileX < m_oMapSize.x; ++iTileX)
+			{
+				if (pTiles[iTileX] == pUploadedTiles[iTileX])
+					continue;
+
+				const lib::PixelInt *pSrc = tilePixels(pTiles[iTileX]);
+				if (pSrc == nullptr)
+				{
+					// transparent tile --> use a cleared part of the staging area
+					std::fill(pStaging, pStaging + (size_t)iTileWidth * iTileHeight,
+						lib::PixelInt(0));
+					glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+					texSubImage(oStatistics, GLint(iTileX * iTileWidth), iTop,
+						GLsizei(iTileWidth), GLsizei(iTileHeight), pStaging);
+					glPixelStorei(GL_UNPACK_ROW_LENGTH, GLint(m_oTileset.oSize.x));
+				}
+				else
+					texSubImage(oStatistics, GLint(iTileX * iTileWidth), iTop,
+						GLsizei(iTileWidth), GLsizei(iTileHeight), pSrc);
+			}
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		}
+
+		memcpy_s(pUploadedTiles, iRowSize, pTiles, iRowSize);
+	}
+
+	m_bTilesUploaded = true;
+}
+
+void GraphicsData::Layer::detectChanges(lib::UploadStatistics &oStatistics)
+{
+	const size_t iBlocksPerRow = GetDiffBlocksPerRow(m_iWidth);
+
+	const auto pData     = reinterpret_cast<const uint32_t *>(m_pxData);
+	const auto pShadow   = reinterpret_cast<uint32_t *>(m_pxShadow);
+	bool *const pbChanged = m_pbChangedBlocks;
+
+	m_oDirtyRects.clear();
+	m_bAllDirty = false;
+
+	for (GLsizei iTop = 0; iTop < m_iHeight; iTop += iDiffTileRows)
+	{
+		const GLsizei iBottom = std::min(iTop + iDiffTileRows, m_iHeight);
+
+		// compare a row of tiles
+		// the blocks that already changed in a previous row aren't read again
+		std::fill(pbChanged, pbChanged + iBlocksPerRow, false);
+		for (GLsizei iY = iTop; iY < iBottom; ++iY)
+		{
+			const size_t iOffset = (size_t)iY * m_iStride;
+			lib::DiffRowBlocks(pData + iOffset, pShadow + iOffset, m_iWidth, pbChanged);
+		}
+		oStatistics.iComparedTiles += iBlocksPerRow;
+
+		// every run of changed tiles becomes a dirty rectangle
+		for (size_t iBlock = 0; iBlock < iBlocksPerRow;)
+		{
+			if (!pbChanged[iBlock])
+			{
+				++iBlock;
+				continue;
+			}
+
+			const size_t iFirstBlock = iBlock;
+			while (iBlock < iBlocksPerRow && pbChanged[iBlock])
+			{
+				++iBlock;
+			}
+			oStatistics.iChangedTiles += iBlock - iFirstBlock;
+
+			const lib::Rect rect =
+			{
+				/* iLeft   */ lib::UInt(iFirstBlock * lib::iDiffBlockPixels),
+				/* iTop    */ lib::UInt(iTop),
+				/* iRight  */ lib::UInt(std::min(iBlock * lib::iDiffBlockPixels, size_t(m_iWidth))),
+				/* iBottom */ lib::UInt(iBottom)
+			};
+			if (!m_bAllDirty)
+				m_oDirtyRects.push_back(rect);
+
+			// the tiles will be in the texture after the upload
+			const size_t iRowSize = (size_t)(rect.iRight - rect.iLeft) * sizeof(uint32_t);
+			for (GLsizei iY = iTop; iY < iBottom; ++iY)
+			{
+				const size_t iOffset = (size_t)iY * m_iStride + rect.iLeft;
+				memcpy_s(pShadow + iOffset, iRowSize, pData + iOffset, iRowSize);
+			}
+		}
+
+		if (m_oDirtyRects.size() > iMaxDirtyRects)
+		{
+			m_oDirtyRects.clear();
+			m_bAllDirty = true;
+		}
 	}
 }
 
+const lib::PixelInt *GraphicsData::Layer::tilePixels(lib::TileIndex iTile) const
+{
+	if (iTile >= m_iTilesetTileCount)
+		return nullptr;
 
+	const size_t iX = (size_t)(iTile % m_iTilesetColumns) * m_oTileset.oTileSize.x;
+	const size_t iY = (size_t)(iTile / m_iTilesetColumns) * m_oTileset.oTileSize.y;
+	return m_oTileset.oPixels.data() + (iY * m_oTileset.oSize.x + iX);
+}
 
 
 
-bool GraphicsData::create(const lib::Mode_CPP &mode)
+
+
+bool GraphicsData::create(const lib::Mode_CPP &mode, lib::PixelBufferAPI *pPixelBufferAPI,
+	lib::Compositor *pCompositor, lib::SoftwareCompositor *pSoftwareCompositor,
+	const lib::ArenaAllocator &oAllocator)
 {
 	destroy();
 
 	if (mode.oLayerMetadata.empty() || mode.oScreenSize.x == 0 || mode.oScreenSize.y == 0)
 		return false;
 
+	m_oScreenSize = mode.oScreenSize;
+
+	if (pSoftwareCompositor)
+	{
+		m_pSoftwareCompositor = pSoftwareCompositor;
+		m_oSoftwareLayers.reserve(mode.oLayerMetadata.size());
+
+		lib::LayerMetadata oFrameSetup = {};
+		oFrameSetup.oLayerSize = mode.oScreenSize;
+		oFrameSetup.iFormat    = RL_GAMECANVAS_LAY_FORMAT_RGBA;
+
+		// the whole frame is rewritten every time, so a persistently mapped buffer would only
+		// cause extra copies between its frames --> upload from client memory
+		m_up_oFrame = std::make_unique<Layer>(oFrameSetup, oNoTileset, mode.oScreenSize,
+			nullptr, nullptr, 0);
+	}
+
+	// all layers share one texture array --> every slice must fit the biggest layer
+	else if (pCompositor && mode.oLayerMetadata.size() <= lib::Compositor::iMaxLayers)
+	{
+		lib::Resolution oMaxSize = {};
+		for (const auto &setup : mode.oLayerMetadata)
+		{
+			oMaxSize.x = std::max(oMaxSize.x, setup.oLayerSize.x);
+			oMaxSize.y = std::max(oMaxSize.y, setup.oLayerSize.y);
+		}
+
+		if (pCompositor->createTextureArray(GLsizei(oMaxSize.x), GLsizei(oMaxSize.y),
+			GLsizei(mode.oLayerMetadata.size())))
+			m_pCompositor = pCompositor;
+	}
+
 	m_oLayers .reserve(mode.oLayerMetadata.size());
 	m_oVisible.reserve(mode.oLayerMetadata.size());
 
@@ -175,12 +989,31 @@ bool GraphicsData::create(const lib::Mode_CPP &mode)
 		if (oLayerSize.y == 0)
 			oLayerSize.y = mode.oScreenSize.y;
 
-		m_oLayers.push_back(
-			Layer(setup.oLayerSize.x, setup.oLayerSize.y, setup.oScreenPos, mode.oScreenSize)
-		);
+		m_oLayers.emplace_back(setup, mode.oTilesets[i], mode.oScreenSize, pPixelBufferAPI,
+			m_pCompositor, GLint(i));
 		m_oVisible.push_back(!setup.bHide);
 	}
 
+	// carve all buffers from a single allocation
+	size_t iArenaSize = m_up_oFrame ? m_up_oFrame->memorySize() : 0;
+	for (const auto &layer : m_oLayers)
+	{
+		iArenaSize += layer.memorySize();
+	}
+	m_oArena.allocate(iArenaSize, oAllocator);
+
+	uint8_t *pMemory = m_oArena.data();
+	if (m_up_oFrame)
+	{
+		m_up_oFrame->assignMemory(pMemory);
+		pMemory += m_up_oFrame->memorySize();
+	}
+	for (auto &layer : m_oLayers)
+	{
+		layer.assignMemory(pMemory);
+		pMemory += layer.memorySize();
+	}
+
 	return true;
 }
 
@@ -188,19 +1021,116 @@ void GraphicsData::destroy()
 {
 	m_oLayers .clear();
 	m_oVisible.clear();
+	m_pCompositor = nullptr;
+
+	m_pSoftwareCompositor = nullptr;
+	m_up_oFrame.reset();
+	m_oSoftwareLayers.clear();
+
+	m_oArena.deallocate();
+}
+
+void GraphicsData::swapModeData(GraphicsData &other)
+{
+	std::swap(m_oArena,              other.m_oArena);
+	std::swap(m_oLayers,             other.m_oLayers);
+	std::swap(m_oVisible,            other.m_oVisible);
+	std::swap(m_pCompositor,         other.m_pCompositor);
+	std::swap(m_pSoftwareCompositor, other.m_pSoftwareCompositor);
+	std::swap(m_oScreenSize,         other.m_oScreenSize);
+	std::swap(m_up_oFrame,           other.m_up_oFrame);
+	std::swap(m_oSoftwareLayers,     other.m_oSoftwareLayers);
+}
+
+bool GraphicsData::restore()
+{
+	if (m_pCompositor == nullptr)
+		return true; // the layers' own textures are still up to date
+
+	lib::Resolution oMaxSize = {};
+	for (const auto &layer : m_oLayers)
+	{
+		oMaxSize.x = std::max(oMaxSize.x, lib::UInt(layer.width()));
+		oMaxSize.y = std::max(oMaxSize.y, lib::UInt(layer.height()));
+	}
+
+	if (!m_pCompositor->createTextureArray(GLsizei(oMaxSize.x), GLsizei(oMaxSize.y),
+		GLsizei(m_oLayers.size())))
+		return false;
+
+	for (auto &layer : m_oLayers)
+	{
+		layer.invalidateTexture();
+	}
+	return true;
+}
+
+size_t GraphicsData::memoryUsage() const
+{
+	size_t iSize = m_up_oFrame ? m_up_oFrame->memoryUsage() : 0;
+	for (const auto &layer : m_oLayers)
+	{
+		iSize += layer.memoryUsage();
+	}
+	return iSize;
+}
+
+void GraphicsData::compose(const lib::Pixel &pxBackground)
+{
+	m_oSoftwareLayers.clear();
+	for (size_t iLayer = 0; iLayer < m_oLayers.size(); ++iLayer)
+	{
+		if (m_oVisible[iLayer])
+			m_oSoftwareLayers.push_back(m_oLayers[iLayer].softwareLayer());
+	}
+
+	m_pSoftwareCompositor->compose(m_oScreenSize, m_oSoftwareLayers.data(),
+		m_oSoftwareLayers.size(), pxBackground,
+		reinterpret_cast<lib::PixelInt *>(m_up_oFrame->scanline(0)));
+	m_up_oFrame->markAllDirty();
 }
 
 void GraphicsData::draw()
 {
+	if (m_up_oFrame)
+	{
+		m_up_oFrame->drawFilling(m_oStatistics);
+		return;
+	}
+
 	for (size_t iLayer = 0; iLayer < m_oLayers.size(); ++iLayer)
 	{
 		if (m_oVisible[iLayer])
-			m_oLayers[iLayer].drawFilling();
+			m_oLayers[iLayer].drawFilling(m_oStatistics);
 	}
 }
 
+void GraphicsData::draw_Composited(const lib::Compositor::FrameParams &oFrame)
+{
+	lib::Compositor::LayerParams oParams[lib::Compositor::iMaxLayers];
+	size_t iCount = 0;
+
+	for (size_t iLayer = 0; iLayer < m_oLayers.size(); ++iLayer)
+	{
+		if (!m_oVisible[iLayer])
+			continue;
+
+		m_oLayers[iLayer].upload(m_oStatistics);
+		oParams[iCount++] = m_oLayers[iLayer].compositorParams();
+	}
+
+	m_pCompositor->draw(oFrame, oParams, iCount);
+}
+
 void GraphicsData::draw_Legacy(const lib::Rect &oDrawRect)
 {
+	if (m_up_oFrame)
+	{
+		m_up_oFrame->drawAtIntCoords(oDrawRect.iLeft, oDrawRect.iTop, oDrawRect.iRight,
+			oDrawRect.iBottom, m_oStatistics);
+		return;
+	}
+
 	for (size_t iLayer = 0; iLayer < m_oLayers.size(); ++iLayer)
 	{
 		if (m_oVisible[iLayer])
@@ -208,7 +1138,8 @@ void GraphicsData::draw_Legacy(const lib::Rect &oDrawRect)
 				oDrawRect.iLeft,
 				oDrawRect.iTop,
 				oDrawRect.iRight,
-				oDrawRect.iBottom
+				oDrawRect.iBottom,
+				m_oStatistics
 			);
 	}
 }
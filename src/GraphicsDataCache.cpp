@@ -0,0 +1,51 @@
+#include "private/GraphicsDataCache.hpp"
+
+
+
+namespace rlGameCanvasLib
+{
+
+	void GraphicsDataCache::put(UInt iMode, std::unique_ptr<::GraphicsData> &&up_oData)
+	{
+		take(iMode); // drop outdated data
+
+		if (!up_oData || up_oData->empty())
+			return;
+
+		const uint64_t iMemoryUsage = up_oData->memoryUsage();
+		if (iMemoryUsage > m_iBudget)
+			return;
+
+		while (m_iMemoryUsage + iMemoryUsage > m_iBudget)
+		{
+			m_iMemoryUsage -= m_oEntries.back().iMemoryUsage;
+			m_oEntries.pop_back();
+		}
+
+		m_oEntries.push_front({ iMode, iMemoryUsage, std::move(up_oData) });
+		m_iMemoryUsage += iMemoryUsage;
+	}
+
+	std::unique_ptr<::GraphicsData> GraphicsDataCache::take(UInt iMode)
+	{
+		for (auto it = m_oEntries.begin(); it != m_oEntries.end(); ++it)
+		{
+			if (it->iMode != iMode)
+				continue;
+
+			auto up_oData = std::move(it->up_oData);
+			m_iMemoryUsage -= it->iMemoryUsage;
+			m_oEntries.erase(it);
+			return up_oData;
+		}
+
+		return nullptr;
+	}
+
+	void GraphicsDataCache::clear()
+	{
+		m_oEntries.clear();
+		m_iMemoryUsage = 0;
+	}
+
+}
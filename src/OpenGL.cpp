@@ -1,5 +1,6 @@
 #include "private/OpenGL.hpp"
 #include <cstdlib>
+#include <cstring> // strlen, strstr
 
 namespace rlGameCanvasLib
 {
@@ -20,11 +21,194 @@ namespace rlGameCanvasLib
 			(PFNGLFRAMEBUFFERTEXTURE2DPROC)wglGetProcAddress(rlGLFUNC("glFramebufferTexture2D"))),
 		glCheckFramebufferStatus(
 			(PFNGLCHECKFRAMEBUFFERSTATUSPROC)wglGetProcAddress(
-				rlGLFUNC("glCheckFramebufferStatus")))
+				rlGLFUNC("glCheckFramebufferStatus"))),
+		// core functions since OpenGL 1.5/3.0/3.2 --> no suffix
+		glGenBuffers    ((PFNGLGENBUFFERSPROC    )wglGetProcAddress("glGenBuffers"    )),
+		glDeleteBuffers ((PFNGLDELETEBUFFERSPROC )wglGetProcAddress("glDeleteBuffers" )),
+		glBindBuffer    ((PFNGLBINDBUFFERPROC    )wglGetProcAddress("glBindBuffer"    )),
+		glBufferData    ((PFNGLBUFFERDATAPROC    )wglGetProcAddress("glBufferData"    )),
+		glMapBufferRange((PFNGLMAPBUFFERRANGEPROC)wglGetProcAddress("glMapBufferRange")),
+		glUnmapBuffer   ((PFNGLUNMAPBUFFERPROC   )wglGetProcAddress("glUnmapBuffer"   )),
+		glFenceSync     ((PFNGLFENCESYNCPROC     )wglGetProcAddress("glFenceSync"     )),
+		glClientWaitSync((PFNGLCLIENTWAITSYNCPROC)wglGetProcAddress("glClientWaitSync")),
+		glDeleteSync    ((PFNGLDELETESYNCPROC    )wglGetProcAddress("glDeleteSync"    )),
+		glBufferStorage ((PFNGLBUFFERSTORAGEPROC )wglGetProcAddress("glBufferStorage" )),
+		// core functions since OpenGL 1.2/2.0 --> no suffix
+		glCreateShader     ((PFNGLCREATESHADERPROC     )wglGetProcAddress("glCreateShader"     )),
+		glShaderSource     ((PFNGLSHADERSOURCEPROC     )wglGetProcAddress("glShaderSource"     )),
+		glCompileShader    ((PFNGLCOMPILESHADERPROC    )wglGetProcAddress("glCompileShader"    )),
+		glGetShaderiv      ((PFNGLGETSHADERIVPROC      )wglGetProcAddress("glGetShaderiv"      )),
+		glGetShaderInfoLog ((PFNGLGETSHADERINFOLOGPROC )wglGetProcAddress("glGetShaderInfoLog" )),
+		glDeleteShader     ((PFNGLDELETESHADERPROC     )wglGetProcAddress("glDeleteShader"     )),
+		glCreateProgram    ((PFNGLCREATEPROGRAMPROC    )wglGetProcAddress("glCreateProgram"    )),
+		glAttachShader     ((PFNGLATTACHSHADERPROC     )wglGetProcAddress("glAttachShader"     )),
+		glLinkProgram      ((PFNGLLINKPROGRAMPROC      )wglGetProcAddress("glLinkProgram"      )),
+		glGetProgramiv     ((PFNGLGETPROGRAMIVPROC     )wglGetProcAddress("glGetProgramiv"     )),
+		glGetProgramInfoLog((PFNGLGETPROGRAMINFOLOGPROC)wglGetProcAddress("glGetProgramInfoLog")),
+		glDeleteProgram    ((PFNGLDELETEPROGRAMPROC    )wglGetProcAddress("glDeleteProgram"    )),
+		glUseProgram       ((PFNGLUSEPROGRAMPROC       )wglGetProcAddress("glUseProgram"       )),
+		glGetUniformLocation(
+			(PFNGLGETUNIFORMLOCATIONPROC)wglGetProcAddress("glGetUniformLocation")),
+		glUniform1i        ((PFNGLUNIFORM1IPROC        )wglGetProcAddress("glUniform1i"        )),
+		glUniform1iv       ((PFNGLUNIFORM1IVPROC       )wglGetProcAddress("glUniform1iv"       )),
+		glUniform1f        ((PFNGLUNIFORM1FPROC        )wglGetProcAddress("glUniform1f"        )),
+		glUniform2f        ((PFNGLUNIFORM2FPROC        )wglGetProcAddress("glUniform2f"        )),
+		glUniform2i        ((PFNGLUNIFORM2IPROC        )wglGetProcAddress("glUniform2i"        )),
+		glUniform3f        ((PFNGLUNIFORM3FPROC        )wglGetProcAddress("glUniform3f"        )),
+		glUniform4iv       ((PFNGLUNIFORM4IVPROC       )wglGetProcAddress("glUniform4iv"       )),
+		glTexImage3D       ((PFNGLTEXIMAGE3DPROC       )wglGetProcAddress("glTexImage3D"       )),
+		glTexSubImage3D    ((PFNGLTEXSUBIMAGE3DPROC    )wglGetProcAddress("glTexSubImage3D"    ))
 	{
 		
 	}
 
+	bool OpenGL::supportsPixelBuffers() const
+	{
+		// wglGetProcAddress might return pointers to functions the context doesn't support
+		return m_iVersion >= Version(3, 2, 0) &&
+			glGenBuffers && glDeleteBuffers && glBindBuffer && glBufferData &&
+			glMapBufferRange && glUnmapBuffer &&
+			glFenceSync && glClientWaitSync && glDeleteSync;
+	}
+
+	bool OpenGL::supportsPersistentMapping() const
+	{
+		if (!supportsPixelBuffers() || glBufferStorage == nullptr)
+			return false;
+
+		return m_iVersion >= Version(4, 4, 0) || hasExtension("GL_ARB_buffer_storage");
+	}
+
+	bool OpenGL::supportsShaderCompositor() const
+	{
+		return m_iVersion >= Version(3, 0, 0) &&
+			glCreateShader && glShaderSource && glCompileShader && glGetShaderiv &&
+			glGetShaderInfoLog && glDeleteShader &&
+			glCreateProgram && glAttachShader && glLinkProgram && glGetProgramiv &&
+			glGetProgramInfoLog && glDeleteProgram && glUseProgram &&
+			glGetUniformLocation && glUniform1i && glUniform1iv && glUniform1f && glUniform2f &&
+			glUniform2i && glUniform3f && glUniform4iv &&
+			glTexImage3D && glTexSubImage3D;
+	}
+
+	bool OpenGL::hasExtension(const char *szName) const
+	{
+		const char *szExtensions = reinterpret_cast<const char *>(glGetString(GL_EXTENSIONS));
+		if (szExtensions == nullptr)
+			return false;
+
+		// the names are separated by spaces --> check for whole words only
+		const size_t iLen = strlen(szName);
+		for (const char *sz = strstr(szExtensions, szName); sz; sz = strstr(sz + iLen, szName))
+		{
+			if ((sz == szExtensions || sz[-1] == ' ') && (sz[iLen] == ' ' || sz[iLen] == 0))
+				return true;
+		}
+
+		return false;
+	}
+
+
+
+	PixelBufferAPI::BufferID OpenGLPixelBufferAPI::createBuffer(size_t iSize)
+	{
+		GLuint iBuffer = 0;
+		m_oGL.glGenBuffers(1, &iBuffer);
+		if (iBuffer == 0)
+			return 0;
+
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+		m_oGL.glBufferData(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(iSize), nullptr, GL_STREAM_DRAW);
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (glGetError() != GL_NO_ERROR)
+		{
+			m_oGL.glDeleteBuffers(1, &iBuffer);
+			return 0;
+		}
+
+		return iBuffer;
+	}
+
+	void OpenGLPixelBufferAPI::deleteBuffer(BufferID iBuffer)
+	{
+		m_oGL.glDeleteBuffers(1, &iBuffer);
+	}
+
+	void *OpenGLPixelBufferAPI::mapBuffer(BufferID iBuffer, size_t iSize)
+	{
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+
+		// the fences already make sure the GPU is done with the buffer --> no implicit sync
+		return m_oGL.glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(iSize),
+			GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+	}
+
+	PixelBufferAPI::BufferID OpenGLPixelBufferAPI::createPersistentBuffer(size_t iSize,
+		void **ppData)
+	{
+		// the pixels of the layers live in the buffer, so it's read as well (blending, change
+		// detection, copies between the frames).
+		// client storage: a hint to keep the buffer in system memory, where the CPU reads it fast.
+		constexpr GLbitfield iMapFlags =
+			GL_MAP_READ_BIT | GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		constexpr GLbitfield iStorageFlags = iMapFlags | GL_CLIENT_STORAGE_BIT;
+
+		*ppData = nullptr;
+
+		GLuint iBuffer = 0;
+		m_oGL.glGenBuffers(1, &iBuffer);
+		if (iBuffer == 0)
+			return 0;
+
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+		m_oGL.glBufferStorage(GL_PIXEL_UNPACK_BUFFER, GLsizeiptr(iSize), nullptr, iStorageFlags);
+		if (glGetError() == GL_NO_ERROR)
+			*ppData =
+				m_oGL.glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, GLsizeiptr(iSize), iMapFlags);
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		if (*ppData == nullptr)
+		{
+			m_oGL.glDeleteBuffers(1, &iBuffer);
+			return 0;
+		}
+
+		return iBuffer;
+	}
+
+	void OpenGLPixelBufferAPI::bindBuffer(BufferID iBuffer)
+	{
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, iBuffer);
+	}
+
+	bool OpenGLPixelBufferAPI::unmapBuffer()
+	{
+		return m_oGL.glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+	}
+
+	void OpenGLPixelBufferAPI::unbindBuffer()
+	{
+		m_oGL.glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	PixelBufferAPI::Fence OpenGLPixelBufferAPI::createFence()
+	{
+		return m_oGL.glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	bool OpenGLPixelBufferAPI::waitForFence(Fence oFence, uint64_t iTimeoutNanoseconds)
+	{
+		const GLenum eResult = m_oGL.glClientWaitSync(GLsync(oFence), GL_SYNC_FLUSH_COMMANDS_BIT,
+			iTimeoutNanoseconds);
+		return eResult == GL_ALREADY_SIGNALED || eResult == GL_CONDITION_SATISFIED;
+	}
+
+	void OpenGLPixelBufferAPI::deleteFence(Fence oFence)
+	{
+		m_oGL.glDeleteSync(GLsync(oFence));
+	}
+
 #undef FUNCNAME
 
 }
\ No newline at end of file
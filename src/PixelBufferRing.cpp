@@ -0,0 +1,146 @@
+#include "private/PixelBufferRing.hpp"
+
+#include <algorithm> // std::min, std::max
+
+
+
+namespace rlGameCanvasLib
+{
+
+	PixelBufferRing::PixelBufferRing(PixelBufferAPI &oAPI, size_t iBufferSize,
+		size_t iBufferCount)
+		:
+		m_oAPI(oAPI),
+		m_iBufferSize(iBufferSize),
+		m_iBufferCount(std::min(std::max<size_t>(iBufferCount, 2), iMaxBufferCount))
+	{ }
+
+	PixelBufferRing::~PixelBufferRing()
+	{
+		if (m_bMapped)
+		{
+			m_oAPI.unmapBuffer();
+			m_oAPI.unbindBuffer();
+		}
+
+		for (auto &oBuffer : m_oBuffers)
+		{
+			if (oBuffer.oFence)
+				m_oAPI.deleteFence(oBuffer.oFence);
+			if (oBuffer.iID)
+				m_oAPI.deleteBuffer(oBuffer.iID);
+		}
+	}
+
+	void *PixelBufferRing::map()
+	{
+		if (m_bMapped)
+			return nullptr;
+
+		auto &oBuffer = m_oBuffers[m_iCurrent];
+
+		if (oBuffer.iID == 0)
+		{
+			oBuffer.iID = m_oAPI.createBuffer(m_iBufferSize);
+			if (oBuffer.iID == 0)
+				return nullptr;
+		}
+
+		// the GPU might still be reading the contents of the last round
+		if (oBuffer.oFence)
+		{
+			if (!m_oAPI.waitForFence(oBuffer.oFence, iWaitTimeoutNanoseconds))
+				return nullptr; // try again next time
+
+			m_oAPI.deleteFence(oBuffer.oFence);
+			oBuffer.oFence = nullptr;
+		}
+
+		void *pData = m_oAPI.mapBuffer(oBuffer.iID, m_iBufferSize);
+		if (pData == nullptr)
+		{
+			m_oAPI.unbindBuffer();
+			return nullptr;
+		}
+
+		m_bMapped = true;
+		return pData;
+	}
+
+	bool PixelBufferRing::unmap()
+	{
+		if (!m_bMapped)
+			return false;
+
+		m_bMapped = false;
+		if (!m_oAPI.unmapBuffer())
+		{
+			m_oAPI.unbindBuffer();
+			return false;
+		}
+
+		return true;
+	}
+
+	void PixelBufferRing::submit()
+	{
+		auto &oBuffer = m_oBuffers[m_iCurrent];
+
+		// if the fence can't be created, the driver has to synchronize on the next mapping
+		oBuffer.oFence = m_oAPI.createFence();
+		m_oAPI.unbindBuffer();
+
+		m_iCurrent = (m_iCurrent + 1) % m_iBufferCount;
+	}
+
+
+
+	PersistentPixelBuffer::PersistentPixelBuffer(PixelBufferAPI &oAPI, size_t iFrameSize,
+		size_t iFrameCount)
+		:
+		m_oAPI(oAPI),
+		m_iFrameSize(iFrameSize),
+		m_iFrameCount(std::min(std::max<size_t>(iFrameCount, 2), iMaxFrameCount))
+	{
+		if (!m_oAPI.supportsPersistentMapping())
+			return;
+
+		m_iBuffer = m_oAPI.createPersistentBuffer(m_iFrameSize * m_iFrameCount, &m_pData);
+		if (m_iBuffer == 0)
+			m_pData = nullptr;
+	}
+
+	PersistentPixelBuffer::~PersistentPixelBuffer()
+	{
+		for (auto oFence : m_oFences)
+		{
+			if (oFence)
+				m_oAPI.deleteFence(oFence);
+		}
+
+		// deleting the buffer also unmaps it
+		if (m_iBuffer)
+			m_oAPI.deleteBuffer(m_iBuffer);
+	}
+
+	void PersistentPixelBuffer::bind() { m_oAPI.bindBuffer(m_iBuffer); }
+
+	void PersistentPixelBuffer::unbind() { m_oAPI.unbindBuffer(); }
+
+	bool PersistentPixelBuffer::advance()
+	{
+		m_oFences[m_iCurrent] = m_oAPI.createFence();
+		m_iCurrent = (m_iCurrent + 1) % m_iFrameCount;
+
+		auto &oFence = m_oFences[m_iCurrent];
+		if (oFence == nullptr)
+			return true;
+
+		const bool bSignaled = m_oAPI.waitForFence(oFence, iWaitTimeoutNanoseconds);
+		m_oAPI.deleteFence(oFence);
+		oFence = nullptr;
+
+		return bSignaled;
+	}
+
+}
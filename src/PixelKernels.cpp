@@ -0,0 +1,1518 @@
+#include "private/PixelKernels.hpp"
+
+#include <algorithm> // std::min, std::fill
+#include <cstring>   // memcmp
+
+#ifdef RLGAMECANVAS_X86
+#include <immintrin.h>
+#endif
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		inline uint32_t BlendPixel(uint32_t pxDest, uint32_t pxSrc)
+		{
+			const uint32_t iSrcA = pxSrc >> 24;
+
+			switch (iSrcA)
+			{
+			case 0: // transparent --> do nothing
+				return pxDest;
+
+			case 255: // fully opaque --> override
+				return pxSrc;
+			}
+
+			if ((pxDest >> 24) == 255)
+			{
+				// opaque destination --> the result is opaque, too.
+				// (x + 127) / 255 == Div255(x) for all possible x, so no real division is needed.
+				uint32_t pxResult = 0xFF000000;
+				for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+				{
+					const uint32_t iSrc  = (pxSrc  >> iShift) & 0xFF;
+					const uint32_t iDest = (pxDest >> iShift) & 0xFF;
+
+					pxResult |= Div255(iSrc * iSrcA + iDest * (255 - iSrcA)) << iShift;
+				}
+
+				return pxResult;
+			}
+
+			const uint32_t iDestWeight = Div255((pxDest >> 24) * (255 - iSrcA));
+			const uint32_t iResultA    = iSrcA + iDestWeight;
+
+			uint32_t pxResult = iResultA << 24;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				const uint32_t iSrc  = (pxSrc  >> iShift) & 0xFF;
+				const uint32_t iDest = (pxDest >> iShift) & 0xFF;
+
+				pxResult |=
+					((iSrc * iSrcA + iDest * iDestWeight + iResultA / 2) / iResultA) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t BlendPremultipliedPixel(uint32_t pxDest, uint32_t pxSrc)
+		{
+			const uint32_t iInvSrcA = 255 - (pxSrc >> 24);
+
+			uint32_t pxResult = 0;
+			for (uint32_t iShift = 0; iShift < 32; iShift += 8)
+			{
+				const uint32_t iSrc  = (pxSrc  >> iShift) & 0xFF;
+				const uint32_t iDest = (pxDest >> iShift) & 0xFF;
+
+				pxResult |= std::min<uint32_t>(255, iSrc + Div255(iDest * iInvSrcA)) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t PremultiplyPixel(uint32_t px)
+		{
+			const uint32_t iA = px >> 24;
+
+			uint32_t pxResult = iA << 24;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				pxResult |= Div255(((px >> iShift) & 0xFF) * iA) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t UnpremultiplyPixel(uint32_t px)
+		{
+			const uint32_t iA = px >> 24;
+			if (iA == 0)
+				return 0;
+
+			uint32_t pxResult = iA << 24;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				const uint32_t iColor = (px >> iShift) & 0xFF;
+
+				pxResult |= std::min<uint32_t>(255, (iColor * 255 + iA / 2) / iA) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t AddPixel(uint32_t pxDest, uint32_t pxSrc)
+		{
+			const uint32_t iSrcA = pxSrc >> 24;
+
+			uint32_t pxResult = pxDest & 0xFF000000;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				const uint32_t iSrc  = Div255(((pxSrc >> iShift) & 0xFF) * iSrcA);
+				const uint32_t iDest = (pxDest >> iShift) & 0xFF;
+
+				pxResult |= std::min<uint32_t>(255, iDest + iSrc) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t MultiplyPixel(uint32_t pxDest, uint32_t pxSrc)
+		{
+			const uint32_t iSrcA = pxSrc >> 24;
+
+			uint32_t pxResult = pxDest & 0xFF000000;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				// the source color, mixed with white by the source alpha
+				const uint32_t iFactor =
+					255 - Div255((255 - ((pxSrc >> iShift) & 0xFF)) * iSrcA);
+				const uint32_t iDest   = (pxDest >> iShift) & 0xFF;
+
+				pxResult |= Div255(iDest * iFactor) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t ScreenPixel(uint32_t pxDest, uint32_t pxSrc)
+		{
+			const uint32_t iSrcA = pxSrc >> 24;
+
+			uint32_t pxResult = pxDest & 0xFF000000;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				const uint32_t iSrc  = Div255(((pxSrc >> iShift) & 0xFF) * iSrcA);
+				const uint32_t iDest = (pxDest >> iShift) & 0xFF;
+
+				pxResult |= (iDest + Div255(iSrc * (255 - iDest))) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t TintPixel(uint32_t px, uint32_t pxTint)
+		{
+			const uint32_t iTintA = pxTint >> 24;
+
+			uint32_t pxResult = px & 0xFF000000;
+			for (uint32_t iShift = 0; iShift < 24; iShift += 8)
+			{
+				const uint32_t iColor = (px     >> iShift) & 0xFF;
+				const uint32_t iTint  = (pxTint >> iShift) & 0xFF;
+
+				pxResult |= Div255(iColor * (255 - iTintA) + iTint * iTintA) << iShift;
+			}
+
+			return pxResult;
+		}
+
+		inline uint32_t LerpPixel(uint32_t pxA, uint32_t pxB, uint32_t iWeight)
+		{
+			uint32_t pxResult = 0;
+			for (uint32_t iShift = 0; iShift < 32; iShift += 8)
+			{
+				const uint32_t iA = (pxA >> iShift) & 0xFF;
+				const uint32_t iB = (pxB >> iShift) & 0xFF;
+
+				pxResult |= ((iA * (256 - iWeight) + iB * iWeight) >> 8) << iShift;
+			}
+
+			return pxResult;
+		}
+
+
+
+#ifdef RLGAMECANVAS_X86
+
+		/*
+			SIMD implementation notes
+
+			The channels are widened to 16 bit, so that all products of two channel values fit.
+			The final division by the result alpha is done in single precision: The dividend is
+			< 2^16 and the divisor is <= 255, so the quotient can't be rounded across an integer
+			boundary and the truncated result is identical to the integer division of the
+			reference implementation.
+
+			Lanes with a fully transparent source pixel are always taken from the destination, as
+			the division would be 0/0 if the destination pixel is transparent, too. (The divisor is
+			clamped to 1 so that no floating point exception can be raised.)
+		*/
+
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i Div255_SSE2(__m128i v)
+		{
+			v = _mm_add_epi16(v, _mm_set1_epi16(128));
+			return _mm_srli_epi16(_mm_add_epi16(v, _mm_srli_epi16(v, 8)), 8);
+		}
+
+		// Blend two pixels that were widened to 16 bit per channel.
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i BlendWidened_SSE2(__m128i vDest, __m128i vSrc)
+		{
+			const __m128i vSrcA = _mm_shufflehi_epi16(
+				_mm_shufflelo_epi16(vSrc, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			const __m128i vDestA = _mm_shufflehi_epi16(
+				_mm_shufflelo_epi16(vDest, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+			const __m128i vDestWeight = Div255_SSE2(
+				_mm_mullo_epi16(vDestA, _mm_sub_epi16(_mm_set1_epi16(255), vSrcA)));
+			const __m128i vResultA = _mm_add_epi16(vSrcA, vDestWeight);
+
+			const __m128i vDividend = _mm_add_epi16(
+				_mm_add_epi16(_mm_mullo_epi16(vSrc, vSrcA), _mm_mullo_epi16(vDest, vDestWeight)),
+				_mm_srli_epi16(vResultA, 1)
+			);
+
+			const __m128i vZero    = _mm_setzero_si128();
+			const __m128i vDivisor = _mm_max_epi16(vResultA, _mm_set1_epi16(1));
+			const __m128i vQuotientLo = _mm_cvttps_epi32(_mm_div_ps(
+				_mm_cvtepi32_ps(_mm_unpacklo_epi16(vDividend, vZero)),
+				_mm_cvtepi32_ps(_mm_unpacklo_epi16(vDivisor,  vZero))
+			));
+			const __m128i vQuotientHi = _mm_cvttps_epi32(_mm_div_ps(
+				_mm_cvtepi32_ps(_mm_unpackhi_epi16(vDividend, vZero)),
+				_mm_cvtepi32_ps(_mm_unpackhi_epi16(vDivisor,  vZero))
+			));
+			const __m128i vColor = _mm_packs_epi32(vQuotientLo, vQuotientHi);
+
+			// alpha channel = result alpha
+			const __m128i vAlphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+			return _mm_or_si128(
+				_mm_and_si128   (vAlphaMask, vResultA),
+				_mm_andnot_si128(vAlphaMask, vColor)
+			);
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i Div255_AVX2(__m256i v)
+		{
+			v = _mm256_add_epi16(v, _mm256_set1_epi16(128));
+			return _mm256_srli_epi16(_mm256_add_epi16(v, _mm256_srli_epi16(v, 8)), 8);
+		}
+
+		// Blend four pixels that were widened to 16 bit per channel.
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i BlendWidened_AVX2(__m256i vDest, __m256i vSrc)
+		{
+			const __m256i vSrcA = _mm256_shufflehi_epi16(
+				_mm256_shufflelo_epi16(vSrc, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+			const __m256i vDestA = _mm256_shufflehi_epi16(
+				_mm256_shufflelo_epi16(vDest, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+
+			const __m256i vDestWeight = Div255_AVX2(
+				_mm256_mullo_epi16(vDestA, _mm256_sub_epi16(_mm256_set1_epi16(255), vSrcA)));
+			const __m256i vResultA = _mm256_add_epi16(vSrcA, vDestWeight);
+
+			const __m256i vDividend = _mm256_add_epi16(
+				_mm256_add_epi16(
+					_mm256_mullo_epi16(vSrc, vSrcA), _mm256_mullo_epi16(vDest, vDestWeight)),
+				_mm256_srli_epi16(vResultA, 1)
+			);
+
+			const __m256i vZero    = _mm256_setzero_si256();
+			const __m256i vDivisor = _mm256_max_epi16(vResultA, _mm256_set1_epi16(1));
+			const __m256i vQuotientLo = _mm256_cvttps_epi32(_mm256_div_ps(
+				_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(vDividend, vZero)),
+				_mm256_cvtepi32_ps(_mm256_unpacklo_epi16(vDivisor,  vZero))
+			));
+			const __m256i vQuotientHi = _mm256_cvttps_epi32(_mm256_div_ps(
+				_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(vDividend, vZero)),
+				_mm256_cvtepi32_ps(_mm256_unpackhi_epi16(vDivisor,  vZero))
+			));
+			const __m256i vColor = _mm256_packs_epi32(vQuotientLo, vQuotientHi);
+
+			// alpha channel = result alpha
+			const __m256i vAlphaMask = _mm256_set_epi16(
+				-1, 0, 0, 0, -1, 0, 0, 0,
+				-1, 0, 0, 0, -1, 0, 0, 0
+			);
+			return _mm256_blendv_epi8(vColor, vResultA, vAlphaMask);
+		}
+
+		// Broadcast the alpha value of two pixels that were widened to 16 bit per channel.
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i BroadcastAlpha_SSE2(__m128i v)
+		{
+			return _mm_shufflehi_epi16(
+				_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		}
+
+		// Multiply two pixels that were widened to 16 bit per channel with factors in [0, 255].
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i MulDiv255_SSE2(__m128i v, __m128i vFactor)
+		{
+			return Div255_SSE2(_mm_mullo_epi16(v, vFactor));
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i BroadcastAlpha_AVX2(__m256i v)
+		{
+			return _mm256_shufflehi_epi16(
+				_mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i MulDiv255_AVX2(__m256i v, __m256i vFactor)
+		{
+			return Div255_AVX2(_mm256_mullo_epi16(v, vFactor));
+		}
+
+		// Add, multiply and screen two pixels that were widened to 16 bit per channel.
+		// The alpha channel of the result is meaningless, as it's replaced by the destination
+		// alpha after packing.
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i AddWidened_SSE2(__m128i vDest, __m128i vSrc)
+		{
+			return _mm_add_epi16(vDest, MulDiv255_SSE2(vSrc, BroadcastAlpha_SSE2(vSrc)));
+		}
+
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i MultiplyWidened_SSE2(__m128i vDest, __m128i vSrc)
+		{
+			const __m128i v255 = _mm_set1_epi16(255);
+
+			const __m128i vFactor = _mm_sub_epi16(v255,
+				MulDiv255_SSE2(_mm_sub_epi16(v255, vSrc), BroadcastAlpha_SSE2(vSrc)));
+			return MulDiv255_SSE2(vDest, vFactor);
+		}
+
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i ScreenWidened_SSE2(__m128i vDest, __m128i vSrc)
+		{
+			const __m128i vSrcWeighted = MulDiv255_SSE2(vSrc, BroadcastAlpha_SSE2(vSrc));
+			return _mm_add_epi16(vDest,
+				MulDiv255_SSE2(vSrcWeighted, _mm_sub_epi16(_mm_set1_epi16(255), vDest)));
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i AddWidened_AVX2(__m256i vDest, __m256i vSrc)
+		{
+			return _mm256_add_epi16(vDest, MulDiv255_AVX2(vSrc, BroadcastAlpha_AVX2(vSrc)));
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i MultiplyWidened_AVX2(__m256i vDest, __m256i vSrc)
+		{
+			const __m256i v255 = _mm256_set1_epi16(255);
+
+			const __m256i vFactor = _mm256_sub_epi16(v255,
+				MulDiv255_AVX2(_mm256_sub_epi16(v255, vSrc), BroadcastAlpha_AVX2(vSrc)));
+			return MulDiv255_AVX2(vDest, vFactor);
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i ScreenWidened_AVX2(__m256i vDest, __m256i vSrc)
+		{
+			const __m256i vSrcWeighted = MulDiv255_AVX2(vSrc, BroadcastAlpha_AVX2(vSrc));
+			return _mm256_add_epi16(vDest,
+				MulDiv255_AVX2(vSrcWeighted, _mm256_sub_epi16(_mm256_set1_epi16(255), vDest)));
+		}
+
+		// Apply an operation on widened pixels to a row, keeping the destination alpha.
+		// Blocks of fully transparent source pixels are skipped.
+		template <__m128i(*fnOp)(__m128i, __m128i)>
+		RLGAMECANVAS_TARGET_SSE2
+		inline void ApplyWidenedRow_SSE2(uint32_t *&pDest, const uint32_t *&pSrc, size_t &iCount)
+		{
+			const __m128i vZero      = _mm_setzero_si128();
+			const __m128i vAlphaMask = _mm_set1_epi32(int(0xFF000000));
+
+			for (; iCount >= 4; iCount -= 4, pDest += 4, pSrc += 4)
+			{
+				const __m128i vSrc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(vSrc, vAlphaMask), vZero))
+					== 0xFFFF)
+					continue; // all transparent --> do nothing
+
+				const __m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest));
+				const __m128i vResult = _mm_packus_epi16(
+					fnOp(_mm_unpacklo_epi8(vDest, vZero), _mm_unpacklo_epi8(vSrc, vZero)),
+					fnOp(_mm_unpackhi_epi8(vDest, vZero), _mm_unpackhi_epi8(vSrc, vZero))
+				);
+
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), _mm_or_si128(
+					_mm_and_si128   (vAlphaMask, vDest),
+					_mm_andnot_si128(vAlphaMask, vResult)
+				));
+			}
+		}
+
+		template <__m256i(*fnOp)(__m256i, __m256i)>
+		RLGAMECANVAS_TARGET_AVX2
+		inline void ApplyWidenedRow_AVX2(uint32_t *&pDest, const uint32_t *&pSrc, size_t &iCount)
+		{
+			const __m256i vZero      = _mm256_setzero_si256();
+			const __m256i vAlphaMask = _mm256_set1_epi32(int(0xFF000000));
+
+			for (; iCount >= 8; iCount -= 8, pDest += 8, pSrc += 8)
+			{
+				const __m256i vSrc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSrc));
+				if (_mm256_testz_si256(vSrc, vAlphaMask))
+					continue; // all transparent --> do nothing
+
+				const __m256i vDest =
+					_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pDest));
+				const __m256i vResult = _mm256_packus_epi16(
+					fnOp(_mm256_unpacklo_epi8(vDest, vZero), _mm256_unpacklo_epi8(vSrc, vZero)),
+					fnOp(_mm256_unpackhi_epi8(vDest, vZero), _mm256_unpackhi_epi8(vSrc, vZero))
+				);
+
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+					_mm256_blendv_epi8(vResult, vDest, vAlphaMask));
+			}
+			_mm256_zeroupper();
+		}
+
+		// Blend two pixels onto two opaque pixels, all widened to 16 bit per channel.
+		// As the result is opaque, too, this doesn't need any division.
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i BlendOntoOpaqueWidened_SSE2(__m128i vDest, __m128i vSrc)
+		{
+			const __m128i vSrcA = BroadcastAlpha_SSE2(vSrc);
+
+			const __m128i vColor = Div255_SSE2(_mm_add_epi16(
+				_mm_mullo_epi16(vSrc,  vSrcA),
+				_mm_mullo_epi16(vDest, _mm_sub_epi16(_mm_set1_epi16(255), vSrcA))
+			));
+			return _mm_or_si128(vColor, _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0));
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i BlendOntoOpaqueWidened_AVX2(__m256i vDest, __m256i vSrc)
+		{
+			const __m256i vSrcA = BroadcastAlpha_AVX2(vSrc);
+
+			const __m256i vColor = Div255_AVX2(_mm256_add_epi16(
+				_mm256_mullo_epi16(vSrc,  vSrcA),
+				_mm256_mullo_epi16(vDest, _mm256_sub_epi16(_mm256_set1_epi16(255), vSrcA))
+			));
+			return _mm256_or_si256(vColor, _mm256_set_epi16(
+				255, 0, 0, 0, 255, 0, 0, 0,
+				255, 0, 0, 0, 255, 0, 0, 0
+			));
+		}
+
+		// Interpolate two pixels that were widened to 16 bit per channel.
+		// vWeight contains the weight of B for every channel.
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i LerpWidened_SSE2(__m128i vA, __m128i vB, __m128i vWeight)
+		{
+			return _mm_srli_epi16(_mm_add_epi16(
+				_mm_mullo_epi16(vA, _mm_sub_epi16(_mm_set1_epi16(256), vWeight)),
+				_mm_mullo_epi16(vB, vWeight)
+			), 8);
+		}
+
+		// Interpolate four pixels, with an individual weight per pixel (32 bit each).
+		RLGAMECANVAS_TARGET_SSE2
+		inline __m128i Lerp4_SSE2(__m128i vA, __m128i vB, __m128i vWeights)
+		{
+			const __m128i vZero = _mm_setzero_si128();
+
+			// [w0, w1, w2, w3] --> [w0 w0 w0 w0 w1 w1 w1 w1], [w2 w2 w2 w2 w3 w3 w3 w3]
+			__m128i vWeights16 = _mm_packs_epi32(vWeights, vWeights);
+			vWeights16 = _mm_unpacklo_epi16(vWeights16, vWeights16);
+
+			return _mm_packus_epi16(
+				LerpWidened_SSE2(_mm_unpacklo_epi8(vA, vZero), _mm_unpacklo_epi8(vB, vZero),
+					_mm_unpacklo_epi32(vWeights16, vWeights16)),
+				LerpWidened_SSE2(_mm_unpackhi_epi8(vA, vZero), _mm_unpackhi_epi8(vB, vZero),
+					_mm_unpackhi_epi32(vWeights16, vWeights16))
+			);
+		}
+
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i LerpWidened_AVX2(__m256i vA, __m256i vB, __m256i vWeight)
+		{
+			return _mm256_srli_epi16(_mm256_add_epi16(
+				_mm256_mullo_epi16(vA, _mm256_sub_epi16(_mm256_set1_epi16(256), vWeight)),
+				_mm256_mullo_epi16(vB, vWeight)
+			), 8);
+		}
+
+		// Interpolate eight pixels, with an individual weight per pixel (32 bit each).
+		RLGAMECANVAS_TARGET_AVX2
+		inline __m256i Lerp8_AVX2(__m256i vA, __m256i vB, __m256i vWeights)
+		{
+			const __m256i vZero = _mm256_setzero_si256();
+
+			// same as Lerp4_SSE2, but within each 128 bit lane
+			__m256i vWeights16 = _mm256_packs_epi32(vWeights, vWeights);
+			vWeights16 = _mm256_unpacklo_epi16(vWeights16, vWeights16);
+
+			return _mm256_packus_epi16(
+				LerpWidened_AVX2(_mm256_unpacklo_epi8(vA, vZero), _mm256_unpacklo_epi8(vB, vZero),
+					_mm256_unpacklo_epi32(vWeights16, vWeights16)),
+				LerpWidened_AVX2(_mm256_unpackhi_epi8(vA, vZero), _mm256_unpackhi_epi8(vB, vZero),
+					_mm256_unpackhi_epi32(vWeights16, vWeights16))
+			);
+		}
+
+#endif // RLGAMECANVAS_X86
+
+
+
+		// Get the fastest kernel variant supported by the CPU.
+		template <typename TFunc>
+		TFunc SelectKernel(TFunc fnReference, TFunc fnSSE2, TFunc fnAVX2)
+		{
+#ifdef RLGAMECANVAS_X86
+			const auto &oCPU = GetCPUFeatures();
+
+			if (oCPU.bAVX2)
+				return fnAVX2;
+			if (oCPU.bSSE2)
+				return fnSSE2;
+#endif // RLGAMECANVAS_X86
+
+			return fnReference;
+		}
+
+#ifdef RLGAMECANVAS_X86
+#define RLGAMECANVAS_SELECT_KERNEL(name) SelectKernel(name##_Reference, name##_SSE2, name##_AVX2)
+#else
+#define RLGAMECANVAS_SELECT_KERNEL(name) \
+	SelectKernel(name##_Reference, name##_Reference, name##_Reference)
+#endif
+
+	}
+
+
+
+	void BlendRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = BlendPixel(pDest[i], pSrc[i]);
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void BlendRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		const __m128i vZero = _mm_setzero_si128();
+		const __m128i v255  = _mm_set1_epi32(255);
+
+		for (; iCount >= 4; iCount -= 4, pDest += 4, pSrc += 4)
+		{
+			const __m128i vSrc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+			const __m128i vSrcA = _mm_srli_epi32(vSrc, 24);
+
+			const __m128i vTransparent     = _mm_cmpeq_epi32(vSrcA, vZero);
+			const int     iTransparentMask = _mm_movemask_epi8(vTransparent);
+			if (iTransparentMask == 0xFFFF)
+				continue; // all transparent --> do nothing
+
+			const __m128i vOpaque     = _mm_cmpeq_epi32(vSrcA, v255);
+			const int     iOpaqueMask = _mm_movemask_epi8(vOpaque);
+			if (iOpaqueMask == 0xFFFF)
+			{
+				// all opaque --> override
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), vSrc);
+				continue;
+			}
+
+			const __m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest));
+			__m128i vResult;
+
+			if ((iTransparentMask | iOpaqueMask) == 0xFFFF)
+				// only transparent and opaque pixels --> select
+				vResult = _mm_or_si128(
+					_mm_and_si128   (vOpaque, vSrc),
+					_mm_andnot_si128(vOpaque, vDest)
+				);
+			else if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_srli_epi32(vDest, 24), v255)) == 0xFFFF)
+				// opaque destination --> mix without division
+				vResult = _mm_packus_epi16(
+					BlendOntoOpaqueWidened_SSE2(
+						_mm_unpacklo_epi8(vDest, vZero), _mm_unpacklo_epi8(vSrc, vZero)),
+					BlendOntoOpaqueWidened_SSE2(
+						_mm_unpackhi_epi8(vDest, vZero), _mm_unpackhi_epi8(vSrc, vZero))
+				);
+			else
+			{
+				// at least one partially transparent pixel --> mix
+				vResult = _mm_packus_epi16(
+					BlendWidened_SSE2(
+						_mm_unpacklo_epi8(vDest, vZero), _mm_unpacklo_epi8(vSrc, vZero)),
+					BlendWidened_SSE2(
+						_mm_unpackhi_epi8(vDest, vZero), _mm_unpackhi_epi8(vSrc, vZero))
+				);
+				vResult = _mm_or_si128(
+					_mm_and_si128   (vTransparent, vDest),
+					_mm_andnot_si128(vTransparent, vResult)
+				);
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), vResult);
+		}
+
+		BlendRow_Reference(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void BlendRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		const __m256i vZero = _mm256_setzero_si256();
+		const __m256i v255  = _mm256_set1_epi32(255);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, pSrc += 8)
+		{
+			const __m256i vSrc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSrc));
+			const __m256i vSrcA = _mm256_srli_epi32(vSrc, 24);
+
+			const __m256i  vTransparent     = _mm256_cmpeq_epi32(vSrcA, vZero);
+			const uint32_t iTransparentMask = uint32_t(_mm256_movemask_epi8(vTransparent));
+			if (iTransparentMask == 0xFFFFFFFF)
+				continue; // all transparent --> do nothing
+
+			const __m256i  vOpaque     = _mm256_cmpeq_epi32(vSrcA, v255);
+			const uint32_t iOpaqueMask = uint32_t(_mm256_movemask_epi8(vOpaque));
+			if (iOpaqueMask == 0xFFFFFFFF)
+			{
+				// all opaque --> override
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), vSrc);
+				continue;
+			}
+
+			const __m256i vDest = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pDest));
+			__m256i vResult;
+
+			if ((iTransparentMask | iOpaqueMask) == 0xFFFFFFFF)
+				// only transparent and opaque pixels --> select
+				vResult = _mm256_blendv_epi8(vDest, vSrc, vOpaque);
+			else if (uint32_t(_mm256_movemask_epi8(
+				_mm256_cmpeq_epi32(_mm256_srli_epi32(vDest, 24), v255))) == 0xFFFFFFFF)
+				// opaque destination --> mix without division
+				vResult = _mm256_packus_epi16(
+					BlendOntoOpaqueWidened_AVX2(
+						_mm256_unpacklo_epi8(vDest, vZero), _mm256_unpacklo_epi8(vSrc, vZero)),
+					BlendOntoOpaqueWidened_AVX2(
+						_mm256_unpackhi_epi8(vDest, vZero), _mm256_unpackhi_epi8(vSrc, vZero))
+				);
+			else
+			{
+				// at least one partially transparent pixel --> mix
+				vResult = _mm256_packus_epi16(
+					BlendWidened_AVX2(
+						_mm256_unpacklo_epi8(vDest, vZero), _mm256_unpacklo_epi8(vSrc, vZero)),
+					BlendWidened_AVX2(
+						_mm256_unpackhi_epi8(vDest, vZero), _mm256_unpackhi_epi8(vSrc, vZero))
+				);
+				vResult = _mm256_blendv_epi8(vResult, vDest, vTransparent);
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), vResult);
+		}
+		_mm256_zeroupper();
+
+		BlendRow_SSE2(pDest, pSrc, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void BlendRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		static const BlendRowFunc fnBlendRow = RLGAMECANVAS_SELECT_KERNEL(BlendRow);
+		fnBlendRow(pDest, pSrc, iCount);
+	}
+
+
+
+
+	void BlendPremultipliedRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = BlendPremultipliedPixel(pDest[i], pSrc[i]);
+		}
+	}
+
+	void PremultiplyRow_Reference(uint32_t *pData, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pData[i] = PremultiplyPixel(pData[i]);
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void BlendPremultipliedRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		const __m128i vZero = _mm_setzero_si128();
+		const __m128i v255  = _mm_set1_epi16(255);
+
+		for (; iCount >= 4; iCount -= 4, pDest += 4, pSrc += 4)
+		{
+			const __m128i vSrc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(vSrc, vZero)) == 0xFFFF)
+				continue; // all blank --> do nothing
+
+			const __m128i vSrcA = _mm_srli_epi32(vSrc, 24);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(vSrcA, _mm_set1_epi32(255))) == 0xFFFF)
+			{
+				// all opaque --> override
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), vSrc);
+				continue;
+			}
+
+			const __m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pDest));
+
+			const __m128i vSrcLo = _mm_unpacklo_epi8(vSrc, vZero);
+			const __m128i vSrcHi = _mm_unpackhi_epi8(vSrc, vZero);
+			const __m128i vDestLo = MulDiv255_SSE2(_mm_unpacklo_epi8(vDest, vZero),
+				_mm_sub_epi16(v255, BroadcastAlpha_SSE2(vSrcLo)));
+			const __m128i vDestHi = MulDiv255_SSE2(_mm_unpackhi_epi8(vDest, vZero),
+				_mm_sub_epi16(v255, BroadcastAlpha_SSE2(vSrcHi)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),
+				_mm_adds_epu8(vSrc, _mm_packus_epi16(vDestLo, vDestHi)));
+		}
+
+		BlendPremultipliedRow_Reference(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void BlendPremultipliedRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		const __m256i vZero = _mm256_setzero_si256();
+		const __m256i v255  = _mm256_set1_epi16(255);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, pSrc += 8)
+		{
+			const __m256i vSrc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSrc));
+
+			if (_mm256_testz_si256(vSrc, vSrc))
+				continue; // all blank --> do nothing
+
+			const __m256i vSrcA = _mm256_srli_epi32(vSrc, 24);
+			if (uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi32(vSrcA, _mm256_set1_epi32(255))))
+				== 0xFFFFFFFF)
+			{
+				// all opaque --> override
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), vSrc);
+				continue;
+			}
+
+			const __m256i vDest = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pDest));
+
+			const __m256i vSrcLo = _mm256_unpacklo_epi8(vSrc, vZero);
+			const __m256i vSrcHi = _mm256_unpackhi_epi8(vSrc, vZero);
+			const __m256i vDestLo = MulDiv255_AVX2(_mm256_unpacklo_epi8(vDest, vZero),
+				_mm256_sub_epi16(v255, BroadcastAlpha_AVX2(vSrcLo)));
+			const __m256i vDestHi = MulDiv255_AVX2(_mm256_unpackhi_epi8(vDest, vZero),
+				_mm256_sub_epi16(v255, BroadcastAlpha_AVX2(vSrcHi)));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+				_mm256_adds_epu8(vSrc, _mm256_packus_epi16(vDestLo, vDestHi)));
+		}
+		_mm256_zeroupper();
+
+		BlendPremultipliedRow_SSE2(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_SSE2
+	void PremultiplyRow_SSE2(uint32_t *pData, size_t iCount)
+	{
+		const __m128i vZero      = _mm_setzero_si128();
+		const __m128i vAlphaMask = _mm_set1_epi32(int(0xFF000000));
+
+		for (; iCount >= 4; iCount -= 4, pData += 4)
+		{
+			const __m128i v   = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pData));
+			const __m128i vLo = _mm_unpacklo_epi8(v, vZero);
+			const __m128i vHi = _mm_unpackhi_epi8(v, vZero);
+
+			const __m128i vResult = _mm_packus_epi16(
+				MulDiv255_SSE2(vLo, BroadcastAlpha_SSE2(vLo)),
+				MulDiv255_SSE2(vHi, BroadcastAlpha_SSE2(vHi))
+			);
+
+			// Div255(a * a) != a --> restore the original alpha values
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pData), _mm_or_si128(
+				_mm_and_si128   (vAlphaMask, v),
+				_mm_andnot_si128(vAlphaMask, vResult)
+			));
+		}
+
+		PremultiplyRow_Reference(pData, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void PremultiplyRow_AVX2(uint32_t *pData, size_t iCount)
+	{
+		const __m256i vZero      = _mm256_setzero_si256();
+		const __m256i vAlphaMask = _mm256_set1_epi32(int(0xFF000000));
+
+		for (; iCount >= 8; iCount -= 8, pData += 8)
+		{
+			const __m256i v   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pData));
+			const __m256i vLo = _mm256_unpacklo_epi8(v, vZero);
+			const __m256i vHi = _mm256_unpackhi_epi8(v, vZero);
+
+			const __m256i vResult = _mm256_packus_epi16(
+				MulDiv255_AVX2(vLo, BroadcastAlpha_AVX2(vLo)),
+				MulDiv255_AVX2(vHi, BroadcastAlpha_AVX2(vHi))
+			);
+
+			// Div255(a * a) != a --> restore the original alpha values
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pData),
+				_mm256_blendv_epi8(vResult, v, vAlphaMask));
+		}
+		_mm256_zeroupper();
+
+		PremultiplyRow_SSE2(pData, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void BlendPremultipliedRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		static const BlendPremultipliedRowFunc fnBlendPremultipliedRow =
+			RLGAMECANVAS_SELECT_KERNEL(BlendPremultipliedRow);
+		fnBlendPremultipliedRow(pDest, pSrc, iCount);
+	}
+
+	void PremultiplyRow(uint32_t *pData, size_t iCount)
+	{
+		static const PremultiplyRowFunc fnPremultiplyRow =
+			RLGAMECANVAS_SELECT_KERNEL(PremultiplyRow);
+		fnPremultiplyRow(pData, iCount);
+	}
+
+	void UnpremultiplyRow(uint32_t *pData, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pData[i] = UnpremultiplyPixel(pData[i]);
+		}
+	}
+
+
+
+
+
+	void AddRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = AddPixel(pDest[i], pSrc[i]);
+		}
+	}
+
+	void MultiplyRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = MultiplyPixel(pDest[i], pSrc[i]);
+		}
+	}
+
+	void ScreenRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = ScreenPixel(pDest[i], pSrc[i]);
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void AddRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_SSE2<AddWidened_SSE2>(pDest, pSrc, iCount);
+		AddRow_Reference(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void AddRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_AVX2<AddWidened_AVX2>(pDest, pSrc, iCount);
+		AddRow_SSE2(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_SSE2
+	void MultiplyRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_SSE2<MultiplyWidened_SSE2>(pDest, pSrc, iCount);
+		MultiplyRow_Reference(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void MultiplyRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_AVX2<MultiplyWidened_AVX2>(pDest, pSrc, iCount);
+		MultiplyRow_SSE2(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_SSE2
+	void ScreenRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_SSE2<ScreenWidened_SSE2>(pDest, pSrc, iCount);
+		ScreenRow_Reference(pDest, pSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void ScreenRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		ApplyWidenedRow_AVX2<ScreenWidened_AVX2>(pDest, pSrc, iCount);
+		ScreenRow_SSE2(pDest, pSrc, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void AddRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		static const BlendRowFunc fnAddRow = RLGAMECANVAS_SELECT_KERNEL(AddRow);
+		fnAddRow(pDest, pSrc, iCount);
+	}
+
+	void MultiplyRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		static const BlendRowFunc fnMultiplyRow = RLGAMECANVAS_SELECT_KERNEL(MultiplyRow);
+		fnMultiplyRow(pDest, pSrc, iCount);
+	}
+
+	void ScreenRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+	{
+		static const BlendRowFunc fnScreenRow = RLGAMECANVAS_SELECT_KERNEL(ScreenRow);
+		fnScreenRow(pDest, pSrc, iCount);
+	}
+
+
+
+
+	void TintRow_Reference(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = TintPixel(pSrc[i], pxTint);
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	// Per channel: Div255(S.c * weight + offset), with weight = 255 - T.a and offset = T.c * T.a
+	// for the colors and weight = 255 and offset = 0 for the alpha value, so it stays the same.
+
+	RLGAMECANVAS_TARGET_SSE2
+	void TintRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount)
+	{
+		const short iTintA = short(pxTint >> 24);
+		const short iR     = short(( pxTint        & 0xFF) * iTintA);
+		const short iG     = short(((pxTint >>  8) & 0xFF) * iTintA);
+		const short iB     = short(((pxTint >> 16) & 0xFF) * iTintA);
+		const short iW     = short(255 - iTintA);
+
+		const __m128i vZero   = _mm_setzero_si128();
+		const __m128i vWeight = _mm_set_epi16(255, iW, iW, iW, 255, iW, iW, iW);
+		const __m128i vOffset = _mm_set_epi16(0, iB, iG, iR, 0, iB, iG, iR);
+
+		for (; iCount >= 4; iCount -= 4, pDest += 4, pSrc += 4)
+		{
+			const __m128i vSrc = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+
+			const __m128i vLo = Div255_SSE2(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpacklo_epi8(vSrc, vZero), vWeight), vOffset));
+			const __m128i vHi = Div255_SSE2(_mm_add_epi16(
+				_mm_mullo_epi16(_mm_unpackhi_epi8(vSrc, vZero), vWeight), vOffset));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), _mm_packus_epi16(vLo, vHi));
+		}
+
+		TintRow_Reference(pDest, pSrc, pxTint, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void TintRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount)
+	{
+		const short iTintA = short(pxTint >> 24);
+		const short iR     = short(( pxTint        & 0xFF) * iTintA);
+		const short iG     = short(((pxTint >>  8) & 0xFF) * iTintA);
+		const short iB     = short(((pxTint >> 16) & 0xFF) * iTintA);
+		const short iW     = short(255 - iTintA);
+
+		const __m256i vZero   = _mm256_setzero_si256();
+		const __m256i vWeight = _mm256_set_epi16(
+			255, iW, iW, iW, 255, iW, iW, iW,
+			255, iW, iW, iW, 255, iW, iW, iW
+		);
+		const __m256i vOffset = _mm256_set_epi16(
+			0, iB, iG, iR, 0, iB, iG, iR,
+			0, iB, iG, iR, 0, iB, iG, iR
+		);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, pSrc += 8)
+		{
+			const __m256i vSrc = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSrc));
+
+			const __m256i vLo = Div255_AVX2(_mm256_add_epi16(
+				_mm256_mullo_epi16(_mm256_unpacklo_epi8(vSrc, vZero), vWeight), vOffset));
+			const __m256i vHi = Div255_AVX2(_mm256_add_epi16(
+				_mm256_mullo_epi16(_mm256_unpackhi_epi8(vSrc, vZero), vWeight), vOffset));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+				_mm256_packus_epi16(vLo, vHi));
+		}
+		_mm256_zeroupper();
+
+		TintRow_SSE2(pDest, pSrc, pxTint, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void TintRow(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount)
+	{
+		static const TintRowFunc fnTintRow = RLGAMECANVAS_SELECT_KERNEL(TintRow);
+		fnTintRow(pDest, pSrc, pxTint, iCount);
+	}
+
+
+
+
+
+	void LerpColumns_Reference(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = LerpPixel(pSrcRow[piLeft[i]], pSrcRow[piRight[i]], piWeight[i]);
+		}
+	}
+
+	void LerpRows_Reference(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = LerpPixel(pA[i], pB[i], iWeight);
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void LerpColumns_SSE2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount)
+	{
+		for (; iCount >= 4; iCount -= 4, pDest += 4, piLeft += 4, piRight += 4, piWeight += 4)
+		{
+			const __m128i vLeft = _mm_setr_epi32(
+				int(pSrcRow[piLeft[0]]), int(pSrcRow[piLeft[1]]),
+				int(pSrcRow[piLeft[2]]), int(pSrcRow[piLeft[3]])
+			);
+			const __m128i vRight = _mm_setr_epi32(
+				int(pSrcRow[piRight[0]]), int(pSrcRow[piRight[1]]),
+				int(pSrcRow[piRight[2]]), int(pSrcRow[piRight[3]])
+			);
+			const __m128i vWeights = _mm_loadu_si128(reinterpret_cast<const __m128i *>(piWeight));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),
+				Lerp4_SSE2(vLeft, vRight, vWeights));
+		}
+
+		LerpColumns_Reference(pDest, pSrcRow, piLeft, piRight, piWeight, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void LerpColumns_AVX2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount)
+	{
+		const int *const pSrc = reinterpret_cast<const int *>(pSrcRow);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, piLeft += 8, piRight += 8, piWeight += 8)
+		{
+			const __m256i vLeft = _mm256_i32gather_epi32(pSrc,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(piLeft)), 4);
+			const __m256i vRight = _mm256_i32gather_epi32(pSrc,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(piRight)), 4);
+			const __m256i vWeights =
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(piWeight));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+				Lerp8_AVX2(vLeft, vRight, vWeights));
+		}
+		_mm256_zeroupper();
+
+		LerpColumns_SSE2(pDest, pSrcRow, piLeft, piRight, piWeight, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_SSE2
+	void LerpRows_SSE2(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount)
+	{
+		const __m128i vWeights = _mm_set1_epi32(int(iWeight));
+
+		for (; iCount >= 4; iCount -= 4, pDest += 4, pA += 4, pB += 4)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), Lerp4_SSE2(
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(pA)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i *>(pB)),
+				vWeights
+			));
+		}
+
+		LerpRows_Reference(pDest, pA, pB, iWeight, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void LerpRows_AVX2(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount)
+	{
+		const __m256i vWeights = _mm256_set1_epi32(int(iWeight));
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, pA += 8, pB += 8)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), Lerp8_AVX2(
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pA)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(pB)),
+				vWeights
+			));
+		}
+		_mm256_zeroupper();
+
+		LerpRows_SSE2(pDest, pA, pB, iWeight, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void LerpColumns(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount)
+	{
+		static const LerpColumnsFunc fnLerpColumns = RLGAMECANVAS_SELECT_KERNEL(LerpColumns);
+		fnLerpColumns(pDest, pSrcRow, piLeft, piRight, piWeight, iCount);
+	}
+
+	void LerpRows(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount)
+	{
+		static const LerpRowsFunc fnLerpRows = RLGAMECANVAS_SELECT_KERNEL(LerpRows);
+		fnLerpRows(pDest, pA, pB, iWeight, iCount);
+	}
+
+
+
+
+
+	void ScaleRowInteger_Reference(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount)
+	{
+		for (size_t i = 0; i < iSrcCount; ++i, pDest += iFactor)
+		{
+			std::fill(pDest, pDest + iFactor, pSrc[i]);
+		}
+	}
+
+	void SampleRow_Reference(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piColumns, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = pSrcRow[piColumns[i]];
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void ScaleRowInteger_SSE2(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount)
+	{
+		switch (iFactor)
+		{
+		case 2:
+			for (; iSrcCount >= 4; iSrcCount -= 4, pSrc += 4, pDest += 8)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),     _mm_unpacklo_epi32(v, v));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest + 4), _mm_unpackhi_epi32(v, v));
+			}
+			break;
+
+		case 3:
+			for (; iSrcCount >= 4; iSrcCount -= 4, pSrc += 4, pDest += 12)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pSrc));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest),
+					_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 0, 0)));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest + 4),
+					_mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 1, 1)));
+				_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest + 8),
+					_mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 2)));
+			}
+			break;
+
+		default:
+			if (iFactor < 4)
+				break;
+
+			// every source pixel fills at least one full vector
+			for (; iSrcCount > 0; --iSrcCount, ++pSrc)
+			{
+				const __m128i v = _mm_set1_epi32(int(*pSrc));
+
+				uint32_t *const pEnd = pDest + iFactor;
+				for (; pDest + 4 <= pEnd; pDest += 4)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i *>(pDest), v);
+				}
+				for (; pDest < pEnd; ++pDest)
+				{
+					*pDest = *pSrc;
+				}
+			}
+		}
+
+		ScaleRowInteger_Reference(pDest, pSrc, iFactor, iSrcCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void ScaleRowInteger_AVX2(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount)
+	{
+		if (iFactor > 8)
+		{
+			// every source pixel fills at least one full vector
+			for (; iSrcCount > 0; --iSrcCount, ++pSrc)
+			{
+				const __m256i v = _mm256_set1_epi32(int(*pSrc));
+
+				uint32_t *const pEnd = pDest + iFactor;
+				for (; pDest + 8 <= pEnd; pDest += 8)
+				{
+					_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), v);
+				}
+				for (; pDest < pEnd; ++pDest)
+				{
+					*pDest = *pSrc;
+				}
+			}
+			_mm256_zeroupper();
+			return;
+		}
+
+		// 8 source pixels --> iFactor output vectors.
+		// lane j of output vector i contains source pixel (8 * i + j) / iFactor.
+		__m256i vIndices[8];
+		for (uint32_t i = 0; i < iFactor; ++i)
+		{
+			alignas(32) int iLanes[8];
+			for (uint32_t j = 0; j < 8; ++j)
+			{
+				iLanes[j] = int((8 * i + j) / iFactor);
+			}
+			vIndices[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(iLanes));
+		}
+
+		for (; iSrcCount >= 8; iSrcCount -= 8, pSrc += 8)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(pSrc));
+			for (uint32_t i = 0; i < iFactor; ++i, pDest += 8)
+			{
+				_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+					_mm256_permutevar8x32_epi32(v, vIndices[i]));
+			}
+		}
+		_mm256_zeroupper();
+
+		ScaleRowInteger_SSE2(pDest, pSrc, iFactor, iSrcCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void SampleRow_AVX2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piColumns, size_t iCount)
+	{
+		const int *const pSrc = reinterpret_cast<const int *>(pSrcRow);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, piColumns += 8)
+		{
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest), _mm256_i32gather_epi32(pSrc,
+				_mm256_loadu_si256(reinterpret_cast<const __m256i *>(piColumns)), 4));
+		}
+		_mm256_zeroupper();
+
+		SampleRow_Reference(pDest, pSrcRow, piColumns, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void ScaleRowInteger(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount)
+	{
+		static const ScaleRowIntegerFunc fnScaleRowInteger =
+			RLGAMECANVAS_SELECT_KERNEL(ScaleRowInteger);
+		fnScaleRowInteger(pDest, pSrc, iFactor, iSrcCount);
+	}
+
+	void SampleRow(uint32_t *pDest, const uint32_t *pSrcRow, const uint32_t *piColumns,
+		size_t iCount)
+	{
+#ifdef RLGAMECANVAS_X86
+		static const SampleRowFunc fnSampleRow =
+			SelectKernel(SampleRow_Reference, SampleRow_Reference, SampleRow_AVX2);
+#else
+		static const SampleRowFunc fnSampleRow = SampleRow_Reference;
+#endif
+		fnSampleRow(pDest, pSrcRow, piColumns, iCount);
+	}
+
+
+
+
+
+	void ExpandIndexedRow_Reference(uint32_t *pDest, const uint8_t *piSrc,
+		const uint32_t *pPalette, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			pDest[i] = pPalette[piSrc[i]];
+		}
+	}
+
+	void CopyIndexedRowKeyed_Reference(uint8_t *piDest, const uint8_t *piSrc, size_t iCount)
+	{
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			if (piSrc[i] != 0)
+				piDest[i] = piSrc[i];
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_AVX2
+	void ExpandIndexedRow_AVX2(uint32_t *pDest, const uint8_t *piSrc,
+		const uint32_t *pPalette, size_t iCount)
+	{
+		const int *const pTable = reinterpret_cast<const int *>(pPalette);
+
+		for (; iCount >= 8; iCount -= 8, pDest += 8, piSrc += 8)
+		{
+			const __m256i vIndices = _mm256_cvtepu8_epi32(
+				_mm_loadl_epi64(reinterpret_cast<const __m128i *>(piSrc)));
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(pDest),
+				_mm256_i32gather_epi32(pTable, vIndices, 4));
+		}
+		_mm256_zeroupper();
+
+		ExpandIndexedRow_Reference(pDest, piSrc, pPalette, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_SSE2
+	void CopyIndexedRowKeyed_SSE2(uint8_t *piDest, const uint8_t *piSrc, size_t iCount)
+	{
+		const __m128i vZero = _mm_setzero_si128();
+
+		for (; iCount >= 16; iCount -= 16, piDest += 16, piSrc += 16)
+		{
+			const __m128i vSrc  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(piSrc));
+			const __m128i vKeep = _mm_cmpeq_epi8(vSrc, vZero);
+			if (_mm_movemask_epi8(vKeep) == 0xFFFF)
+				continue; // all transparent
+
+			const __m128i vDest = _mm_loadu_si128(reinterpret_cast<const __m128i *>(piDest));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(piDest),
+				_mm_or_si128(_mm_and_si128(vKeep, vDest), vSrc));
+		}
+
+		CopyIndexedRowKeyed_Reference(piDest, piSrc, iCount);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void CopyIndexedRowKeyed_AVX2(uint8_t *piDest, const uint8_t *piSrc, size_t iCount)
+	{
+		const __m256i vZero = _mm256_setzero_si256();
+
+		for (; iCount >= 32; iCount -= 32, piDest += 32, piSrc += 32)
+		{
+			const __m256i vSrc  = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(piSrc));
+			const __m256i vKeep = _mm256_cmpeq_epi8(vSrc, vZero);
+			if (_mm256_movemask_epi8(vKeep) == -1)
+				continue; // all transparent
+
+			const __m256i vDest = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(piDest));
+			_mm256_storeu_si256(reinterpret_cast<__m256i *>(piDest),
+				_mm256_blendv_epi8(vSrc, vDest, vKeep));
+		}
+		_mm256_zeroupper();
+
+		CopyIndexedRowKeyed_SSE2(piDest, piSrc, iCount);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void ExpandIndexedRow(uint32_t *pDest, const uint8_t *piSrc, const uint32_t *pPalette,
+		size_t iCount)
+	{
+#ifdef RLGAMECANVAS_X86
+		static const ExpandIndexedRowFunc fnExpandIndexedRow = SelectKernel(
+			ExpandIndexedRow_Reference, ExpandIndexedRow_Reference, ExpandIndexedRow_AVX2);
+#else
+		static const ExpandIndexedRowFunc fnExpandIndexedRow = ExpandIndexedRow_Reference;
+#endif
+		fnExpandIndexedRow(pDest, piSrc, pPalette, iCount);
+	}
+
+	void CopyIndexedRowKeyed(uint8_t *piDest, const uint8_t *piSrc, size_t iCount)
+	{
+		static const CopyIndexedRowKeyedFunc fnCopyIndexedRowKeyed =
+			RLGAMECANVAS_SELECT_KERNEL(CopyIndexedRowKeyed);
+		fnCopyIndexedRowKeyed(piDest, piSrc, iCount);
+	}
+
+
+
+
+
+	void DiffRowBlocks_Reference(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged)
+	{
+		for (; iCount > 0; ++pbChanged)
+		{
+			const size_t iBlockPixels = std::min(iCount, iDiffBlockPixels);
+			if (!*pbChanged)
+				*pbChanged = memcmp(pA, pB, iBlockPixels * sizeof(uint32_t)) != 0;
+
+			pA     += iBlockPixels;
+			pB     += iBlockPixels;
+			iCount -= iBlockPixels;
+		}
+	}
+
+#ifdef RLGAMECANVAS_X86
+
+	RLGAMECANVAS_TARGET_SSE2
+	void DiffRowBlocks_SSE2(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged)
+	{
+		for (; iCount >= iDiffBlockPixels;
+			iCount -= iDiffBlockPixels, pA += iDiffBlockPixels, pB += iDiffBlockPixels, ++pbChanged)
+		{
+			if (*pbChanged)
+				continue;
+
+			const auto pvA = reinterpret_cast<const __m128i *>(pA);
+			const auto pvB = reinterpret_cast<const __m128i *>(pB);
+
+			const __m128i vEqual = _mm_and_si128(
+				_mm_and_si128(
+					_mm_cmpeq_epi32(_mm_loadu_si128(pvA + 0), _mm_loadu_si128(pvB + 0)),
+					_mm_cmpeq_epi32(_mm_loadu_si128(pvA + 1), _mm_loadu_si128(pvB + 1))
+				),
+				_mm_and_si128(
+					_mm_cmpeq_epi32(_mm_loadu_si128(pvA + 2), _mm_loadu_si128(pvB + 2)),
+					_mm_cmpeq_epi32(_mm_loadu_si128(pvA + 3), _mm_loadu_si128(pvB + 3))
+				)
+			);
+			*pbChanged = _mm_movemask_epi8(vEqual) != 0xFFFF;
+		}
+
+		DiffRowBlocks_Reference(pA, pB, iCount, pbChanged);
+	}
+
+	RLGAMECANVAS_TARGET_AVX2
+	void DiffRowBlocks_AVX2(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged)
+	{
+		for (; iCount >= iDiffBlockPixels;
+			iCount -= iDiffBlockPixels, pA += iDiffBlockPixels, pB += iDiffBlockPixels, ++pbChanged)
+		{
+			if (*pbChanged)
+				continue;
+
+			const auto pvA = reinterpret_cast<const __m256i *>(pA);
+			const auto pvB = reinterpret_cast<const __m256i *>(pB);
+
+			const __m256i vEqual = _mm256_and_si256(
+				_mm256_cmpeq_epi32(_mm256_loadu_si256(pvA + 0), _mm256_loadu_si256(pvB + 0)),
+				_mm256_cmpeq_epi32(_mm256_loadu_si256(pvA + 1), _mm256_loadu_si256(pvB + 1))
+			);
+			*pbChanged = _mm256_movemask_epi8(vEqual) != -1;
+		}
+		_mm256_zeroupper();
+
+		DiffRowBlocks_SSE2(pA, pB, iCount, pbChanged);
+	}
+
+#endif // RLGAMECANVAS_X86
+
+	void DiffRowBlocks(const uint32_t *pA, const uint32_t *pB, size_t iCount, bool *pbChanged)
+	{
+		static const DiffRowBlocksFunc fnDiffRowBlocks = RLGAMECANVAS_SELECT_KERNEL(DiffRowBlocks);
+		fnDiffRowBlocks(pA, pB, iCount, pbChanged);
+	}
+
+}
@@ -0,0 +1,69 @@
+#include "private/SoftwareCompositor.hpp"
+
+#include <algorithm> // std::fill, std::min
+
+
+
+namespace rlGameCanvasLib
+{
+
+	SoftwareCompositor::SoftwareCompositor(bool bPremultipliedAlpha, size_t iThreadCount) :
+		m_fnBlendRow(bPremultipliedAlpha ? BlendPremultipliedRow : BlendRow),
+		m_oWorkers(iThreadCount),
+		m_oRowBuffers(m_oWorkers.threadCount())
+	{ }
+
+	void SoftwareCompositor::compose(const Resolution &oFrameSize, const Layer *pcoLayers,
+		size_t iLayerCount, Pixel pxBackground, PixelInt *pFrame)
+	{
+		if (oFrameSize.x == 0 || oFrameSize.y == 0)
+			return;
+
+		if (m_iRowBufferSize < oFrameSize.x)
+		{
+			for (auto &up : m_oRowBuffers)
+			{
+				up = std::make_unique<PixelInt[]>(oFrameSize.x);
+			}
+			m_iRowBufferSize = oFrameSize.x;
+		}
+
+		const PixelInt pxOpaqueBackground = RLGAMECANVAS_MAKEPIXELOPAQUE(pxBackground.val);
+		const UInt     iBandCount         = (oFrameSize.y + iBandRows - 1) / iBandRows;
+
+		m_oWorkers.run(iBandCount, [&](size_t iBand, size_t iThread)
+			{
+				PixelInt *const pBuffer = m_oRowBuffers[iThread].get();
+
+				const UInt iBandTop    = UInt(iBand) * iBandRows;
+				const UInt iBandBottom = std::min(iBandTop + iBandRows, oFrameSize.y);
+				for (UInt iY = iBandTop; iY < iBandBottom; ++iY)
+				{
+					PixelInt *const pDest = pFrame + (size_t)iY * oFrameSize.x;
+					std::fill(pDest, pDest + oFrameSize.x, pxOpaqueBackground);
+
+					for (size_t iLayer = 0; iLayer < iLayerCount; ++iLayer)
+					{
+						const auto &layer = pcoLayers[iLayer];
+
+						// the layer repeats infinitely --> split the row where it wraps around
+						const UInt iLayerY = (iY + layer.oScreenPos.y) % layer.oSize.y;
+						UInt       iLayerX = layer.oScreenPos.x % layer.oSize.x;
+						for (UInt iX = 0; iX < oFrameSize.x;)
+						{
+							const UInt iCount =
+								std::min(oFrameSize.x - iX, layer.oSize.x - iLayerX);
+							const PixelInt *pSrc =
+								layer.fnGetRow(layer.pvLayer, iLayerX, iLayerY, iCount, pBuffer);
+							m_fnBlendRow(pDest + iX, pSrc, iCount);
+
+							iX     += iCount;
+							iLayerX = 0;
+						}
+					}
+				}
+			}
+		);
+	}
+
+}
@@ -0,0 +1,179 @@
+#include <rlGameCanvas++/Sprite.hpp>
+#include <rlGameCanvas++/BakedSprite.hpp> // SpriteBaking
+#include "private/Clipping.hpp"     // DeFactoCoords
+#include "private/PixelKernels.hpp" // BlendRow, BlendPremultipliedRow
+
+#include <algorithm> // std::min, std::max
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	namespace
+	{
+
+		void DrawSpans(Bitmap *poBase, const SpriteSpanView &oSprite, Int iSpriteX, Int iSpriteY,
+			BlendRowFunc fnBlendRow, DirtyRects *poDirtyRects)
+		{
+			UInt       iStartX, iStartY;
+			Resolution resVisible;
+			Rect       rectVisible;
+			if (!DeFactoCoords(poBase->size, iSpriteX, iSpriteY, oSprite.size,
+				iStartX, iStartY, resVisible, rectVisible)
+			)
+				return;
+
+			AddDirtyRect(poDirtyRects, rectVisible);
+
+			const UInt iEndX = iStartX + resVisible.x;
+
+			uint32_t *pDestRow = poBase->ppxData +
+				((size_t)rectVisible.iTop * poBase->size.x + rectVisible.iLeft);
+			for (UInt iY = iStartY; iY < iStartY + resVisible.y; ++iY, pDestRow += poBase->size.x)
+			{
+				for (size_t iSpan = oSprite.pcoRowStart[iY]; iSpan < oSprite.pcoRowStart[iY + 1];
+					++iSpan)
+				{
+					const SpriteSpan &span = oSprite.pcoSpans[iSpan];
+					if (span.iX >= iEndX)
+						break; // the spans are sorted --> all following spans are clipped, too
+
+					const UInt iFirst = std::max(span.iX, iStartX);
+					const UInt iLast  = std::min(span.iX + span.iLength, iEndX);
+					if (iFirst >= iLast)
+						continue;
+
+					const size_t iCount = iLast - iFirst;
+					const uint32_t *pSrc  =
+						oSprite.pcoPixels + span.iDataOffset + (iFirst - span.iX);
+					uint32_t       *pDest = pDestRow + (iFirst - iStartX);
+
+					if (span.bOpaque)
+						memcpy_s(pDest, iCount * sizeof(uint32_t), pSrc, iCount * sizeof(uint32_t));
+					else
+						fnBlendRow(pDest, pSrc, iCount);
+				}
+			}
+		}
+
+		bool GetSpriteBlendRowFunc(BitmapOverlayStrategy eOverlayStrategy,
+			BlendRowFunc &fnBlendRow)
+		{
+			switch (eOverlayStrategy)
+			{
+			case BitmapOverlayStrategy::Blend:
+				fnBlendRow = BlendRow;
+				return true;
+
+			case BitmapOverlayStrategy::BlendPremultiplied:
+				fnBlendRow = BlendPremultipliedRow;
+				return true;
+
+			default:
+				return false;
+			}
+		}
+
+	}
+
+
+
+	class Sprite::PIMPL final
+	{
+	public: // methods
+
+		// the spans are compiled exactly like the ones of a BakedSprite.
+		PIMPL(const Bitmap &bmp) : m_oSize(bmp.size)
+		{
+			std::vector<SpriteRunType> oTypes(bmp.size.x);
+
+			const auto oCounts = SpriteBaking::BakeRows(bmp.ppxData, bmp.size, oTypes.data(),
+				nullptr, nullptr, nullptr);
+
+			m_oSpans   .resize(oCounts.iSpans);
+			m_oRowStart.resize((size_t)bmp.size.y + 1);
+			m_oPixels  .resize(oCounts.iPixels);
+			SpriteBaking::BakeRows(bmp.ppxData, bmp.size, oTypes.data(),
+				m_oSpans.data(), m_oRowStart.data(), m_oPixels.data());
+		}
+
+		const Resolution &size() const { return m_oSize; }
+
+		SpriteSpanView view() const
+		{
+			return { m_oSize, m_oSpans.data(), m_oRowStart.data(), m_oPixels.data() };
+		}
+
+
+	private: // variables
+
+		Resolution              m_oSize;
+		std::vector<SpriteSpan> m_oSpans;
+		std::vector<size_t>     m_oRowStart; // index of the first span of every row + end index
+		std::vector<PixelInt>   m_oPixels;   // pixel data of all spans
+
+	};
+
+
+
+	Sprite::Sprite(const Bitmap &bmp) : m_pPIMPL(new PIMPL(bmp)) {}
+
+	Sprite::Sprite(Sprite &&rval) noexcept : m_pPIMPL(rval.m_pPIMPL)
+	{
+		rval.m_pPIMPL = nullptr;
+	}
+
+	Sprite::~Sprite() { delete m_pPIMPL; }
+
+	Sprite &Sprite::operator=(Sprite &&rval) noexcept
+	{
+		if (&rval == this)
+			return *this;
+
+		delete m_pPIMPL;
+		m_pPIMPL      = rval.m_pPIMPL;
+		rval.m_pPIMPL = nullptr;
+
+		return *this;
+	}
+
+	const Resolution &Sprite::size() const { return m_pPIMPL->size(); }
+
+
+
+	bool ApplySpriteOverlay(
+		Bitmap               *poBase,
+		const Sprite         &oSprite,
+		Int                   iSpriteX,
+		Int                   iSpriteY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		if (poBase == nullptr || oSprite.m_pPIMPL == nullptr)
+			return false;
+
+		return ApplySpriteOverlay(poBase, oSprite.m_pPIMPL->view(), iSpriteX, iSpriteY,
+			eOverlayStrategy, poDirtyRects);
+	}
+
+	bool ApplySpriteOverlay(
+		Bitmap               *poBase,
+		const SpriteSpanView &oSprite,
+		Int                   iSpriteX,
+		Int                   iSpriteY,
+		BitmapOverlayStrategy eOverlayStrategy,
+		DirtyRects           *poDirtyRects
+	)
+	{
+		BlendRowFunc fnBlendRow = nullptr;
+		if (poBase == nullptr || !GetSpriteBlendRowFunc(eOverlayStrategy, fnBlendRow))
+			return false;
+
+		DrawSpans(poBase, oSprite, iSpriteX, iSpriteY, fnBlendRow, poDirtyRects);
+		return true;
+	}
+
+}
@@ -0,0 +1,108 @@
+#include "private/WorkerPool.hpp"
+
+#include <algorithm> // std::max
+
+
+
+namespace rlGameCanvasLib
+{
+
+	WorkerPool::WorkerPool(size_t iThreadCount)
+	{
+		if (iThreadCount == 0)
+			iThreadCount = std::max(1u, std::thread::hardware_concurrency());
+
+		m_oThreads.reserve(iThreadCount - 1);
+		for (size_t i = 1; i < iThreadCount; ++i)
+		{
+			try
+			{
+				m_oThreads.emplace_back(&WorkerPool::workerProc, this, i);
+			}
+			catch (...)
+			{
+				break; // couldn't create another thread --> continue with the existing ones
+			}
+		}
+	}
+
+	WorkerPool::~WorkerPool()
+	{
+		{
+			std::unique_lock lock(m_mux);
+			m_bQuit = true;
+		}
+		m_cvStart.notify_all();
+
+		for (auto &t : m_oThreads)
+		{
+			t.join();
+		}
+	}
+
+	void WorkerPool::run(size_t iTaskCount, const TaskFunc &fnTask)
+	{
+		if (iTaskCount == 0)
+			return;
+
+		// not worth waking up the other threads
+		if (iTaskCount == 1 || m_oThreads.empty())
+		{
+			for (size_t iTask = 0; iTask < iTaskCount; ++iTask)
+			{
+				fnTask(iTask, 0);
+			}
+			return;
+		}
+
+		{
+			std::unique_lock lock(m_mux);
+			m_pfnTask      = &fnTask;
+			m_iTaskCount   = iTaskCount;
+			m_iNextTask    = 0;
+			m_iBusyThreads = m_oThreads.size();
+			++m_iGeneration;
+		}
+		m_cvStart.notify_all();
+
+		work(0);
+
+		std::unique_lock lock(m_mux);
+		m_cvDone.wait(lock, [&] { return m_iBusyThreads == 0; });
+		m_pfnTask = nullptr;
+	}
+
+	void WorkerPool::workerProc(size_t iThread)
+	{
+		uint64_t iLastGeneration = 0;
+		while (true)
+		{
+			{
+				std::unique_lock lock(m_mux);
+				m_cvStart.wait(lock, [&] { return m_bQuit || m_iGeneration != iLastGeneration; });
+				if (m_bQuit)
+					return;
+				iLastGeneration = m_iGeneration;
+			}
+
+			work(iThread);
+
+			bool bLast;
+			{
+				std::unique_lock lock(m_mux);
+				bLast = --m_iBusyThreads == 0;
+			}
+			if (bLast)
+				m_cvDone.notify_one();
+		}
+	}
+
+	void WorkerPool::work(size_t iThread)
+	{
+		for (size_t iTask = m_iNextTask++; iTask < m_iTaskCount; iTask = m_iNextTask++)
+		{
+			(*m_pfnTask)(iTask, iThread);
+		}
+	}
+
+}
@@ -0,0 +1,100 @@
+/*
+	ARENA
+	A single block of memory that the buffers of all layers of a mode are carved from.
+
+	One big allocation instead of many per-layer ones keeps mode switches cheap, and every buffer
+	starts on its own cache line, so vectorized row loops never share a line with another buffer.
+	Big arenas can use large pages, so passes over whole layers need fewer TLB entries.
+*/
+#ifndef RLGAMECANVAS_ARENA
+#define RLGAMECANVAS_ARENA
+
+
+
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	// Where the memory of an arena comes from.
+	struct ArenaAllocator
+	{
+		// Custom allocator; either both or none must be set.
+		void *(__stdcall *fnAllocate)(size_t iSize, size_t iAlignment) = nullptr;
+		void  (__stdcall *fnFree)(void *pvData)                        = nullptr;
+
+		// Use large pages for arenas of at least one large page, if possible.
+		// Ignored with a custom allocator.
+		bool bLargePages = false;
+	};
+
+
+
+	class Arena final
+	{
+	public: // static variables
+
+		static constexpr size_t iAlignment = 64; // a cache line
+
+
+	public: // static methods
+
+		// Round a size up to the next multiple of iAlignment.
+		static constexpr size_t AlignSize(size_t iSize)
+		{
+			return (iSize + iAlignment - 1) & ~(iAlignment - 1);
+		}
+
+
+	public: // methods
+
+		Arena() = default;
+		Arena(const Arena &) = delete;
+		Arena(Arena &&other) noexcept;
+		~Arena() { deallocate(); }
+
+		Arena &operator=(Arena &&other) noexcept;
+
+		// (Re-)allocate the arena, aligned to iAlignment and filled with zeros.
+		// Throws std::bad_alloc on failure.
+		void allocate(size_t iSize, const ArenaAllocator &oAllocator = {});
+		void deallocate();
+
+		uint8_t *data() const { return m_pData; }
+		size_t size() const { return m_iSize; }
+		bool largePages() const { return m_eSource == Source::LargePages; }
+
+
+	private: // types
+
+		enum class Source
+		{
+			None,
+			Heap,
+			Pages,
+			LargePages,
+			Custom
+		};
+
+
+	private: // variables
+
+		uint8_t       *m_pData   = nullptr;
+		size_t         m_iSize   = 0;
+		Source         m_eSource = Source::None;
+		ArenaAllocator m_oAllocator;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_ARENA
\ No newline at end of file
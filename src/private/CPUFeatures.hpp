@@ -0,0 +1,48 @@
+/*
+	CPU FEATURE DETECTION
+	Runtime detection of the instruction set extensions that can be used by the pixel kernels.
+*/
+#ifndef RLGAMECANVAS_CPUFEATURES
+#define RLGAMECANVAS_CPUFEATURES
+
+
+
+
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define RLGAMECANVAS_X86
+#endif
+
+#ifdef RLGAMECANVAS_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC allows the use of all intrinsics, no matter the /arch setting.
+#define RLGAMECANVAS_TARGET_SSE2
+#define RLGAMECANVAS_TARGET_AVX2
+#else
+#define RLGAMECANVAS_TARGET_SSE2 __attribute__((target("sse2")))
+#define RLGAMECANVAS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif // RLGAMECANVAS_X86
+
+
+
+namespace rlGameCanvasLib
+{
+
+	struct CPUFeatures
+	{
+		bool bSSE2 = false;
+		bool bAVX2 = false;
+	};
+
+	// Get the instruction set extensions supported by both the CPU and the operating system.
+	// The detection only runs on the first call.
+	const CPUFeatures &GetCPUFeatures();
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_CPUFEATURES
\ No newline at end of file
@@ -0,0 +1,55 @@
+/*
+	CLIPPING
+	Clipping logic shared by the functions that draw onto bitmaps.
+*/
+#ifndef RLGAMECANVAS_CLIPPING
+#define RLGAMECANVAS_CLIPPING
+
+
+
+
+
+#include <rlGameCanvas++/Blit.hpp> // ClipBlit
+
+
+
+namespace rlGameCanvasLib
+{
+
+	// Clip an overlay of size resOverlay at position (iOverlayX, iOverlayY) to a bitmap of size
+	// resDest.
+	// 
+	// iStartX, iStartY: The first visible pixel of the overlay.
+	// resVisible:       The size of the visible part of the overlay.
+	// rectVisible:      The visible part of the overlay, in coordinates of the destination.
+	// 
+	// Returns false if the overlay is completely invisible (output values are undefined then).
+	inline bool DeFactoCoords(
+		const Resolution &resDest,
+		Int iOverlayX, Int iOverlayY, const Resolution &resOverlay,
+		UInt &iStartX, UInt &iStartY,       Resolution &resVisible,
+		Rect &rectVisible
+	)
+	{
+		BlitClipping oClipping;
+		if (!ClipBlit(resDest, iOverlayX, iOverlayY, resOverlay, oClipping))
+			return false;
+
+		iStartX     = oClipping.iSrcX;
+		iStartY     = oClipping.iSrcY;
+		rectVisible = oClipping.rectDest;
+		resVisible  =
+		{
+			/* x */ rectVisible.iRight  - rectVisible.iLeft,
+			/* y */ rectVisible.iBottom - rectVisible.iTop
+		};
+		return true;
+	}
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_CLIPPING
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*
+	COMPOSITOR
+	Draws all visible layers to the screen in a single pass.
+
+	The layers live in the slices of one texture array. A fragment shader samples every visible
+	layer at the canvas pixel, blends them over the background color and scales the result to the
+	drawing area via "sharp bilinear" filtering: the canvas is scaled up by the integer pixel size
+	via nearest neighbor, the remaining non-integer scaling is done via linear interpolation.
+	This gives the same image as rendering to an integer scaled framebuffer first, without the
+	extra pass.
+*/
+#ifndef RLGAMECANVAS_COMPOSITOR
+#define RLGAMECANVAS_COMPOSITOR
+
+
+
+
+
+#include <rlGameCanvas++/Types.hpp>
+
+#include <gl/GL.h>
+#include <cstddef>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class OpenGL;
+
+
+
+	class Compositor final
+	{
+	public: // types
+
+		struct LayerParams
+		{
+			GLint      iSlice;     // slice of the texture array
+			Resolution oSize;      // size of the layer, in pixels
+			Resolution oScreenPos; // the layer's pixel that's drawn to the top left of the canvas
+		};
+
+		struct FrameParams
+		{
+			Resolution oScreenSize; // size of the canvas, in pixels
+			Resolution oClientSize; // size of the window's client area
+			Rect       oDrawRect;   // area of the client area the canvas is drawn to
+			UInt       iPixelSize;  // integer scaling factor
+			Pixel      pxBackground;
+		};
+
+
+	public: // static variables
+
+		// The maximum number of layers the shader can composite at once.
+		// Modes with more layers are drawn the old way.
+		static constexpr size_t iMaxLayers = 16;
+
+
+	public: // methods
+
+		// Compiles the shader right away; check valid() afterwards.
+		Compositor(const OpenGL &gl, bool bPremultipliedAlpha);
+		Compositor(const Compositor &) = delete;
+		~Compositor();
+
+		bool valid() const { return m_iProgram != 0; }
+
+		// (Re-)allocate the texture array. The contents are undefined afterwards.
+		// Every slice is iWidth x iHeight pixels, smaller layers only use the top left part.
+		// Returns false on failure.
+		bool createTextureArray(GLsizei iWidth, GLsizei iHeight, GLsizei iSlices);
+		void bindTextureArray() const;
+
+		// Upload RGBA pixels to a part of a slice of the texture array.
+		// The texture array must be bound.
+		void texSubImage(GLint iSlice, GLint iX, GLint iY, GLsizei iWidth, GLsizei iHeight,
+			const void *pData) const;
+
+		// Draw the layers to the default framebuffer, bottom layer first.
+		// iLayerCount must not exceed iMaxLayers.
+		void draw(const FrameParams &oFrame, const LayerParams *pcoLayers, size_t iLayerCount);
+
+
+	private: // methods
+
+		GLuint compileShader(GLenum eType, const char *szSource);
+
+
+	private: // variables
+
+		const OpenGL &m_oGL;
+
+		GLuint m_iProgram      = 0;
+		GLuint m_iTextureArray = 0;
+
+		// uniform locations
+		GLint m_iUniLayerCount  = -1;
+		GLint m_iUniLayers      = -1;
+		GLint m_iUniSlices      = -1;
+		GLint m_iUniBackground  = -1;
+		GLint m_iUniScreenSize  = -1;
+		GLint m_iUniDrawOrigin  = -1;
+		GLint m_iUniDrawScale   = -1;
+		GLint m_iUniPixelSize   = -1;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_COMPOSITOR
\ No newline at end of file
@@ -0,0 +1,39 @@
+/*
+	DIRTY RECTANGLES
+	Handling of the changed areas of a layer, so they can be uploaded with as few calls as possible.
+
+	Doesn't depend on OpenGL, so the logic can be tested without a rendering context.
+*/
+#ifndef RLGAMECANVAS_DIRTYRECTS
+#define RLGAMECANVAS_DIRTYRECTS
+
+
+
+
+
+#include <rlGameCanvas++/Types.hpp>
+
+#include <cstddef>
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	// Clip a rectangle to an area of the given size.
+	// Returns false if nothing of the rectangle is left.
+	bool ClipRect(Rect &rect, const Resolution &size);
+
+	// Merge rectangles whose bounding box is cheaper to upload than the rectangles themselves,
+	// with every single upload costing an additional iOverheadPixels.
+	// Rectangles that are contained in other ones are always merged.
+	void MergeDirtyRects(std::vector<Rect> &oRects, size_t iOverheadPixels);
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_DIRTYRECTS
\ No newline at end of file
@@ -7,9 +7,12 @@
 
 #include <rlGameCanvas++/GameCanvas.hpp>
 
+#include "Compositor.hpp"
 #include "GraphicsData.hpp"
+#include "GraphicsDataCache.hpp"
 #include "OpenGL.hpp"
 #include "PrivateTypes.hpp"
+#include "SoftwareCompositor.hpp"
 
 #include <gl/GL.h>
 
@@ -42,10 +45,15 @@ namespace rlGameCanvasLib
 			Stop          // canvas is being shut down
 		};
 
+		// The maximum number of dirty rectangles per layer and frame.
+		constexpr UInt iMaxDirtyRectsPerFrame = 64;
+
 		struct LayerSettings
 		{
 			rlGameCanvas_Bool bVisible;
 			Resolution        oScreenPos;
+			DirtyRects        oDirtyRects;
+			Rect              oDirtyRectStorage[iMaxDirtyRectsPerFrame];
 		};
 
 	}
@@ -75,6 +83,7 @@ namespace rlGameCanvasLib
 		// interface methods =======================================================================
 		bool run();
 		void quit();
+		UploadStatistics getUploadStatistics() const;
 		// =========================================================================================
 
 
@@ -86,8 +95,9 @@ namespace rlGameCanvasLib
 		// Creates graphics data, maybe sets the window size and calculates the drawing area.
 		void initializeCurrentMode();
 
-		// (Re-)create the actual graphics data.
-		// Requires m_iCurrentMode to be up to date.
+		// (Re-)create the actual graphics data, or restore it from the cache.
+		// The data of the previous mode is put into the cache.
+		// Requires m_iCurrentMode to be up to date. Updates m_bRestoredMode.
 		void createGraphicsData();
 
 		void enterFullscreenMode();
@@ -149,6 +159,9 @@ namespace rlGameCanvasLib
 		WINDOWPLACEMENT m_wndpl = {};
 
 		std::unique_ptr<OpenGL> m_upOpenGL; // extended OpenGL interface
+		std::unique_ptr<OpenGLPixelBufferAPI> m_upPixelBufferAPI; // nullptr if not supported
+		std::unique_ptr<Compositor> m_upCompositor; // nullptr if not supported
+		std::unique_ptr<SoftwareCompositor> m_upSoftwareCompositor; // nullptr if not requested
 
 		bool   m_bFBO                    = false;
 		GLuint m_iIntScaledBufferFBO     = 0;
@@ -198,6 +211,10 @@ namespace rlGameCanvasLib
 		const WinMsgCallback       m_fnOnWinMsg;
 		std::vector<Mode_CPP>      m_oModes;
 		const bool                 m_bPreferPixelPerfect;
+		const bool                 m_bPremultipliedAlpha;
+		const bool                 m_bDirtyRects;
+		const bool                 m_bSoftwareCompositing;
+		const ArenaAllocator       m_oArenaAllocator;
 		bool                       m_bRestrictCursor;
 		// configurable data: runtime ==============================================================
 		bool         m_bHideCursor;
@@ -210,7 +227,8 @@ namespace rlGameCanvasLib
 		double m_dTimeSinceLastMouseMove = 0.0;
 		bool   m_bHideCursorEx = false;
 
-		bool m_bNewMode = true;
+		bool m_bNewMode      = true;
+		bool m_bRestoredMode = false; // only valid if m_bNewMode is true
 
 
 
@@ -224,12 +242,18 @@ namespace rlGameCanvasLib
 		void *m_pvState_Updating = nullptr; // for access in update callback
 		void *m_pvState_Drawing  = nullptr; // for access in draw callback
 
-		GraphicsData m_oGraphicsData;
+		GraphicsData      m_oGraphicsData;
+		UInt              m_iGraphicsDataMode = 0; // the mode m_oGraphicsData belongs to
+		GraphicsDataCache m_oGraphicsDataCache;
 		std::unique_ptr<LayerData[]> m_oLayersForCallback;
 		std::unique_ptr<LayerData[]> m_oLayersForCallback_Copy;
 		size_t m_iLayersForCallback_Size;
 		std::unique_ptr<LayerSettings[]> m_oLayerSettings;
 
+		// copy of the graphics data's statistics, for access from other threads
+		mutable std::mutex m_muxStatistics;
+		UploadStatistics   m_oStatistics = {};
+
 
 		bool m_bGraphicsThread_NewViewport = true;
 		bool m_bGraphicsThread_NewFBOSize  = true;
@@ -7,7 +7,11 @@
 
 #include <rlGameCanvas++/Types.hpp>
 #include <rlGameCanvas++/Pixel.hpp>
+#include "Arena.hpp"
+#include "Compositor.hpp"
+#include "PixelBufferRing.hpp"
 #include "PrivateTypes.hpp"
+#include "SoftwareCompositor.hpp"
 
 namespace lib = rlGameCanvasLib;
 
@@ -19,39 +23,202 @@ namespace lib = rlGameCanvasLib;
 
 class GraphicsData final
 {
+public: // types
+
+	enum class LayerFormat
+	{
+		RGBA,
+		Indexed8,
+		Tilemap
+	};
+
+
 private: // types
 
 	class Layer final
 	{
 	public: // methods
 
-		Layer(const Layer &other);
-		Layer(GLsizei iWidth, GLsizei iHeight, const lib::Resolution &oScreenPos,
-			const lib::Resolution &oScreenSize);
+		// pPixelBufferAPI can be nullptr, then all uploads are done directly from client memory.
+		// pCompositor can be nullptr, then the layer has its own texture. Otherwise, the layer is
+		// uploaded to slice iSlice of the compositor's texture array.
+		// The layer can't be used before assignMemory() was called.
+		Layer(const lib::LayerMetadata &oSetup, const lib::Tileset &oTileset,
+			const lib::Resolution &oScreenSize, lib::PixelBufferAPI *pPixelBufferAPI,
+			lib::Compositor *pCompositor, GLint iSlice);
+		Layer(const Layer &) = delete;
+		Layer(Layer &&other) noexcept;
 		~Layer();
 
+		// The size of the layer's buffers in the arena, in bytes.
+		size_t memorySize() const;
+		// Carve the layer's buffers from the arena, starting at pMemory.
+		// pMemory must be aligned to lib::Arena::iAlignment, filled with zeros and provide at
+		// least memorySize() bytes.
+		void assignMemory(uint8_t *pMemory);
+
 		GLsizei width()  const { return m_iWidth;  }
 		GLsizei height() const { return m_iHeight; }
-		lib::Pixel *scanline(lib::UInt iY) { return m_up_pxData.get() + (iY * m_iWidth); }
+		// The distance between two rows of an RGBA layer, in pixels.
+		GLsizei stride() const { return m_iStride; }
+		LayerFormat format() const { return m_eFormat; }
+		// nullptr for all layers that aren't RGBA layers.
+		// If the layer is persistently mapped, the pointer changes on every upload.
+		lib::Pixel *scanline(lib::UInt iY)
+		{
+			return m_pxData ? m_pxData + (iY * m_iStride) : nullptr;
+		}
+		// nullptr for all layers that aren't indexed layers
+		uint8_t *indexedScanline(lib::UInt iY)
+		{
+			return m_piIndexData ? m_piIndexData + (iY * m_iWidth) : nullptr;
+		}
+		// nullptr for all layers that aren't indexed layers
+		lib::Pixel *palette() { return m_pxPalette; }
+		// nullptr for all layers that aren't tilemap layers
+		lib::TileIndex *tiles() { return m_piTiles; }
+		// in tiles
+		const lib::Resolution &tilemapSize() const { return m_oMapSize; }
 
 		const lib::Resolution &getScreenPos() const { return m_oScreenPos; }
 		void setScreenPos(const lib::Resolution &oScreenPos);
 
-		void drawFilling();
-		void drawAtIntCoords(GLint iLeft, GLint iTop, GLint iRight, GLint iBottom);
+		// Mark areas of the layer as changed, so they're uploaded on the next draw.
+		// Ignored for tilemap layers and layers with change detection, as they keep track of their
+		// changes on their own.
+		void markDirty(const lib::Rect *pcoRects, size_t iCount);
+		void markAllDirty();
+
+		// Upload the changes to the texture without drawing anything.
+		void upload(lib::UploadStatistics &oStatistics);
+		lib::Compositor::LayerParams compositorParams() const
+		{
+			return { m_iSlice, { lib::UInt(m_iWidth), lib::UInt(m_iHeight) }, m_oScreenPos };
+		}
+		lib::SoftwareCompositor::Layer softwareLayer() const;
+
+		// Forget what's in the texture, so the next upload includes everything.
+		void invalidateTexture();
+
+		// The estimated memory used by the layer, in bytes, in system and video memory.
+		size_t memoryUsage() const;
+
+		void drawFilling(lib::UploadStatistics &oStatistics);
+		void drawAtIntCoords(GLint iLeft, GLint iTop, GLint iRight, GLint iBottom,
+			lib::UploadStatistics &oStatistics);
+
+
+	private: // static methods
+
+		// SoftwareCompositor::GetRowFunc implementations; pvLayer points to the Layer.
+		static const lib::PixelInt *GetRowRGBA(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt iCount, lib::PixelInt *pBuffer);
+		static const lib::PixelInt *GetRowIndexed(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt iCount, lib::PixelInt *pBuffer);
+		static const lib::PixelInt *GetRowTilemap(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt iCount, lib::PixelInt *pBuffer);
+
+
+	private: // types
+
+		// The sizes of the buffers in the arena, in bytes, in the order they're carved out.
+		// 0 = the layer doesn't use the buffer.
+		struct BufferSizes
+		{
+			size_t iPixels;
+			size_t iIndexData;
+			size_t iPalette;
+			size_t iShadow;
+			size_t iChangedBlocks;
+			size_t iTiles;         // the current tiles and the uploaded tiles, each
+			size_t iStaging;
+		};
 
 
 	private: // methods
 
-		void upload();
+		BufferSizes bufferSizes() const;
+
+		// Point m_pxData to the arena memory or the current frame of the mapped buffer.
+		void initPixelPointer();
+
+		// Upload RGBA pixels to the currently bound texture and count them.
+		void texSubImage(lib::UploadStatistics &oStatistics, GLint iX, GLint iY,
+			GLsizei iWidth, GLsizei iHeight, const void *pData);
+
+		void uploadRGBA(lib::UploadStatistics &oStatistics);
+		void uploadMapped(lib::UploadStatistics &oStatistics);
+		void uploadIndexed(lib::UploadStatistics &oStatistics);
+		void uploadIndexedRect(const lib::Rect &rect, lib::UploadStatistics &oStatistics);
+		void uploadTilemap(lib::UploadStatistics &oStatistics);
+
+		// Upload the dirty rectangles via the next pixel buffer of the ring.
+		// fnCopyRow(pDest, rect, iY) must write row iY of rect to pDest.
+		// Returns false if the pixel buffers can't be used this time.
+		template <typename TCopyRow>
+		bool uploadStreamed(lib::UploadStatistics &oStatistics, TCopyRow fnCopyRow);
+
+		// Compare the layer to the shadow copy and collect the changed tiles as dirty rectangles.
+		// Also updates the shadow copy.
+		void detectChanges(lib::UploadStatistics &oStatistics);
+
+		// Get a pointer to the top left pixel of a tile.
+		// nullptr for tiles outside of the tileset (= transparent tiles).
+		const lib::PixelInt *tilePixels(lib::TileIndex iTile) const;
 
 
 	private: // variables
 
-		GLuint m_iTextureID = 0;
+		GLuint m_iTextureID = 0; // only used without a compositor
+		lib::Compositor *const m_pCompositor;
+		const GLint m_iSlice;
+		bool m_bUploaded = false;
 		const GLsizei m_iWidth, m_iHeight;
 		const lib::Resolution m_oScreenSize;
-		const std::unique_ptr<lib::Pixel[]> m_up_pxData;
+		const LayerFormat m_eFormat;
+		const bool m_bDetectChanges;
+		const GLsizei m_iStride; // RGBA layers only, the width otherwise
+
+		// The raw buffer pointers below point into the arena of the graphics data.
+
+		// RGBA layers only, if supported: the pixels live in a persistently mapped buffer, so they
+		// can be uploaded without copying them first. The mapping is readable, as blending and
+		// change detection read the pixels.
+		std::unique_ptr<lib::PersistentPixelBuffer> m_up_oMappedData;
+		// the areas of every frame of the mapped buffer that are older than the latest frame
+		std::vector<lib::Rect> m_oMissingRects[lib::PersistentPixelBuffer::iMaxFrameCount];
+		bool m_bMissingAll[lib::PersistentPixelBuffer::iMaxFrameCount] = {};
+
+		lib::Pixel *m_pxHeapData  = nullptr; // RGBA layers without mapping only
+		lib::Pixel *m_pxData      = nullptr; // RGBA layers only: the current pixels
+		uint8_t    *m_piIndexData = nullptr; // indexed layers only
+		lib::Pixel *m_pxPalette   = nullptr; // indexed layers only, 256 entries
+
+		// RGBA layers with change detection only: copy of the pixels in the texture + the changed
+		// blocks of the current row of tiles
+		lib::Pixel *m_pxShadow        = nullptr;
+		bool       *m_pbChangedBlocks = nullptr;
+
+		// tilemap layers only
+		const lib::Tileset &m_oTileset;
+		const lib::Resolution m_oMapSize;    // in tiles
+		const lib::UInt m_iTilesetColumns;   // tiles per row of the tileset
+		const lib::UInt m_iTilesetTileCount;
+		lib::TileIndex *m_piTiles         = nullptr;
+		lib::TileIndex *m_piUploadedTiles = nullptr; // the tiles in the texture
+		bool m_bTilesUploaded = false;
+
+		// indexed and tilemap layers only: staging area for the colors of a band of rows, so
+		// there's no need for a full-size RGBA copy of the layer.
+		const GLsizei m_iStagingRows;
+		lib::Pixel *m_pxStaging = nullptr;
+
+		// RGBA and indexed layers only, if supported: ring of pixel buffers for the uploads
+		std::unique_ptr<lib::PixelBufferRing> m_up_oPixelBuffers;
+
+		// the areas that changed since the last upload
+		std::vector<lib::Rect> m_oDirtyRects;
+		bool m_bAllDirty = true;
 
 		lib::Resolution m_oScreenPos = {};
 		float m_fTexLeft   = 0.0f;
@@ -64,11 +231,44 @@ private: // types
 
 public: // methods
 
-	bool create(const lib::Mode_CPP &mode);
+	// The pointers can be nullptr, otherwise they must outlive the graphics data.
+	// The compositor is only used if it can handle the mode's layers, see composited().
+	// If a software compositor is passed, the compositor is ignored; the layers are flattened
+	// into a single frame via compose() and only that frame is drawn.
+	// The buffers of all layers are allocated at once via oAllocator.
+	bool create(const lib::Mode_CPP &mode, lib::PixelBufferAPI *pPixelBufferAPI = nullptr,
+		lib::Compositor *pCompositor = nullptr,
+		lib::SoftwareCompositor *pSoftwareCompositor = nullptr,
+		const lib::ArenaAllocator &oAllocator = {});
 	void destroy();
+	bool empty() const { return m_oLayers.empty(); }
+
+	// Exchange the data of the current mode with another object, e.g. a cached one.
+	// The statistics aren't exchanged, as they're summed up over all modes.
+	void swapModeData(GraphicsData &other);
+	// Prepare data that was swapped in again after another mode was active.
+	// The compositor's texture array is shared by all modes, so it's reallocated and the layers
+	// are uploaded completely on the next draw. Layers with their own texture are kept as they
+	// are. Returns false on failure, the data must be recreated then.
+	bool restore();
+
+	// The estimated memory used by the mode, in bytes, in system and video memory.
+	// Slices of the compositor's texture array are not included, as the array is shared.
+	size_t memoryUsage() const;
 
 
 	lib::Pixel *scanline(size_t iLayer, lib::UInt iY) { return m_oLayers[iLayer].scanline(iY); }
+	lib::UInt stride(size_t iLayer) const { return lib::UInt(m_oLayers[iLayer].stride()); }
+	uint8_t *indexedScanline(size_t iLayer, lib::UInt iY)
+	{
+		return m_oLayers[iLayer].indexedScanline(iY);
+	}
+	lib::Pixel *palette(size_t iLayer) { return m_oLayers[iLayer].palette(); }
+	lib::TileIndex *tiles(size_t iLayer) { return m_oLayers[iLayer].tiles(); }
+	const lib::Resolution &tilemapSize(size_t iLayer) const
+	{
+		return m_oLayers[iLayer].tilemapSize();
+	}
 
 	void setScreenPos(size_t iLayer, const lib::Resolution &oScreenPos)
 	{
@@ -79,15 +279,45 @@ public: // methods
 		return m_oLayers[iLayer].getScreenPos();
 	}
 	void setVisible  (size_t iLayer, bool bVisible) { m_oVisible[iLayer] = bVisible; }
+	bool isVisible   (size_t iLayer) const { return m_oVisible[iLayer]; }
+
+	void markDirty(size_t iLayer, const lib::Rect *pcoRects, size_t iCount)
+	{
+		m_oLayers[iLayer].markDirty(pcoRects, iCount);
+	}
+	void markAllDirty(size_t iLayer) { m_oLayers[iLayer].markAllDirty(); }
+
+	// Software compositor only: flatten the visible layers into the frame that's drawn by
+	// draw() and draw_Legacy().
+	void compose(const lib::Pixel &pxBackground);
 
 	void draw();
 	void draw_Legacy(const lib::Rect &oDrawRect);
 
+	// Are the layers drawn via the compositor passed to create()?
+	bool composited() const { return m_pCompositor != nullptr; }
+	// Draw all visible layers via the compositor in a single pass.
+	// Only valid if composited() is true.
+	void draw_Composited(const lib::Compositor::FrameParams &oFrame);
+
+	// Not reset by destroy(), so the values are summed up over all modes.
+	const lib::UploadStatistics &statistics() const { return m_oStatistics; }
+
 
 private: // variables
 
+	lib::Arena         m_oArena; // the buffers of all layers, including the frame
 	std::vector<Layer> m_oLayers;
 	std::vector<bool>  m_oVisible;
+	lib::Compositor   *m_pCompositor = nullptr;
+
+	// software compositor only
+	lib::SoftwareCompositor *m_pSoftwareCompositor = nullptr;
+	lib::Resolution          m_oScreenSize = {};
+	std::unique_ptr<Layer>   m_up_oFrame; // the flattened layers
+	std::vector<lib::SoftwareCompositor::Layer> m_oSoftwareLayers; // the visible layers
+
+	lib::UploadStatistics m_oStatistics = {};
 
 };
 
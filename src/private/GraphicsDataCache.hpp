@@ -0,0 +1,74 @@
+/*
+	GRAPHICS DATA CACHE
+	Keeps the graphics data of recently used modes, so switching back to one of them doesn't have
+	to recreate all the textures and pixel buffers.
+
+	The least recently left mode is dropped first once the memory budget is exceeded.
+*/
+#ifndef RLGAMECANVAS_GRAPHICSDATACACHE
+#define RLGAMECANVAS_GRAPHICSDATACACHE
+
+
+
+
+
+#include "GraphicsData.hpp"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class GraphicsDataCache final
+	{
+	public: // methods
+
+		// iBudget is the maximum memory used by all cached modes together, in bytes.
+		// 0 = nothing is cached.
+		explicit GraphicsDataCache(uint64_t iBudget) : m_iBudget(iBudget) {}
+		GraphicsDataCache(const GraphicsDataCache &) = delete;
+
+		uint64_t budget() const { return m_iBudget; }
+		uint64_t memoryUsage() const { return m_iMemoryUsage; }
+		size_t size() const { return m_oEntries.size(); }
+
+		// Store the graphics data of a mode that is no longer active.
+		// Replaces older data of the same mode. Drops the least recently stored modes until the
+		// budget is kept; data that exceeds the budget on its own is dropped right away.
+		void put(UInt iMode, std::unique_ptr<::GraphicsData> &&up_oData);
+		// Remove the graphics data of a mode from the cache.
+		// Returns nullptr if the mode isn't cached.
+		std::unique_ptr<::GraphicsData> take(UInt iMode);
+
+		void clear();
+
+
+	private: // types
+
+		struct Entry
+		{
+			UInt                            iMode;
+			uint64_t                        iMemoryUsage;
+			std::unique_ptr<::GraphicsData> up_oData;
+		};
+
+
+	private: // variables
+
+		const uint64_t   m_iBudget;
+		uint64_t         m_iMemoryUsage = 0;
+		std::list<Entry> m_oEntries; // most recently stored first
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_GRAPHICSDATACACHE
\ No newline at end of file
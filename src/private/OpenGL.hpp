@@ -14,6 +14,8 @@ typedef struct IUnknown IUnknown;
 
 #include <gl/glext.h>
 
+#include "PixelBufferRing.hpp"
+
 
 
 namespace rlGameCanvasLib
@@ -145,12 +147,96 @@ namespace rlGameCanvasLib
 		const PFNGLFRAMEBUFFERTEXTURE2DPROC   glFramebufferTexture2D;
 		const PFNGLCHECKFRAMEBUFFERSTATUSPROC glCheckFramebufferStatus;
 
+		// pixel buffer objects and fences
+		const PFNGLGENBUFFERSPROC     glGenBuffers;
+		const PFNGLDELETEBUFFERSPROC  glDeleteBuffers;
+		const PFNGLBINDBUFFERPROC     glBindBuffer;
+		const PFNGLBUFFERDATAPROC     glBufferData;
+		const PFNGLMAPBUFFERRANGEPROC glMapBufferRange;
+		const PFNGLUNMAPBUFFERPROC    glUnmapBuffer;
+		const PFNGLFENCESYNCPROC      glFenceSync;
+		const PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+		const PFNGLDELETESYNCPROC     glDeleteSync;
+		const PFNGLBUFFERSTORAGEPROC  glBufferStorage;
+
+		// shaders and texture arrays
+		const PFNGLCREATESHADERPROC       glCreateShader;
+		const PFNGLSHADERSOURCEPROC       glShaderSource;
+		const PFNGLCOMPILESHADERPROC      glCompileShader;
+		const PFNGLGETSHADERIVPROC        glGetShaderiv;
+		const PFNGLGETSHADERINFOLOGPROC   glGetShaderInfoLog;
+		const PFNGLDELETESHADERPROC       glDeleteShader;
+		const PFNGLCREATEPROGRAMPROC      glCreateProgram;
+		const PFNGLATTACHSHADERPROC       glAttachShader;
+		const PFNGLLINKPROGRAMPROC        glLinkProgram;
+		const PFNGLGETPROGRAMIVPROC       glGetProgramiv;
+		const PFNGLGETPROGRAMINFOLOGPROC  glGetProgramInfoLog;
+		const PFNGLDELETEPROGRAMPROC      glDeleteProgram;
+		const PFNGLUSEPROGRAMPROC         glUseProgram;
+		const PFNGLGETUNIFORMLOCATIONPROC glGetUniformLocation;
+		const PFNGLUNIFORM1IPROC          glUniform1i;
+		const PFNGLUNIFORM1IVPROC         glUniform1iv;
+		const PFNGLUNIFORM1FPROC          glUniform1f;
+		const PFNGLUNIFORM2FPROC          glUniform2f;
+		const PFNGLUNIFORM2IPROC          glUniform2i;
+		const PFNGLUNIFORM3FPROC          glUniform3f;
+		const PFNGLUNIFORM4IVPROC         glUniform4iv;
+		const PFNGLTEXIMAGE3DPROC         glTexImage3D;
+		const PFNGLTEXSUBIMAGE3DPROC      glTexSubImage3D;
+
 
 	public: // methods
 
 		const std::string &versionStr() const { return m_sVersion; }
 		const Version &versionInt() const { return m_iVersion; }
 
+		// Can pixel buffer objects guarded by fences be used?
+		// Requires OpenGL 3.2.
+		bool supportsPixelBuffers() const;
+
+		// Can pixel buffers be mapped persistently?
+		// Requires OpenGL 4.4 or the GL_ARB_buffer_storage extension.
+		bool supportsPersistentMapping() const;
+
+		// Can the layers be composited via a shader that samples a texture array?
+		// Requires OpenGL 3.0 (GLSL 1.30).
+		bool supportsShaderCompositor() const;
+
+		bool hasExtension(const char *szName) const;
+
+	};
+
+
+
+	// The PixelBufferAPI, implemented via actual OpenGL calls.
+	class OpenGLPixelBufferAPI final : public PixelBufferAPI
+	{
+	public: // methods
+
+		OpenGLPixelBufferAPI(const OpenGL &gl) :
+			m_oGL(gl), m_bPersistentMapping(gl.supportsPersistentMapping()) {}
+
+		BufferID createBuffer(size_t iSize) override;
+		void deleteBuffer(BufferID iBuffer) override;
+
+		void *mapBuffer(BufferID iBuffer, size_t iSize) override;
+
+		bool supportsPersistentMapping() const override { return m_bPersistentMapping; }
+		BufferID createPersistentBuffer(size_t iSize, void **ppData) override;
+		void bindBuffer(BufferID iBuffer) override;
+		bool unmapBuffer() override;
+		void unbindBuffer() override;
+
+		Fence createFence() override;
+		bool waitForFence(Fence oFence, uint64_t iTimeoutNanoseconds) override;
+		void deleteFence(Fence oFence) override;
+
+
+	private: // variables
+
+		const OpenGL &m_oGL;
+		const bool    m_bPersistentMapping;
+
 	};
 
 }
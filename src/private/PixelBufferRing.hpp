@@ -0,0 +1,204 @@
+/*
+	PIXEL BUFFER RING
+	Pixel buffer objects for streaming texture uploads.
+
+	The pixels of a frame are written to one buffer (or part of a buffer) while the GPU may still be
+	reading the previous ones. Every buffer is guarded by a fence, so it's only written to again
+	once the GPU is done with it.
+
+	All OpenGL calls go through the PixelBufferAPI interface, so the bookkeeping can be tested
+	without a graphics card.
+*/
+#ifndef RLGAMECANVAS_PIXELBUFFERRING
+#define RLGAMECANVAS_PIXELBUFFERRING
+
+
+
+
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class PixelBufferAPI
+	{
+	public: // types
+
+		using BufferID = uint32_t; // 0 = no buffer
+		using Fence    = void *;   // nullptr = no fence
+
+
+	public: // methods
+
+		virtual ~PixelBufferAPI() = default;
+
+		// Create a pixel unpack buffer with room for iSize bytes.
+		// Returns 0 on failure.
+		virtual BufferID createBuffer(size_t iSize) = 0;
+		virtual void deleteBuffer(BufferID iBuffer) = 0;
+
+		// Bind a buffer as the pixel unpack buffer and map it for writing.
+		// The previous contents are discarded; the caller has already made sure the GPU doesn't
+		// use them anymore.
+		// Returns nullptr on failure. The buffer stays bound anyway.
+		virtual void *mapBuffer(BufferID iBuffer, size_t iSize) = 0;
+
+		// Can buffers be mapped persistently?
+		virtual bool supportsPersistentMapping() const = 0;
+		// Create a pixel unpack buffer with room for iSize bytes and map it persistently and
+		// coherently for reading and writing, so the pointer stays valid until the buffer is
+		// deleted.
+		// Returns 0 on failure.
+		virtual BufferID createPersistentBuffer(size_t iSize, void **ppData) = 0;
+		// Bind a buffer as the pixel unpack buffer.
+		virtual void bindBuffer(BufferID iBuffer) = 0;
+
+		// Unmap the bound pixel unpack buffer. The buffer stays bound.
+		// Returns false if the contents of the buffer were lost.
+		virtual bool unmapBuffer() = 0;
+		// Unbind the pixel unpack buffer, so texture uploads read from client memory again.
+		virtual void unbindBuffer() = 0;
+
+		// Create a fence that is signaled once all the commands issued so far are done.
+		// Returns nullptr on failure.
+		virtual Fence createFence() = 0;
+		// Wait for a fence to be signaled.
+		// Returns false on timeout or error.
+		virtual bool waitForFence(Fence oFence, uint64_t iTimeoutNanoseconds) = 0;
+		virtual void deleteFence(Fence oFence) = 0;
+
+	};
+
+
+
+	class PixelBufferRing final
+	{
+	public: // static variables
+
+		static constexpr size_t iMaxBufferCount = 3;
+
+		// How long to wait for the GPU to release a buffer before giving up for this frame.
+		static constexpr uint64_t iWaitTimeoutNanoseconds = 100'000'000; // 100 ms
+
+
+	public: // methods
+
+		// The buffers are created on first use.
+		// iBufferCount is clamped to [2, iMaxBufferCount].
+		PixelBufferRing(PixelBufferAPI &oAPI, size_t iBufferSize, size_t iBufferCount);
+		PixelBufferRing(const PixelBufferRing &) = delete;
+		~PixelBufferRing();
+
+		PixelBufferAPI &api() const { return m_oAPI; }
+		size_t bufferSize() const { return m_iBufferSize; }
+		size_t bufferCount() const { return m_iBufferCount; }
+		size_t currentBuffer() const { return m_iCurrent; }
+
+		// Map the current buffer for writing and bind it as the source of texture uploads.
+		// Waits until the GPU is done with the buffer's previous contents.
+		// Returns nullptr if the buffer can't be used --> upload from client memory instead.
+		void *map();
+
+		// Unmap the current buffer after writing to it.
+		// The buffer stays bound, so texture uploads read from it, using byte offsets instead of
+		// pointers.
+		// Returns false if the contents were lost. In that case, the buffer is unbound again.
+		bool unmap();
+
+		// Guard the current buffer with a fence after the texture uploads reading from it were
+		// issued, unbind it and move on to the next buffer.
+		void submit();
+
+
+	private: // types
+
+		struct Buffer
+		{
+			PixelBufferAPI::BufferID iID    = 0;
+			PixelBufferAPI::Fence    oFence = nullptr;
+		};
+
+
+	private: // variables
+
+		PixelBufferAPI &m_oAPI;
+		const size_t    m_iBufferSize;
+		const size_t    m_iBufferCount;
+		Buffer          m_oBuffers[iMaxBufferCount];
+		size_t          m_iCurrent = 0;
+		bool            m_bMapped  = false;
+
+	};
+
+
+
+	// A single persistently mapped buffer, split into a ring of frames.
+	// The CPU directly reads and writes the pixels of the current frame in the buffer while the
+	// GPU might still read the previous frames. Every frame is guarded by a fence, so it's only
+	// used again once the GPU is done with it.
+	class PersistentPixelBuffer final
+	{
+	public: // static variables
+
+		static constexpr size_t iMaxFrameCount = 3;
+
+		static constexpr uint64_t iWaitTimeoutNanoseconds = 1'000'000'000; // 1 s
+
+
+	public: // methods
+
+		// Creates and maps the buffer right away; check valid() afterwards.
+		// iFrameCount is clamped to [2, iMaxFrameCount].
+		PersistentPixelBuffer(PixelBufferAPI &oAPI, size_t iFrameSize, size_t iFrameCount);
+		PersistentPixelBuffer(const PersistentPixelBuffer &) = delete;
+		~PersistentPixelBuffer();
+
+		bool valid() const { return m_pData != nullptr; }
+
+		PixelBufferAPI &api() const { return m_oAPI; }
+		size_t frameSize() const { return m_iFrameSize; }
+		size_t frameCount() const { return m_iFrameCount; }
+		size_t currentFrame() const { return m_iCurrent; }
+		size_t previousFrame() const { return (m_iCurrent + m_iFrameCount - 1) % m_iFrameCount; }
+
+		void *frameData(size_t iFrame) const
+		{
+			return static_cast<uint8_t *>(m_pData) + frameOffset(iFrame);
+		}
+		// The byte offset of a frame inside the buffer, for texture uploads.
+		size_t frameOffset(size_t iFrame) const { return iFrame * m_iFrameSize; }
+
+		// Bind/unbind the buffer as the source of texture uploads.
+		void bind();
+		void unbind();
+
+		// Guard the current frame with a fence after the texture uploads reading from it were
+		// issued and move on to the next frame, waiting until the GPU is done with it.
+		// Returns false if the wait timed out. The frame is used anyway, as the GPU is expected
+		// to finish at some point; worst case, a single frame shows some of the newer pixels.
+		bool advance();
+
+
+	private: // variables
+
+		PixelBufferAPI          &m_oAPI;
+		const size_t             m_iFrameSize;
+		const size_t             m_iFrameCount;
+		PixelBufferAPI::BufferID m_iBuffer = 0;
+		void                    *m_pData   = nullptr;
+		PixelBufferAPI::Fence    m_oFences[iMaxFrameCount] = {};
+		size_t                   m_iCurrent = 0;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_PIXELBUFFERRING
\ No newline at end of file
@@ -0,0 +1,310 @@
+/*
+	PIXEL KERNELS
+	Row-based pixel operations used by the bitmap API.
+
+	The kernels work on raw pixels (in-memory byte order R, G, B, A) and don't depend on any
+	Windows header, so they can also be built and regression-tested on other platforms.
+
+	Every operation has a scalar reference implementation. The SIMD variants must produce
+	bit-identical results; the dispatching functions pick the fastest variant supported by the CPU.
+*/
+#ifndef RLGAMECANVAS_PIXELKERNELS
+#define RLGAMECANVAS_PIXELKERNELS
+
+
+
+
+
+#include "CPUFeatures.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	// Divide a value in the range [0, 255 * 255] by 255, rounding to the nearest integer.
+	constexpr uint32_t Div255(uint32_t i) noexcept
+	{
+		return (i + 128 + ((i + 128) >> 8)) >> 8;
+	}
+
+
+
+	/*
+		BLEND ("source over", straight alpha)
+
+		For a source pixel S and a destination pixel D, with alpha values in [0, 255]:
+		  weight(D) = Div255(D.a * (255 - S.a))
+		  result.a  = S.a + weight(D)
+		  result.c  = round((S.c * S.a + D.c * weight(D)) / result.a)
+
+		Fully transparent source pixels leave the destination untouched, fully opaque source pixels
+		replace it.
+	*/
+
+	using BlendRowFunc = void(*)(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+	void BlendRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void BlendRow_SSE2     (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void BlendRow_AVX2     (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Blend iCount pixels from pSrc onto pDest, using the fastest available implementation.
+	void BlendRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+
+
+	/*
+		PREMULTIPLIED ALPHA
+
+		With premultiplied alpha, the color channels are already multiplied by the alpha value.
+		"Source over" compositing then boils down to a single multiply-add per channel:
+		  result.x = S.x + Div255(D.x * (255 - S.a))   (for all four channels, saturated)
+
+		Premultiply:   c = Div255(c * a)
+		Unpremultiply: c = round(c * 255 / a)   (fully transparent pixels become 0)
+	*/
+
+	using BlendPremultipliedRowFunc = void(*)(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	using PremultiplyRowFunc        = void(*)(uint32_t *pData, size_t iCount);
+
+	void BlendPremultipliedRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void PremultiplyRow_Reference       (uint32_t *pData, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void BlendPremultipliedRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void BlendPremultipliedRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void PremultiplyRow_SSE2       (uint32_t *pData, size_t iCount);
+	void PremultiplyRow_AVX2       (uint32_t *pData, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Blend iCount premultiplied pixels from pSrc onto pDest, using the fastest available
+	// implementation.
+	void BlendPremultipliedRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+	// Convert iCount straight alpha pixels to premultiplied alpha, using the fastest available
+	// implementation.
+	void PremultiplyRow(uint32_t *pData, size_t iCount);
+
+	// Convert iCount premultiplied alpha pixels back to straight alpha.
+	// Only meant for converting assets, so there's no SIMD implementation.
+	void UnpremultiplyRow(uint32_t *pData, size_t iCount);
+
+
+
+	/*
+		ADD, MULTIPLY, SCREEN (straight alpha)
+
+		The source color is weighted by the source alpha, the destination alpha is kept:
+		  s = Div255(S.c * S.a)
+		  Add:      result.c = min(255, D.c + s)
+		  Multiply: result.c = Div255(D.c * (255 - Div255((255 - S.c) * S.a)))
+		  Screen:   result.c = D.c + Div255(s * (255 - D.c))
+		  result.a = D.a
+
+		Fully transparent source pixels leave the destination untouched. All three share the
+		signature of BlendRow, so they can be used wherever a BlendRowFunc is expected.
+	*/
+
+	void AddRow_Reference     (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void MultiplyRow_Reference(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void ScreenRow_Reference  (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void AddRow_SSE2     (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void AddRow_AVX2     (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void MultiplyRow_SSE2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void MultiplyRow_AVX2(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void ScreenRow_SSE2  (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	void ScreenRow_AVX2  (uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Add iCount pixels from pSrc onto pDest, using the fastest available implementation.
+	void AddRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+	// Multiply pDest with iCount pixels from pSrc, using the fastest available implementation.
+	void MultiplyRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+	// Screen iCount pixels from pSrc onto pDest, using the fastest available implementation.
+	void ScreenRow(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+
+
+
+	/*
+		TINT (straight alpha)
+
+		The color of a source pixel is mixed with a constant color T, weighted by T.a:
+		  result.c = Div255(S.c * (255 - T.a) + T.c * T.a)
+		  result.a = S.a
+
+		The result is meant to be blended via BlendRow afterwards.
+	*/
+
+	using TintRowFunc = void(*)(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint,
+		size_t iCount);
+
+	void TintRow_Reference(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void TintRow_SSE2     (uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount);
+	void TintRow_AVX2     (uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Write iCount pixels from pSrc, tinted with pxTint, to pDest, using the fastest available
+	// implementation.
+	void TintRow(uint32_t *pDest, const uint32_t *pSrc, uint32_t pxTint, size_t iCount);
+
+
+
+	/*
+		LERP (linear interpolation, used for bilinear scaling)
+
+		The weight w of the second pixel is an 8 bit fixed point fraction in [0, 255]:
+		  result.c = (A.c * (256 - w) + B.c * w) >> 8
+
+		Bilinear scaling is done in two separable passes:
+		1. LerpColumns: Interpolate horizontally within a single source row, using a sampling table
+		   with the left and right source column as well as the weight for every output pixel.
+		2. LerpRows: Interpolate vertically between two horizontally interpolated rows, using the
+		   same weight for the whole row.
+	*/
+
+	using LerpColumnsFunc = void(*)(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount);
+	using LerpRowsFunc    = void(*)(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount);
+
+	void LerpColumns_Reference(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount);
+	void LerpRows_Reference   (uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void LerpColumns_SSE2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount);
+	void LerpColumns_AVX2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount);
+	void LerpRows_SSE2   (uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount);
+	void LerpRows_AVX2   (uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Horizontally interpolate iCount pixels of a source row, using the fastest available
+	// implementation.
+	void LerpColumns(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piLeft, const uint32_t *piRight, const uint32_t *piWeight, size_t iCount);
+
+	// Interpolate between two rows of iCount pixels, using the fastest available implementation.
+	void LerpRows(uint32_t *pDest, const uint32_t *pA, const uint32_t *pB,
+		uint32_t iWeight, size_t iCount);
+
+
+
+	/*
+		NEAREST NEIGHBOR SCALING
+
+		Integer factor: Every source pixel is repeated iFactor times.
+		Sampled:        result[i] = pSrcRow[piColumns[i]]   (for arbitrary ratios)
+	*/
+
+	using ScaleRowIntegerFunc = void(*)(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount);
+	using SampleRowFunc       = void(*)(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piColumns, size_t iCount);
+
+	void ScaleRowInteger_Reference(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount);
+	void SampleRow_Reference      (uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piColumns, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	void ScaleRowInteger_SSE2(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount);
+	void ScaleRowInteger_AVX2(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount);
+	// there's no SSE2 variant, as SSE2 can't gather.
+	void SampleRow_AVX2(uint32_t *pDest, const uint32_t *pSrcRow,
+		const uint32_t *piColumns, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Repeat each of iSrcCount pixels iFactor times, using the fastest available implementation.
+	// pDest must have room for iSrcCount * iFactor pixels.
+	void ScaleRowInteger(uint32_t *pDest, const uint32_t *pSrc, uint32_t iFactor,
+		size_t iSrcCount);
+
+	// Sample iCount pixels of a source row via a column table, using the fastest available
+	// implementation.
+	void SampleRow(uint32_t *pDest, const uint32_t *pSrcRow, const uint32_t *piColumns,
+		size_t iCount);
+
+
+
+	/*
+		PALETTE (8 bit indexed pixels)
+
+		Expand:      result = palette[index]
+		Copy keyed:  Index 0 is transparent and leaves the destination untouched, all other indices
+		             replace it.
+	*/
+
+	using ExpandIndexedRowFunc    = void(*)(uint32_t *pDest, const uint8_t *piSrc,
+		const uint32_t *pPalette, size_t iCount);
+	using CopyIndexedRowKeyedFunc = void(*)(uint8_t *piDest, const uint8_t *piSrc, size_t iCount);
+
+	void ExpandIndexedRow_Reference   (uint32_t *pDest, const uint8_t *piSrc,
+		const uint32_t *pPalette, size_t iCount);
+	void CopyIndexedRowKeyed_Reference(uint8_t *piDest, const uint8_t *piSrc, size_t iCount);
+#ifdef RLGAMECANVAS_X86
+	// there's no SSE2 variant, as SSE2 can't gather.
+	void ExpandIndexedRow_AVX2(uint32_t *pDest, const uint8_t *piSrc,
+		const uint32_t *pPalette, size_t iCount);
+	void CopyIndexedRowKeyed_SSE2(uint8_t *piDest, const uint8_t *piSrc, size_t iCount);
+	void CopyIndexedRowKeyed_AVX2(uint8_t *piDest, const uint8_t *piSrc, size_t iCount);
+#endif // RLGAMECANVAS_X86
+
+	// Look up the colors of iCount palette indices in a palette of 256 pixels, using the fastest
+	// available implementation.
+	void ExpandIndexedRow(uint32_t *pDest, const uint8_t *piSrc, const uint32_t *pPalette,
+		size_t iCount);
+
+	// Copy iCount palette indices from piSrc to piDest, skipping index 0, using the fastest
+	// available implementation.
+	void CopyIndexedRowKeyed(uint8_t *piDest, const uint8_t *piSrc, size_t iCount);
+
+
+
+	/*
+		CHANGE DETECTION
+
+		Two rows are compared in blocks of 16 pixels (64 bytes, a single cache line):
+		  pbChanged[i] |= (block i of pA != block i of pB)
+		Blocks that are already marked as changed are skipped, so when comparing a tile of several
+		rows, every column of blocks is only read up to its first difference.
+	*/
+
+	constexpr size_t iDiffBlockPixels = 16;
+
+	using DiffRowBlocksFunc = void(*)(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged);
+
+	void DiffRowBlocks_Reference(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged);
+#ifdef RLGAMECANVAS_X86
+	void DiffRowBlocks_SSE2(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged);
+	void DiffRowBlocks_AVX2(const uint32_t *pA, const uint32_t *pB, size_t iCount,
+		bool *pbChanged);
+#endif // RLGAMECANVAS_X86
+
+	// Compare two rows of iCount pixels block by block, using the fastest available
+	// implementation.
+	// pbChanged must have room for one value per started block of 16 pixels.
+	void DiffRowBlocks(const uint32_t *pA, const uint32_t *pB, size_t iCount, bool *pbChanged);
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_PIXELKERNELS
\ No newline at end of file
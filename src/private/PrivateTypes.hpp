@@ -12,18 +12,19 @@
 namespace rlGameCanvasLib
 {
 
-	struct Rect
+	// A copy of the tileset of a tilemap layer.
+	struct Tileset
 	{
-		UInt iLeft;
-		UInt iTop;
-		UInt iRight;
-		UInt iBottom;
+		Resolution            oSize     = {}; // in pixels
+		Resolution            oTileSize = {};
+		std::vector<PixelInt> oPixels;
 	};
 
 	struct Mode_CPP
 	{
 		rlGameCanvas_Resolution    oScreenSize = {};
 		std::vector<LayerMetadata> oLayerMetadata;
+		std::vector<Tileset>       oTilesets; // one per layer, empty for non-tilemap layers
 	};
 
 }
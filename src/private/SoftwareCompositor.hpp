@@ -0,0 +1,90 @@
+/*
+	SOFTWARE COMPOSITOR
+	Flattens the visible layers into a single RGBA frame on the CPU.
+
+	Meant for machines without a GPU: software OpenGL implementations are slow at blending whole
+	textures, so it's cheaper to blend the layers via the SIMD kernels, spread across all cores,
+	and only hand a single opaque image to OpenGL.
+
+	The compositor doesn't depend on OpenGL or on any window, the layers are only accessed via
+	callbacks.
+*/
+#ifndef RLGAMECANVAS_SOFTWARECOMPOSITOR
+#define RLGAMECANVAS_SOFTWARECOMPOSITOR
+
+
+
+
+
+#include <rlGameCanvas++/Types.hpp>
+#include <rlGameCanvas++/Pixel.hpp>
+#include "PixelKernels.hpp" // BlendRowFunc
+#include "WorkerPool.hpp"
+
+#include <memory>
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class SoftwareCompositor final
+	{
+	public: // types
+
+		// Get iCount pixels of row iY of a layer, starting at column iX.
+		// The pixels never wrap around, iX + iCount is at most the layer's width.
+		// Either returns a pointer to the layer's own pixels or writes them to pBuffer and returns
+		// pBuffer.
+		using GetRowFunc = const PixelInt *(*)(const void *pvLayer, UInt iX, UInt iY, UInt iCount,
+			PixelInt *pBuffer);
+
+		struct Layer
+		{
+			Resolution  oSize;
+			Resolution  oScreenPos; // the layer's pixel that's drawn to the top left of the frame
+			GetRowFunc  fnGetRow;
+			const void *pvLayer;    // passed to fnGetRow
+		};
+
+
+	public: // static variables
+
+		// The number of rows composed by a single task.
+		static constexpr UInt iBandRows = 16;
+
+
+	public: // methods
+
+		// iThreadCount: see WorkerPool.
+		SoftwareCompositor(bool bPremultipliedAlpha, size_t iThreadCount = 0);
+		SoftwareCompositor(const SoftwareCompositor &) = delete;
+		~SoftwareCompositor() = default;
+
+		size_t threadCount() const { return m_oWorkers.threadCount(); }
+
+		// Blend the layers over the background color, bottom layer first.
+		// pFrame must have room for oFrameSize.x * oFrameSize.y pixels; the result is opaque.
+		void compose(const Resolution &oFrameSize, const Layer *pcoLayers, size_t iLayerCount,
+			Pixel pxBackground, PixelInt *pFrame);
+
+
+	private: // variables
+
+		const BlendRowFunc m_fnBlendRow;
+		WorkerPool         m_oWorkers;
+
+		// one row of pixels per thread, for layers that can't return their own pixels
+		std::vector<std::unique_ptr<PixelInt[]>> m_oRowBuffers;
+		UInt m_iRowBufferSize = 0;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_SOFTWARECOMPOSITOR
\ No newline at end of file
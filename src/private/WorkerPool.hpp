@@ -0,0 +1,83 @@
+/*
+	WORKER POOL
+	A fixed set of threads for splitting per-frame work into independent tasks.
+
+	Unlike spawning threads for every batch, the threads are kept alive between batches, so even
+	work that's done on every frame can be spread across all cores without the overhead of
+	creating threads.
+*/
+#ifndef RLGAMECANVAS_WORKERPOOL
+#define RLGAMECANVAS_WORKERPOOL
+
+
+
+
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace rlGameCanvasLib
+{
+
+	class WorkerPool final
+	{
+	public: // types
+
+		// iThread is in [0, threadCount()) and unique among the tasks running at the same time.
+		using TaskFunc = std::function<void(size_t iTask, size_t iThread)>;
+
+
+	public: // methods
+
+		// iThreadCount includes the thread calling run().
+		// 0 = one thread per logical processor.
+		explicit WorkerPool(size_t iThreadCount = 0);
+		WorkerPool(const WorkerPool &) = delete;
+		~WorkerPool();
+
+		size_t threadCount() const { return m_oThreads.size() + 1; }
+
+		// Call fnTask for every task in [0, iTaskCount) and wait until all of them are done.
+		// The calling thread works on the tasks, too.
+		// Must not be called by multiple threads at the same time.
+		void run(size_t iTaskCount, const TaskFunc &fnTask);
+
+
+	private: // methods
+
+		void workerProc(size_t iThread);
+		void work(size_t iThread);
+
+
+	private: // variables
+
+		std::vector<std::thread> m_oThreads;
+
+		std::mutex              m_mux;
+		std::condition_variable m_cvStart;
+		std::condition_variable m_cvDone;
+		uint64_t                m_iGeneration = 0; // incremented for every batch
+		size_t                  m_iBusyThreads = 0;
+		bool                    m_bQuit = false;
+
+		const TaskFunc     *m_pfnTask    = nullptr;
+		size_t              m_iTaskCount = 0;
+		std::atomic<size_t> m_iNextTask  = 0;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_WORKERPOOL
\ No newline at end of file
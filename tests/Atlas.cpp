@@ -0,0 +1,278 @@
+// Tests of the sprite atlases: The packed regions must lie within the sheet without overlapping
+// (including their padding) and contain the pixels of their bitmaps, a saved atlas must load
+// again unchanged, and truncated or corrupt data must be rejected.
+// rlGameCanvas_LoadAtlas only wraps the Atlas constructor and fails exactly if valid() is false,
+// so the C++ class is tested directly.
+
+#include "Test.hpp"
+#include "TestBitmap.hpp"
+#include <rlGameCanvas++/Atlas.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <utility> // std::move
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::TestBitmap;
+
+namespace
+{
+
+	// Bitmaps of random sizes with random pixels, plus an empty one.
+	std::vector<TestBitmap> MakeBitmaps(std::mt19937 &rng, size_t iCount)
+	{
+		std::vector<TestBitmap> oResult;
+		for (size_t i = 0; i < iCount; ++i)
+		{
+			oResult.emplace_back(1 + rng() % 40, 1 + rng() % 30);
+			rlGameCanvasTest::FillRandom(oResult.back(), rng);
+		}
+		oResult.emplace_back(0, 0);
+		return oResult;
+	}
+
+	std::vector<lib::Bitmap> GetBitmaps(const std::vector<TestBitmap> &oBitmaps)
+	{
+		std::vector<lib::Bitmap> oResult;
+		for (const auto &bmp : oBitmaps)
+		{
+			oResult.push_back(bmp.bmp());
+		}
+		return oResult;
+	}
+
+	bool Overlap(const lib::Rect &a, const lib::Rect &b)
+	{
+		return a.iLeft < b.iRight && b.iLeft < a.iRight && a.iTop < b.iBottom && b.iTop < a.iBottom;
+	}
+
+	// Every region has the size of its bitmap and its pixels, lies within the sheet and doesn't
+	// overlap any other region, including the padding on its right and bottom edges.
+	void CheckPacking(const char *szCase, const lib::Atlas &oAtlas,
+		const std::vector<TestBitmap> &oBitmaps, lib::UInt iMaxWidth, lib::UInt iPadding)
+	{
+		if (!RLGC_CHECK(oAtlas.valid()) || !RLGC_CHECK(oAtlas.regionCount() == oBitmaps.size()))
+		{
+			std::printf("  %s: packing failed\n", szCase);
+			return;
+		}
+
+		const lib::Bitmap &bmpSheet = oAtlas.bitmap();
+		if (iMaxWidth > 0 && !RLGC_CHECK(bmpSheet.size.x <= iMaxWidth))
+			std::printf("  %s: the sheet is %u pixels wide\n", szCase, unsigned(bmpSheet.size.x));
+
+		std::vector<bool> oUsed((size_t)bmpSheet.size.x * bmpSheet.size.y, false);
+		for (lib::UInt i = 0; i < oAtlas.regionCount(); ++i)
+		{
+			const lib::Rect &rect = oAtlas.region(i);
+			const auto      &size = oBitmaps[i].size();
+			if (!RLGC_CHECK(rect.iRight - rect.iLeft == size.x && rect.iBottom - rect.iTop == size.y
+				&& rect.iRight <= bmpSheet.size.x && rect.iBottom <= bmpSheet.size.y))
+			{
+				std::printf("  %s: region %u has the wrong size or is outside the sheet\n", szCase,
+					unsigned(i));
+				return;
+			}
+
+			// empty regions take up no space at all
+			if (size.x == 0 || size.y == 0)
+				continue;
+
+			for (lib::UInt j = 0; j < i; ++j)
+			{
+				const lib::Rect &rectOther = oAtlas.region(j);
+				if (rectOther.iLeft == rectOther.iRight || rectOther.iTop == rectOther.iBottom)
+					continue;
+
+				const lib::Rect rectPadded =
+				{
+					rect.iLeft, rect.iTop, rect.iRight + iPadding, rect.iBottom + iPadding
+				};
+				const lib::Rect rectOtherPadded =
+				{
+					rectOther.iLeft, rectOther.iTop,
+					rectOther.iRight + iPadding, rectOther.iBottom + iPadding
+				};
+				if (!RLGC_CHECK(!Overlap(rectPadded, rectOtherPadded)))
+				{
+					std::printf("  %s: regions %u and %u overlap\n", szCase, unsigned(j),
+						unsigned(i));
+					return;
+				}
+			}
+
+			for (lib::UInt iY = 0; iY < size.y; ++iY)
+			{
+				const size_t iSheetOffset = (size_t)(rect.iTop + iY) * bmpSheet.size.x + rect.iLeft;
+				if (!RLGC_CHECK(std::memcmp(bmpSheet.ppxData + iSheetOffset,
+					oBitmaps[i].pixels().data() + (size_t)iY * size.x,
+					size.x * sizeof(lib::PixelInt)) == 0))
+				{
+					std::printf("  %s: row %u of region %u has the wrong pixels\n", szCase,
+						unsigned(iY), unsigned(i));
+					return;
+				}
+				for (lib::UInt iX = 0; iX < size.x; ++iX)
+				{
+					oUsed[iSheetOffset + iX] = true;
+				}
+			}
+
+			// the view of a region is the region of the sheet
+			const lib::BitmapView oView = oAtlas.regionView(i);
+			RLGC_CHECK(oView.size.x == size.x && oView.size.y == size.y &&
+				oView.ppxData == bmpSheet.ppxData + ((size_t)rect.iTop * bmpSheet.size.x +
+					rect.iLeft));
+		}
+
+		// everything else, including the padding, is transparent
+		for (size_t i = 0; i < oUsed.size(); ++i)
+		{
+			if (!oUsed[i] && !RLGC_CHECK(bmpSheet.ppxData[i] == 0))
+			{
+				std::printf("  %s: unused sheet pixel %zu isn't transparent\n", szCase, i);
+				return;
+			}
+		}
+	}
+
+	bool SameAtlas(const lib::Atlas &a, const lib::Atlas &b)
+	{
+		if (a.regionCount() != b.regionCount() ||
+			a.bitmap().size.x != b.bitmap().size.x || a.bitmap().size.y != b.bitmap().size.y)
+			return false;
+
+		for (lib::UInt i = 0; i < a.regionCount(); ++i)
+		{
+			const lib::Rect &rectA = a.region(i);
+			const lib::Rect &rectB = b.region(i);
+			if (rectA.iLeft != rectB.iLeft || rectA.iTop != rectB.iTop ||
+				rectA.iRight != rectB.iRight || rectA.iBottom != rectB.iBottom)
+				return false;
+		}
+
+		return std::memcmp(a.bitmap().ppxData, b.bitmap().ppxData,
+			(size_t)a.bitmap().size.x * a.bitmap().size.y * sizeof(lib::PixelInt)) == 0;
+	}
+
+	// Load from an exactly sized copy of the data.
+	lib::Atlas Load(const std::vector<uint8_t> &oData, size_t iSize)
+	{
+		const std::vector<uint8_t> oCopy(oData.begin(), oData.begin() + iSize);
+		return lib::Atlas(oCopy.data(), oCopy.size());
+	}
+
+
+
+	void TestPacking()
+	{
+		std::mt19937 rng(2020);
+		const auto oBitmaps = MakeBitmaps(rng, 60);
+		const auto oViews   = GetBitmaps(oBitmaps);
+		const lib::UInt iCount = lib::UInt(oViews.size());
+
+		CheckPacking("square", lib::Atlas(oViews.data(), iCount), oBitmaps, 0, 0);
+		CheckPacking("square, padding", lib::Atlas(oViews.data(), iCount, 0, 2), oBitmaps, 0, 2);
+		CheckPacking("narrow", lib::Atlas(oViews.data(), iCount, 64), oBitmaps, 64, 0);
+		CheckPacking("narrow, padding", lib::Atlas(oViews.data(), iCount, 64, 1), oBitmaps, 64, 1);
+
+		// a bitmap wider than the maximum width can't be packed
+		RLGC_CHECK(!lib::Atlas(oViews.data(), iCount, 20).valid());
+		// a bitmap without pixels
+		lib::Bitmap bmpInvalid = { nullptr, { 4, 4 } };
+		RLGC_CHECK(!lib::Atlas(&bmpInvalid, 1).valid());
+	}
+
+	void TestSaveLoad()
+	{
+		std::mt19937 rng(2021);
+		const auto oBitmaps = MakeBitmaps(rng, 25);
+		const auto oViews   = GetBitmaps(oBitmaps);
+		const lib::Atlas oAtlas(oViews.data(), lib::UInt(oViews.size()), 0, 1);
+
+		std::vector<uint8_t> oData(oAtlas.saveSize());
+		RLGC_CHECK(!oAtlas.save(oData.data(), oData.size() - 1)); // too small
+		if (!RLGC_CHECK(oAtlas.save(oData.data(), oData.size())))
+			return;
+
+		const lib::Atlas oLoaded = Load(oData, oData.size());
+		RLGC_CHECK(oLoaded.valid() && SameAtlas(oAtlas, oLoaded));
+		CheckPacking("loaded", oLoaded, oBitmaps, 0, 1);
+
+		// moving keeps everything, the moved-from atlas is empty
+		lib::Atlas oMovedFrom = Load(oData, oData.size());
+		const lib::Atlas oMoved(std::move(oMovedFrom));
+		RLGC_CHECK(SameAtlas(oAtlas, oMoved));
+		RLGC_CHECK(!oMovedFrom.valid() && oMovedFrom.regionCount() == 0 &&
+			oMovedFrom.bitmap().ppxData == nullptr && oMovedFrom.saveSize() == 0);
+		const lib::Rect &rectEmpty = oMovedFrom.region(0);
+		RLGC_CHECK(rectEmpty.iRight == 0 && rectEmpty.iBottom == 0);
+		RLGC_CHECK(!oMovedFrom.save(oData.data(), oData.size()));
+	}
+
+	void TestCorruptData()
+	{
+		std::mt19937 rng(2022);
+		const auto oBitmaps = MakeBitmaps(rng, 5);
+		const auto oViews   = GetBitmaps(oBitmaps);
+		const lib::Atlas oAtlas(oViews.data(), lib::UInt(oViews.size()));
+
+		std::vector<uint8_t> oData(oAtlas.saveSize());
+		if (!RLGC_CHECK(oAtlas.save(oData.data(), oData.size())))
+			return;
+
+		// every truncation, and trailing data
+		for (size_t iSize = 0; iSize < oData.size(); ++iSize)
+		{
+			if (!RLGC_CHECK(!Load(oData, iSize).valid()))
+			{
+				std::printf("  data truncated to %zu bytes was accepted\n", iSize);
+				break;
+			}
+		}
+		std::vector<uint8_t> oLonger = oData;
+		oLonger.push_back(0);
+		RLGC_CHECK(!Load(oLonger, oLonger.size()).valid());
+
+		RLGC_CHECK(!lib::Atlas(nullptr, oData.size()).valid());
+
+		// the header: magic, version, width, height, region count (all 32 bits)
+		const auto fnCorrupt = [&](const char *szCase, size_t iOffset, uint32_t iValue)
+		{
+			std::vector<uint8_t> oCorrupt = oData;
+			std::memcpy(oCorrupt.data() + iOffset, &iValue, sizeof(iValue));
+			if (!RLGC_CHECK(!Load(oCorrupt, oCorrupt.size()).valid()))
+				std::printf("  %s was accepted\n", szCase);
+		};
+		fnCorrupt("wrong magic",          0, 0x41474C53);
+		fnCorrupt("wrong version",        4, 2);
+		fnCorrupt("huge width",           8, 0xFFFFFFFF);
+		fnCorrupt("huge height",         12, 0xFFFFFFFF);
+		fnCorrupt("wider sheet",          8, oAtlas.bitmap().size.x + 1);
+		fnCorrupt("more regions",        16, oAtlas.regionCount() + 1);
+		fnCorrupt("huge region count",   16, 0xFFFFFFFF);
+
+		// the first region (iLeft, iTop, iRight, iBottom)
+		constexpr size_t iRegionOffset = 20;
+		fnCorrupt("region beyond the sheet", iRegionOffset + 8, oAtlas.bitmap().size.x + 1);
+		fnCorrupt("inverted region",         iRegionOffset + 0, oAtlas.region(0).iRight + 1);
+	}
+
+}
+
+
+
+int main()
+{
+	TestPacking();
+	TestSaveLoad();
+	TestCorruptData();
+
+	return rlGameCanvasTest::Result();
+}
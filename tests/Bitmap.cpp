@@ -0,0 +1,261 @@
+// Tests of the bitmap overlays: A batch of overlays must give exactly the same pixels and dirty
+// rectangles as applying the overlays one after another, whether the batch is drawn on a single
+// thread or by the pool of SetBitmapParallelism. Overlays that are split into bands of rows by the
+// pool must give exactly the same pixels as overlays drawn on a single thread, including the rows
+// at the band edges that share source rows with the neighboring band when scaling.
+
+#include "Test.hpp"
+#include "TestBitmap.hpp"
+#include <rlGameCanvas++/Bitmap.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iterator> // std::size
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::TestBitmap;
+
+namespace
+{
+
+	constexpr lib::UInt iDirtyRectCapacity = 64;
+
+	bool SameDirtyRects(const lib::DirtyRects &a, const lib::DirtyRects &b)
+	{
+		if (a.iCount != b.iCount || bool(a.bAll) != bool(b.bAll))
+			return false;
+
+		for (lib::UInt i = 0; i < a.iCount; ++i)
+		{
+			const auto &rectA = a.poRects[i];
+			const auto &rectB = b.poRects[i];
+			if (rectA.iLeft != rectB.iLeft || rectA.iTop != rectB.iTop ||
+				rectA.iRight != rectB.iRight || rectA.iBottom != rectB.iBottom)
+				return false;
+		}
+		return true;
+	}
+
+	// Apply the entries one by one and as a batch, and compare the results.
+	void CheckBatch(const char *szCase, const TestBitmap &bmpBase,
+		const std::vector<lib::BitmapOverlayBatchEntry> &oEntries, bool bMultithreaded)
+	{
+		TestBitmap bmpExpected = bmpBase;
+		TestBitmap bmpActual   = bmpBase;
+
+		lib::Rect oExpectedRects[iDirtyRectCapacity] = {};
+		lib::Rect oActualRects[iDirtyRectCapacity]   = {};
+		lib::DirtyRects oExpectedDirty = { oExpectedRects, iDirtyRectCapacity, 0, false };
+		lib::DirtyRects oActualDirty   = { oActualRects,   iDirtyRectCapacity, 0, false };
+
+		for (const auto &entry : oEntries)
+		{
+			RLGC_CHECK(lib::ApplyBitmapOverlay(&bmpExpected.bmp(), entry.poOverlay, entry.iX,
+				entry.iY, entry.eOverlayStrategy, &oExpectedDirty));
+		}
+		if (!RLGC_CHECK(lib::ApplyBitmapOverlayBatch(&bmpActual.bmp(), oEntries.data(),
+			lib::UInt(oEntries.size()), bMultithreaded, &oActualDirty)))
+		{
+			std::printf("  %s: the batch failed\n", szCase);
+			return;
+		}
+
+		rlGameCanvasTest::SameBitmaps(szCase, bmpExpected, bmpActual);
+		if (!RLGC_CHECK(SameDirtyRects(oExpectedDirty, oActualDirty)))
+			std::printf("  %s: different dirty rectangles\n", szCase);
+	}
+
+
+
+	void TestBatch()
+	{
+		std::mt19937 rng(2006);
+
+		// wide enough for several cache-sized bands of rows (see ApplyBitmapOverlayBatch)
+		TestBitmap bmpBase(300, 200);
+		rlGameCanvasTest::FillRandom(bmpBase, rng, 1);
+
+		std::vector<TestBitmap> oOverlays;
+		for (int i = 0; i < 12; ++i)
+		{
+			oOverlays.emplace_back(1 + rng() % 120, 1 + rng() % 150);
+			rlGameCanvasTest::FillRuns(oOverlays.back(), rng);
+		}
+		oOverlays.emplace_back(300, 200); // covers the whole base bitmap
+		rlGameCanvasTest::FillRandom(oOverlays.back(), rng);
+
+		const lib::BitmapOverlayStrategy eStrategies[] =
+		{
+			lib::BitmapOverlayStrategy::Replace,
+			lib::BitmapOverlayStrategy::Blend,
+			lib::BitmapOverlayStrategy::BlendPremultiplied,
+			lib::BitmapOverlayStrategy::Add,
+			lib::BitmapOverlayStrategy::Multiply,
+			lib::BitmapOverlayStrategy::Screen,
+		};
+
+		// overlapping overlays at random positions, some of them partly or fully clipped
+		std::vector<lib::BitmapOverlayBatchEntry> oEntries;
+		for (int i = 0; i < 40; ++i)
+		{
+			const auto &bmp = oOverlays[rng() % (oOverlays.size() - 1)];
+			oEntries.push_back(
+			{
+				&bmp.bmp(),
+				lib::Int(rng() % 400) - 100,
+				lib::Int(rng() % 300) - 100,
+				eStrategies[rng() % std::size(eStrategies)]
+			});
+		}
+		oEntries.push_back({ &oOverlays[2].bmp(), -500, 20, lib::BitmapOverlayStrategy::Blend });
+		oEntries.push_back({ &oOverlays.back().bmp(), 0, 0, lib::BitmapOverlayStrategy::Blend });
+		oEntries.push_back({ &oOverlays[3].bmp(), 10, 190, lib::BitmapOverlayStrategy::Replace });
+
+		const std::vector<lib::BitmapOverlayBatchEntry> oFew(oEntries.begin(),
+			oEntries.begin() + 3);
+
+		CheckBatch("single-threaded",           bmpBase, oEntries, false);
+		CheckBatch("single-threaded, few",      bmpBase, oFew,     false);
+		CheckBatch("empty",                     bmpBase, {},       false);
+		// the pool isn't enabled yet
+		CheckBatch("multithreaded, no threads", bmpBase, oEntries, true);
+
+		if (!RLGC_CHECK(lib::SetBitmapParallelism(4, 1)))
+			return;
+		CheckBatch("multithreaded",             bmpBase, oEntries, true);
+		CheckBatch("multithreaded, few",        bmpBase, oFew,     true);
+		CheckBatch("single-threaded, pool",     bmpBase, oEntries, false);
+		RLGC_CHECK(lib::SetBitmapParallelism(3, 1)); // bands that don't line up with the cache
+		CheckBatch("multithreaded, 3 threads",  bmpBase, oEntries, true);
+		RLGC_CHECK(lib::SetBitmapParallelism(1));
+
+		// an invalid entry fails the whole batch before anything is drawn
+		TestBitmap bmpUnchanged = bmpBase;
+		oEntries.push_back({ nullptr, 0, 0, lib::BitmapOverlayStrategy::Blend });
+		RLGC_CHECK(!lib::ApplyBitmapOverlayBatch(&bmpUnchanged.bmp(), oEntries.data(),
+			lib::UInt(oEntries.size())));
+		rlGameCanvasTest::SameBitmaps("invalid entry", bmpBase, bmpUnchanged);
+	}
+
+	// Draw with fnDraw on a single thread and with pools of several sizes, so the bands start at
+	// all kinds of rows, and compare the results.
+	void CheckBands(const std::string &sCase, const TestBitmap &bmpBase,
+		const std::function<bool(lib::Bitmap *)> &fnDraw)
+	{
+		RLGC_CHECK(lib::SetBitmapParallelism(1));
+		TestBitmap bmpExpected = bmpBase;
+		if (!RLGC_CHECK(fnDraw(&bmpExpected.bmp())))
+		{
+			std::printf("  %s: drawing failed\n", sCase.c_str());
+			return;
+		}
+
+		for (lib::UInt iThreadCount : { 2u, 3u, 4u, 7u })
+		{
+			if (!RLGC_CHECK(lib::SetBitmapParallelism(iThreadCount, 1)))
+				break;
+
+			TestBitmap bmpActual = bmpBase;
+			RLGC_CHECK(fnDraw(&bmpActual.bmp()));
+			const std::string sThreadCase = sCase + ", " + std::to_string(iThreadCount) +
+				" threads";
+			if (!rlGameCanvasTest::SameBitmaps(sThreadCase.c_str(), bmpExpected, bmpActual))
+				break;
+		}
+		RLGC_CHECK(lib::SetBitmapParallelism(1));
+	}
+
+	void TestBands()
+	{
+		std::mt19937 rng(2022);
+
+		TestBitmap bmpBase(160, 123);
+		rlGameCanvasTest::FillRandom(bmpBase, rng, 1);
+		TestBitmap bmpOverlay(37, 29);
+		rlGameCanvasTest::FillRuns(bmpOverlay, rng);
+
+		const lib::Int iPositions[][2] = { { 0, 0 }, { 11, 7 }, { -13, -9 }, { 140, 100 } };
+		const lib::BitmapOverlayStrategy eStrategies[] =
+		{
+			lib::BitmapOverlayStrategy::Replace,
+			lib::BitmapOverlayStrategy::Blend,
+			lib::BitmapOverlayStrategy::Add,
+		};
+		// upscaled by integer and other factors, downscaled, and stretched
+		const lib::UInt iScaledSizes[][2] =
+		{
+			{ 37 * 3, 29 * 4 }, { 100, 117 }, { 20, 13 }, { 37 * 2, 7 }, { 150, 120 }
+		};
+
+		for (const auto &pos : iPositions)
+		{
+			const std::string sPos = " at " + std::to_string(pos[0]) + "/" +
+				std::to_string(pos[1]);
+
+			for (const auto eStrategy : eStrategies)
+			{
+				const std::string sStrategy = ", strategy " + std::to_string(int(eStrategy));
+
+				// a full-size overlay, so the bands of the pool are big enough to matter
+				TestBitmap bmpBig(150, 110);
+				rlGameCanvasTest::FillRuns(bmpBig, rng);
+				CheckBands("plain" + sStrategy + sPos, bmpBase, [&](lib::Bitmap *poBase)
+					{
+						return lib::ApplyBitmapOverlay(poBase, &bmpBig.bmp(), pos[0], pos[1],
+							eStrategy);
+					}
+				);
+
+				for (const auto &size : iScaledSizes)
+				{
+					const std::string sSize = ", " + std::to_string(size[0]) + "x" +
+						std::to_string(size[1]);
+
+					CheckBands("nearest neighbor" + sStrategy + sSize + sPos, bmpBase,
+						[&](lib::Bitmap *poBase)
+						{
+							return lib::ApplyBitmapOverlay_Scaled(poBase, &bmpOverlay.bmp(),
+								pos[0], pos[1], size[0], size[1], eStrategy,
+								lib::BitmapScalingStrategy::NearestNeighbor);
+						}
+					);
+					CheckBands("bilinear" + sStrategy + sSize + sPos, bmpBase,
+						[&](lib::Bitmap *poBase)
+						{
+							return lib::ApplyBitmapOverlay_Scaled(poBase, &bmpOverlay.bmp(),
+								pos[0], pos[1], size[0], size[1], eStrategy,
+								lib::BitmapScalingStrategy::Bilinear);
+						}
+					);
+				}
+			}
+
+			TestBitmap bmpBig(150, 110);
+			rlGameCanvasTest::FillRuns(bmpBig, rng);
+			CheckBands("tinted" + sPos, bmpBase, [&](lib::Bitmap *poBase)
+				{
+					return lib::ApplyBitmapOverlay_Tinted(poBase, &bmpBig.bmp(), pos[0], pos[1],
+						0x80FF2040);
+				}
+			);
+		}
+	}
+
+}
+
+
+
+int main()
+{
+	TestBatch();
+	TestBands();
+
+	return rlGameCanvasTest::Result();
+}
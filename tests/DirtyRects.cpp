@@ -0,0 +1,153 @@
+// Tests of the dirty rectangle handling: Collecting the rectangles via AddDirtyRect and merging
+// them into as few uploads as worthwhile via MergeDirtyRects.
+
+#include "Test.hpp"
+#include "private/DirtyRects.hpp"
+#include <rlGameCanvas++/Bitmap.hpp>
+
+#include <algorithm> // std::equal, std::sort
+#include <cstdio>
+#include <tuple>     // std::tie
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+namespace
+{
+
+	bool Equal(const lib::Rect &a, const lib::Rect &b)
+	{
+		return a.iLeft == b.iLeft && a.iTop == b.iTop && a.iRight == b.iRight &&
+			a.iBottom == b.iBottom;
+	}
+
+	bool Less(const lib::Rect &a, const lib::Rect &b)
+	{
+		return std::tie(a.iLeft, a.iTop, a.iRight, a.iBottom) <
+			std::tie(b.iLeft, b.iTop, b.iRight, b.iBottom);
+	}
+
+	// Merge the rectangles and compare the result with the expected rectangles, in any order.
+	void CheckMerge(const char *szCase, std::vector<lib::Rect> oRects, size_t iOverheadPixels,
+		std::vector<lib::Rect> oExpected)
+	{
+		lib::MergeDirtyRects(oRects, iOverheadPixels);
+
+		std::sort(oRects.begin(), oRects.end(), Less);
+		std::sort(oExpected.begin(), oExpected.end(), Less);
+		if (!RLGC_CHECK(std::equal(oRects.begin(), oRects.end(),
+			oExpected.begin(), oExpected.end(), Equal)))
+		{
+			std::printf("  %s: got %zu rectangle(s):\n", szCase, oRects.size());
+			for (const auto &rect : oRects)
+			{
+				std::printf("    %u, %u, %u, %u\n", unsigned(rect.iLeft), unsigned(rect.iTop),
+					unsigned(rect.iRight), unsigned(rect.iBottom));
+			}
+		}
+	}
+
+
+
+	void TestMerge()
+	{
+		CheckMerge("empty", {}, 100, {});
+		CheckMerge("single", { { 1, 2, 3, 4 } }, 100, { { 1, 2, 3, 4 } });
+
+		// contained rectangles are always merged
+		CheckMerge("contained", { { 0, 0, 10, 10 }, { 2, 2, 4, 4 } }, 0, { { 0, 0, 10, 10 } });
+		CheckMerge("identical", { { 5, 5, 8, 8 }, { 5, 5, 8, 8 } }, 0, { { 5, 5, 8, 8 } });
+
+		// adjacent rectangles whose bounding box has no additional pixels
+		CheckMerge("adjacent horizontally", { { 0, 0, 10, 10 }, { 10, 0, 20, 10 } }, 0,
+			{ { 0, 0, 20, 10 } });
+		CheckMerge("adjacent vertically", { { 0, 0, 10, 10 }, { 0, 10, 10, 20 } }, 0,
+			{ { 0, 0, 10, 20 } });
+
+		// distant rectangles stay separate, unless the overhead is huge
+		const std::vector<lib::Rect> oDistant = { { 0, 0, 10, 10 }, { 100, 100, 110, 110 } };
+		CheckMerge("distant", oDistant, 1000, oDistant);
+		CheckMerge("distant, huge overhead", oDistant, 12100 - 200, { { 0, 0, 110, 110 } });
+
+		// overlapping: bounding box = 225 pixels, the rectangles themselves = 200 pixels
+		// --> merged exactly when the overhead is at least 25 pixels
+		const std::vector<lib::Rect> oOverlapping = { { 0, 0, 10, 10 }, { 5, 5, 15, 15 } };
+		CheckMerge("overlapping, overhead below threshold", oOverlapping, 24, oOverlapping);
+		CheckMerge("overlapping, overhead at threshold", oOverlapping, 25, { { 0, 0, 15, 15 } });
+
+		// a merged rectangle can make further merges worthwhile:
+		// A|C and B|C aren't worth it on their own, but (A|B)|C is
+		CheckMerge("chained",
+			{ { 0, 10, 20, 20 }, { 0, 0, 10, 10 }, { 10, 0, 20, 10 } }, 0, { { 0, 0, 20, 20 } });
+
+		// unrelated rectangles stay separate while the others are merged
+		CheckMerge("partial",
+			{ { 0, 0, 10, 10 }, { 500, 500, 510, 510 }, { 10, 0, 20, 10 } }, 50,
+			{ { 0, 0, 20, 10 }, { 500, 500, 510, 510 } });
+	}
+
+	void TestClip()
+	{
+		const lib::Resolution size = { 100, 50 };
+
+		lib::Rect rect = { 90, 40, 120, 60 };
+		RLGC_CHECK(lib::ClipRect(rect, size));
+		RLGC_CHECK(Equal(rect, { 90, 40, 100, 50 }));
+
+		rect = { 100, 0, 120, 10 };
+		RLGC_CHECK(!lib::ClipRect(rect, size));
+
+		rect = { 10, 10, 20, 20 };
+		RLGC_CHECK(lib::ClipRect(rect, size));
+		RLGC_CHECK(Equal(rect, { 10, 10, 20, 20 }));
+	}
+
+	void TestAdd()
+	{
+		RLGC_CHECK(!lib::AddDirtyRect(nullptr, { 0, 0, 1, 1 }));
+
+		lib::Rect oStorage[3] = {};
+		lib::DirtyRects oDirty = { oStorage, 3, 0, false };
+
+		// empty rectangles are ignored
+		RLGC_CHECK(lib::AddDirtyRect(&oDirty, { 5, 5, 5, 10 }));
+		RLGC_CHECK(lib::AddDirtyRect(&oDirty, { 5, 5, 10, 5 }));
+		RLGC_CHECK(lib::AddDirtyRect(&oDirty, { 10, 5, 5, 10 }));
+		RLGC_CHECK(oDirty.iCount == 0 && !oDirty.bAll);
+
+		for (lib::UInt i = 0; i < 3; ++i)
+		{
+			RLGC_CHECK(lib::AddDirtyRect(&oDirty, { i, i, i + 1, i + 1 }));
+		}
+		RLGC_CHECK(oDirty.iCount == 3 && !oDirty.bAll);
+		RLGC_CHECK(Equal(oStorage[2], { 2, 2, 3, 3 }));
+
+		// capacity overflow --> the whole layer is marked as changed
+		RLGC_CHECK(lib::AddDirtyRect(&oDirty, { 7, 7, 8, 8 }));
+		RLGC_CHECK(oDirty.bAll);
+		RLGC_CHECK(oDirty.iCount == 3);
+
+		// further rectangles are ignored once everything changed
+		RLGC_CHECK(lib::AddDirtyRect(&oDirty, { 9, 9, 10, 10 }));
+		RLGC_CHECK(oDirty.bAll && oDirty.iCount == 3);
+
+		// no storage at all --> every rectangle overflows
+		lib::DirtyRects oNoStorage = { nullptr, 0, 0, false };
+		RLGC_CHECK(lib::AddDirtyRect(&oNoStorage, { 0, 0, 1, 1 }));
+		RLGC_CHECK(oNoStorage.bAll && oNoStorage.iCount == 0);
+	}
+
+}
+
+
+
+int main()
+{
+	TestMerge();
+	TestClip();
+	TestAdd();
+
+	return rlGameCanvasTest::Result();
+}
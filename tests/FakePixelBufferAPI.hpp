@@ -0,0 +1,168 @@
+/*
+	FAKE PIXEL BUFFER API
+	A PixelBufferAPI that keeps the buffers in client memory and records how it was used, so the
+	pixel buffer bookkeeping can be tested without an OpenGL context.
+
+	Failures (busy fences, failed mappings, lost buffer contents, ...) can be provoked via the
+	public flags.
+*/
+#ifndef RLGAMECANVAS_TEST_FAKEPIXELBUFFERAPI
+#define RLGAMECANVAS_TEST_FAKEPIXELBUFFERAPI
+
+
+
+
+
+#include "private/PixelBufferRing.hpp"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+
+
+namespace rlGameCanvasTest
+{
+
+	class FakePixelBufferAPI final : public rlGameCanvasLib::PixelBufferAPI
+	{
+	public: // variables
+
+		// provoked failures
+		bool bFailCreate      = false;
+		bool bFailMap         = false;
+		bool bFailUnmap       = false; // contents lost
+		bool bFailFence       = false; // createFence returns nullptr
+		bool bFencesBusy      = false; // waitForFence times out
+		bool bPersistent      = true;  // supportsPersistentMapping
+
+		// the current state
+		std::map<BufferID, std::vector<uint8_t>> oBuffers;
+		std::set<Fence> oFences;       // the fences that weren't deleted yet
+		BufferID        iBound  = 0;
+		bool            bMapped = false;
+
+		// call counts
+		unsigned iCreatedBuffers = 0;
+		unsigned iCreatedFences  = 0;
+		unsigned iWaits          = 0;
+		unsigned iMaps           = 0;
+
+		// errors in the usage of the API, like mapping a buffer twice or deleting an unknown fence
+		unsigned iMisuses = 0;
+
+
+	public: // methods
+
+		BufferID createBuffer(size_t iSize) override
+		{
+			if (bFailCreate)
+				return 0;
+
+			++iCreatedBuffers;
+			oBuffers[m_iNextBuffer].resize(iSize);
+			return m_iNextBuffer++;
+		}
+
+		void deleteBuffer(BufferID iBuffer) override
+		{
+			if (oBuffers.erase(iBuffer) == 0)
+				++iMisuses;
+			if (iBound == iBuffer)
+			{
+				iBound  = 0;
+				bMapped = false;
+			}
+		}
+
+		void *mapBuffer(BufferID iBuffer, size_t iSize) override
+		{
+			auto it = oBuffers.find(iBuffer);
+			if (it == oBuffers.end() || bMapped || iSize > it->second.size())
+			{
+				++iMisuses;
+				return nullptr;
+			}
+
+			iBound = iBuffer; // stays bound even on failure
+			++iMaps;
+			if (bFailMap)
+				return nullptr;
+
+			bMapped = true;
+			return it->second.data();
+		}
+
+		bool supportsPersistentMapping() const override { return bPersistent; }
+
+		BufferID createPersistentBuffer(size_t iSize, void **ppData) override
+		{
+			const BufferID iBuffer = createBuffer(iSize);
+			*ppData = iBuffer ? oBuffers[iBuffer].data() : nullptr;
+			return iBuffer;
+		}
+
+		void bindBuffer(BufferID iBuffer) override
+		{
+			if (oBuffers.count(iBuffer) == 0)
+				++iMisuses;
+			iBound = iBuffer;
+		}
+
+		bool unmapBuffer() override
+		{
+			if (!bMapped)
+				++iMisuses;
+
+			bMapped = false;
+			return !bFailUnmap;
+		}
+
+		void unbindBuffer() override
+		{
+			if (bMapped)
+				++iMisuses; // OpenGL would keep the buffer mapped
+			iBound = 0;
+		}
+
+		Fence createFence() override
+		{
+			if (bFailFence)
+				return nullptr;
+
+			++iCreatedFences;
+			const Fence oFence = reinterpret_cast<Fence>(uintptr_t(iCreatedFences));
+			oFences.insert(oFence);
+			return oFence;
+		}
+
+		bool waitForFence(Fence oFence, uint64_t /* iTimeoutNanoseconds */) override
+		{
+			if (oFences.count(oFence) == 0)
+				++iMisuses;
+
+			++iWaits;
+			return !bFencesBusy;
+		}
+
+		void deleteFence(Fence oFence) override
+		{
+			if (oFences.erase(oFence) == 0)
+				++iMisuses;
+		}
+
+
+	private: // variables
+
+		BufferID m_iNextBuffer = 1;
+
+	};
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_TEST_FAKEPIXELBUFFERAPI
\ No newline at end of file
@@ -0,0 +1,362 @@
+// Tests of the bitmap fonts: A text must give exactly the same pixels as a reference renderer
+// that tints and blends every glyph pixel by pixel, whether the font renders it anew (no cache, or
+// a cache miss) or draws it from its cache. The cache must keep the most recently drawn texts and
+// evict the least recently drawn one. Where glyphs overlap, the later one must be blended on top
+// of the earlier ones instead of replacing them.
+
+#include "Test.hpp"
+#include "TestBitmap.hpp"
+#include "private/PixelKernels.hpp" // Div255, the reference kernels
+#include <rlGameCanvas++/Font.hpp>
+
+#include <algorithm> // std::max
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility> // std::move
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::TestBitmap;
+
+namespace
+{
+
+	// The glyphs of the code points 32 to 127, in a grid of 16 x 6 cells.
+	constexpr lib::UInt iCellWidth      = 6;
+	constexpr lib::UInt iCellHeight     = 8;
+	constexpr lib::UInt iColumns        = 16;
+	constexpr lib::UInt iFirstCodePoint = 32;
+	constexpr lib::UInt iGlyphCount     = 96;
+	// The advance of the font with overlapping glyphs.
+	constexpr lib::UInt iNarrowAdvance  = iCellWidth - 3;
+
+	const lib::U8Char *Text(const char *sz) { return reinterpret_cast<const lib::U8Char *>(sz); }
+
+	std::vector<lib::Glyph> MakeGlyphs(lib::UInt iAdvance)
+	{
+		std::vector<lib::Glyph> oResult;
+		for (lib::UInt i = 0; i < iGlyphCount; ++i)
+		{
+			const lib::UInt iLeft = (i % iColumns) * iCellWidth;
+			const lib::UInt iTop  = (i / iColumns) * iCellHeight;
+			oResult.push_back(
+			{
+				iFirstCodePoint + i,
+				{ iLeft, iTop, iLeft + iCellWidth, iTop + iCellHeight },
+				iAdvance
+			});
+		}
+		return oResult;
+	}
+
+	// Render an ASCII text pixel by pixel. Every other character is drawn as '?'.
+	TestBitmap RenderReference(const TestBitmap &bmpFont, const char *szText, lib::UInt iAdvance,
+		lib::PixelInt pxColor, bool bPremultiplied)
+	{
+		// the size
+		lib::UInt iWidth      = 0;
+		lib::UInt iLineWidth  = 0;
+		lib::UInt iLineCount  = 1;
+		for (const char *p = szText; *p; ++p)
+		{
+			if (*p == '\n')
+			{
+				iLineWidth = 0;
+				++iLineCount;
+			}
+			else if ((*p & 0xC0) != 0x80) // not a UTF-8 continuation byte
+			{
+				iWidth      = std::max(iWidth, iLineWidth + std::max(iAdvance, iCellWidth));
+				iLineWidth += iAdvance;
+			}
+		}
+		TestBitmap bmpResult(iWidth, iLineCount * iCellHeight);
+
+		lib::PixelInt pxTint = pxColor;
+		if (bPremultiplied)
+			lib::PremultiplyRow_Reference(&pxTint, 1);
+
+		lib::UInt iPenX = 0;
+		lib::UInt iPenY = 0;
+		for (const char *p = szText; *p; ++p)
+		{
+			if (*p == '\n')
+			{
+				iPenX  = 0;
+				iPenY += iCellHeight;
+				continue;
+			}
+			if ((*p & 0xC0) == 0x80)
+				continue;
+
+			const lib::UInt iCodePoint = (*p & 0x80) ? '?' : lib::UInt(*p);
+			const lib::UInt iGlyph     = iCodePoint - iFirstCodePoint;
+			const lib::UInt iLeft      = (iGlyph % iColumns) * iCellWidth;
+			const lib::UInt iTop       = (iGlyph / iColumns) * iCellHeight;
+			for (lib::UInt iY = 0; iY < iCellHeight; ++iY)
+			{
+				for (lib::UInt iX = 0; iX < iCellWidth; ++iX)
+				{
+					const lib::PixelInt px =
+						bmpFont.pixels()[(size_t)(iTop + iY) * bmpFont.size().x + iLeft + iX];
+					if ((px >> 24) == 0)
+						continue; // invisible pixels aren't part of the glyph
+
+					lib::PixelInt pxTinted = 0;
+					for (lib::UInt iShift = 0; iShift < 32; iShift += 8)
+					{
+						pxTinted |= lib::Div255(((px >> iShift) & 0xFF) *
+							((pxTint >> iShift) & 0xFF)) << iShift;
+					}
+
+					lib::PixelInt &pxDest = bmpResult.pixels()[
+						(size_t)(iPenY + iY) * bmpResult.size().x + iPenX + iX];
+					if (bPremultiplied)
+						lib::BlendPremultipliedRow_Reference(&pxDest, &pxTinted, 1);
+					else
+						lib::BlendRow_Reference(&pxDest, &pxTinted, 1);
+				}
+			}
+			iPenX += iAdvance;
+		}
+
+		return bmpResult;
+	}
+
+	// Draw a text with the font and with the reference renderer onto copies of bmpBase, at several
+	// positions, some of them partly outside the base bitmap.
+	void CheckText(const char *szCase, lib::Font &oFont, const TestBitmap &bmpFont,
+		const TestBitmap &bmpBase, const char *szText, lib::UInt iAdvance, lib::PixelInt pxColor,
+		lib::BitmapOverlayStrategy eStrategy)
+	{
+		const bool bPremultiplied = eStrategy == lib::BitmapOverlayStrategy::BlendPremultiplied;
+		TestBitmap bmpText = RenderReference(bmpFont, szText, iAdvance, pxColor, bPremultiplied);
+
+		const lib::Resolution oSize = lib::MeasureText(oFont, Text(szText));
+		if (!RLGC_CHECK(oSize.x == bmpText.size().x && oSize.y == bmpText.size().y))
+		{
+			std::printf("  %s: \"%s\" measures %ux%u instead of %ux%u\n", szCase, szText,
+				unsigned(oSize.x), unsigned(oSize.y), unsigned(bmpText.size().x),
+				unsigned(bmpText.size().y));
+			return;
+		}
+
+		const lib::Int iPositions[][2] =
+		{
+			{ 3, 2 }, { 0, 0 }, { -5, -3 }, { 70, 35 }, { -2, 30 }, { 3, 2 }
+		};
+		for (const auto &pos : iPositions)
+		{
+			TestBitmap bmpExpected = bmpBase;
+			TestBitmap bmpActual   = bmpBase;
+			lib::ApplyBitmapOverlay(&bmpExpected.bmp(), &bmpText.bmp(), pos[0], pos[1], eStrategy);
+			RLGC_CHECK(lib::ApplyTextOverlay(&bmpActual.bmp(), oFont, Text(szText), pxColor,
+				pos[0], pos[1], eStrategy));
+
+			const std::string sCase = std::string(szCase) + ", \"" + szText + "\" at " +
+				std::to_string(pos[0]) + "/" + std::to_string(pos[1]);
+			if (!rlGameCanvasTest::SameBitmaps(sCase.c_str(), bmpExpected, bmpActual))
+				return;
+		}
+	}
+
+	void CheckFont(const char *szCase, lib::Font &oFont, const TestBitmap &bmpFont,
+		lib::UInt iAdvance, lib::BitmapOverlayStrategy eStrategy)
+	{
+		if (!RLGC_CHECK(oFont.valid()))
+		{
+			std::printf("  %s: invalid font\n", szCase);
+			return;
+		}
+
+		std::mt19937 rng(2101);
+		TestBitmap bmpBase(80, 40);
+		rlGameCanvasTest::FillRandom(bmpBase, rng, 1); // see BlendRow
+		if (eStrategy == lib::BitmapOverlayStrategy::BlendPremultiplied)
+			lib::PremultiplyRow_Reference(bmpBase.pixels().data(), bmpBase.pixels().size());
+
+		const char *szTexts[] =
+		{
+			"Hello, World!",
+			"A\nmultiline\n\ntext ~",
+			"caf\xC3\xA9", // 'é' isn't part of the font --> '?'
+			"",
+		};
+		const lib::PixelInt pxColors[] = { 0xFFFFFFFF, 0xC080FF40, 0x40FFFFFF };
+		for (const char *szText : szTexts)
+		{
+			for (lib::PixelInt pxColor : pxColors)
+			{
+				CheckText(szCase, oFont, bmpFont, bmpBase, szText, iAdvance, pxColor, eStrategy);
+			}
+		}
+	}
+
+
+
+	void TestRendering()
+	{
+		std::mt19937 rng(2102);
+		TestBitmap bmpFont(iColumns * iCellWidth, (iGlyphCount / iColumns) * iCellHeight);
+		rlGameCanvasTest::FillRuns(bmpFont, rng);
+		TestBitmap bmpFontPremultiplied = bmpFont;
+		lib::PremultiplyRow_Reference(bmpFontPremultiplied.pixels().data(),
+			bmpFontPremultiplied.pixels().size());
+
+		const auto oGlyphs       = MakeGlyphs(iCellWidth);
+		const auto oNarrowGlyphs = MakeGlyphs(iNarrowAdvance);
+
+		for (lib::UInt iCacheSize : { 0u, 64u, 2u })
+		{
+			const std::string sCache = "cache size " + std::to_string(iCacheSize);
+
+			lib::Font oFixed(bmpFont.bmp(), { iCellWidth, iCellHeight }, iFirstCodePoint,
+				iCacheSize);
+			CheckFont(("fixed, " + sCache).c_str(), oFixed, bmpFont, iCellWidth,
+				lib::BitmapOverlayStrategy::Blend);
+
+			lib::Font oGlyphList(bmpFont.bmp(), oGlyphs.data(), iGlyphCount, iCellHeight,
+				iCacheSize);
+			CheckFont(("glyph list, " + sCache).c_str(), oGlyphList, bmpFont, iCellWidth,
+				lib::BitmapOverlayStrategy::Blend);
+
+			lib::Font oNarrow(bmpFont.bmp(), oNarrowGlyphs.data(), iGlyphCount, iCellHeight,
+				iCacheSize);
+			CheckFont(("overlapping, " + sCache).c_str(), oNarrow, bmpFont, iNarrowAdvance,
+				lib::BitmapOverlayStrategy::Blend);
+
+			lib::Font oPremultiplied(bmpFontPremultiplied.bmp(), oNarrowGlyphs.data(),
+				iGlyphCount, iCellHeight, iCacheSize);
+			CheckFont(("overlapping, premultiplied, " + sCache).c_str(), oPremultiplied,
+				bmpFontPremultiplied, iNarrowAdvance,
+				lib::BitmapOverlayStrategy::BlendPremultiplied);
+		}
+	}
+
+	void TestCache()
+	{
+		std::mt19937 rng(2103);
+		TestBitmap bmpFont(iColumns * iCellWidth, (iGlyphCount / iColumns) * iCellHeight);
+		rlGameCanvasTest::FillRuns(bmpFont, rng);
+		TestBitmap bmpBase(40, 20);
+		rlGameCanvasTest::FillRandom(bmpBase, rng, 1);
+
+		lib::Font oFont(bmpFont.bmp(), { iCellWidth, iCellHeight }, iFirstCodePoint, 3);
+		if (!RLGC_CHECK(oFont.valid() && oFont.cacheSize() == 3))
+			return;
+
+		const auto fnDraw = [&](const char *szText, lib::PixelInt pxColor = 0xFFFFFFFF,
+			lib::BitmapOverlayStrategy eStrategy = lib::BitmapOverlayStrategy::Blend)
+		{
+			RLGC_CHECK(lib::ApplyTextOverlay(&bmpBase.bmp(), oFont, Text(szText), pxColor, 0, 0,
+				eStrategy));
+		};
+		const auto fnCheck = [&](const char *szCase, size_t iRenderCount, lib::UInt iCachedCount)
+		{
+			if (!RLGC_CHECK(oFont.renderCount() == iRenderCount &&
+				oFont.cachedTextCount() == iCachedCount))
+				std::printf("  %s: %zu texts rendered, %u cached instead of %zu, %u\n", szCase,
+					oFont.renderCount(), unsigned(oFont.cachedTextCount()), iRenderCount,
+					unsigned(iCachedCount));
+		};
+
+		fnDraw("A");
+		fnDraw("B");
+		fnDraw("C");
+		fnCheck("A, B, C", 3, 3);
+		fnDraw("A");
+		fnCheck("A again", 3, 3);
+		fnDraw("D"); // B is the least recently drawn text
+		fnCheck("D", 4, 3);
+		fnDraw("A");
+		fnDraw("C");
+		fnDraw("D");
+		fnCheck("A, C, D again", 4, 3);
+		fnDraw("B");
+		fnCheck("B again", 5, 3);
+		fnDraw("A"); // was evicted by B
+		fnCheck("A after B", 6, 3);
+
+		// the color and the blending mode are part of the key
+		oFont.clearCache();
+		fnCheck("cleared", 6, 0);
+		fnDraw("A");
+		fnDraw("A", 0xFF0000FF);
+		fnDraw("A", 0xFFFFFFFF, lib::BitmapOverlayStrategy::BlendPremultiplied);
+		fnCheck("A in different ways", 9, 3);
+		fnDraw("A", 0xFF0000FF);
+		fnCheck("A in red again", 9, 3);
+
+		// without a cache, every text is rendered
+		lib::Font oUncached(bmpFont.bmp(), { iCellWidth, iCellHeight }, iFirstCodePoint, 0);
+		for (int i = 0; i < 3; ++i)
+		{
+			RLGC_CHECK(lib::ApplyTextOverlay(&bmpBase.bmp(), oUncached, Text("A"), 0xFFFFFFFF,
+				0, 0, lib::BitmapOverlayStrategy::Blend));
+		}
+		RLGC_CHECK(oUncached.renderCount() == 3 && oUncached.cachedTextCount() == 0);
+
+		// the moved-from font is empty
+		lib::Font oMoved(std::move(oFont));
+		RLGC_CHECK(oMoved.valid() && oMoved.cachedTextCount() == 3 && oMoved.renderCount() == 9);
+		RLGC_CHECK(!oFont.valid() && oFont.cacheSize() == 0 && oFont.cachedTextCount() == 0 &&
+			oFont.renderCount() == 0);
+		oFont.clearCache();
+		RLGC_CHECK(!lib::ApplyTextOverlay(&bmpBase.bmp(), oFont, Text("A"), 0xFFFFFFFF, 0, 0,
+			lib::BitmapOverlayStrategy::Blend));
+	}
+
+	// Two half transparent white glyphs, 4 pixels wide, that overlap by 2 pixels.
+	void TestOverlap()
+	{
+		TestBitmap bmpFont(8, 1);
+		for (auto &px : bmpFont.pixels())
+		{
+			px = 0x80FFFFFF;
+		}
+		const lib::Glyph oGlyphs[] =
+		{
+			{ 'a', { 0, 0, 4, 1 }, 2 },
+			{ 'b', { 4, 0, 8, 1 }, 2 },
+		};
+		lib::Font oFont(bmpFont.bmp(), oGlyphs, 2, 1);
+		TestBitmap bmpText(6, 1);
+		if (!RLGC_CHECK(oFont.valid()) || !RLGC_CHECK(lib::ApplyTextOverlay(&bmpText.bmp(), oFont,
+			Text("ab"), 0xFFFFFFFF, 0, 0, lib::BitmapOverlayStrategy::Blend)))
+			return;
+
+		// where the glyphs overlap, b is blended on top of a: 0x80 + 0x80 * (1 - 0x80/0xFF)
+		const lib::PixelInt pxSingle = 0x80FFFFFF;
+		const lib::PixelInt pxDouble = 0xC0FFFFFF;
+		const lib::PixelInt pxExpected[] =
+		{
+			pxSingle, pxSingle, pxDouble, pxDouble, pxSingle, pxSingle
+		};
+		for (size_t i = 0; i < bmpText.pixels().size(); ++i)
+		{
+			if (!RLGC_CHECK(bmpText.pixels()[i] == pxExpected[i]))
+			{
+				std::printf("  overlap: pixel %zu is %08X instead of %08X\n", i,
+					unsigned(bmpText.pixels()[i]), unsigned(pxExpected[i]));
+				return;
+			}
+		}
+	}
+
+}
+
+
+
+int main()
+{
+	TestRendering();
+	TestCache();
+	TestOverlap();
+
+	return rlGameCanvasTest::Result();
+}
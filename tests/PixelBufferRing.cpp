@@ -0,0 +1,238 @@
+// Tests of the pixel buffer bookkeeping (PixelBufferRing, PersistentPixelBuffer) against a fake
+// PixelBufferAPI: Buffers and fences must be reused and released correctly, and every failure
+// must leave no buffer bound, so the caller can fall back to uploading from client memory.
+
+#include "FakePixelBufferAPI.hpp"
+#include "Test.hpp"
+#include "private/PixelBufferRing.hpp"
+
+#include <cstring>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::FakePixelBufferAPI;
+
+namespace
+{
+
+	// Map, write, unmap and submit the current buffer, like a regular frame would.
+	bool UploadFrame(lib::PixelBufferRing &oRing, FakePixelBufferAPI &oAPI)
+	{
+		void *pData = oRing.map();
+		if (!RLGC_CHECK(pData != nullptr))
+			return false;
+		std::memset(pData, 0xAB, oRing.bufferSize());
+
+		const bool bUnmapped = RLGC_CHECK(oRing.unmap());
+		RLGC_CHECK(oAPI.iBound != 0); // the texture upload reads from the buffer
+		oRing.submit();
+		RLGC_CHECK(oAPI.iBound == 0);
+
+		return bUnmapped;
+	}
+
+
+
+	void TestRingReuse()
+	{
+		FakePixelBufferAPI oAPI;
+		{
+			lib::PixelBufferRing oRing(oAPI, 64, 3);
+			RLGC_CHECK(oRing.bufferCount() == 3);
+			RLGC_CHECK(oAPI.iCreatedBuffers == 0); // created on first use
+
+			constexpr unsigned iFrames = 10;
+			for (unsigned i = 0; i < iFrames; ++i)
+			{
+				RLGC_CHECK(oRing.currentBuffer() == i % 3);
+				UploadFrame(oRing, oAPI);
+			}
+
+			// every buffer is created once and reused afterwards, after waiting for its fence.
+			// the fences that were waited for are released, only the latest one per buffer is left
+			RLGC_CHECK(oAPI.iCreatedBuffers == 3);
+			RLGC_CHECK(oAPI.oBuffers.size() == 3);
+			RLGC_CHECK(oAPI.iCreatedFences == iFrames);
+			RLGC_CHECK(oAPI.iWaits == iFrames - 3);
+			RLGC_CHECK(oAPI.oFences.size() == 3);
+		}
+
+		// the destructor releases everything
+		RLGC_CHECK(oAPI.oBuffers.empty());
+		RLGC_CHECK(oAPI.oFences.empty());
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+	void TestRingBufferCount()
+	{
+		FakePixelBufferAPI oAPI;
+		RLGC_CHECK(lib::PixelBufferRing(oAPI, 16, 0).bufferCount() == 2);
+		RLGC_CHECK(lib::PixelBufferRing(oAPI, 16, 100).bufferCount() ==
+			lib::PixelBufferRing::iMaxBufferCount);
+	}
+
+	void TestRingBusyFence()
+	{
+		FakePixelBufferAPI oAPI;
+		lib::PixelBufferRing oRing(oAPI, 64, 2);
+		UploadFrame(oRing, oAPI);
+		UploadFrame(oRing, oAPI);
+
+		// the GPU is still reading buffer 0 --> upload directly from client memory instead
+		oAPI.bFencesBusy = true;
+		RLGC_CHECK(oRing.map() == nullptr);
+		RLGC_CHECK(oAPI.iBound == 0 && !oAPI.bMapped);
+		RLGC_CHECK(oRing.currentBuffer() == 0);
+		RLGC_CHECK(oAPI.oFences.size() == 2); // the fence is kept for the next attempt
+
+		// the buffer can't be unmapped or submitted, as it was never mapped
+		RLGC_CHECK(!oRing.unmap());
+
+		// once the GPU is done, the same buffer is used, with the same fence
+		oAPI.bFencesBusy = false;
+		const unsigned iFencesBefore = oAPI.iCreatedFences;
+		UploadFrame(oRing, oAPI);
+		RLGC_CHECK(oAPI.iCreatedFences == iFencesBefore + 1);
+		RLGC_CHECK(oRing.currentBuffer() == 1);
+		RLGC_CHECK(oAPI.iCreatedBuffers == 2);
+
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+	void TestRingFailures()
+	{
+		FakePixelBufferAPI oAPI;
+		lib::PixelBufferRing oRing(oAPI, 64, 2);
+
+		// no buffer --> direct upload, try again next time
+		oAPI.bFailCreate = true;
+		RLGC_CHECK(oRing.map() == nullptr);
+		RLGC_CHECK(oAPI.iBound == 0);
+		oAPI.bFailCreate = false;
+
+		// failed mapping: the API leaves the buffer bound, the ring must unbind it
+		oAPI.bFailMap = true;
+		RLGC_CHECK(oRing.map() == nullptr);
+		RLGC_CHECK(oAPI.iMaps == 1);
+		RLGC_CHECK(oAPI.iBound == 0);
+		oAPI.bFailMap = false;
+
+		// lost contents when unmapping: unbound, so the upload reads from client memory
+		oAPI.bFailUnmap = true;
+		RLGC_CHECK(oRing.map() != nullptr);
+		RLGC_CHECK(!oRing.unmap());
+		RLGC_CHECK(oAPI.iBound == 0 && !oAPI.bMapped);
+		oAPI.bFailUnmap = false;
+
+		// mapping twice without unmapping isn't allowed
+		RLGC_CHECK(oRing.map() != nullptr);
+		RLGC_CHECK(oRing.map() == nullptr);
+		RLGC_CHECK(oRing.unmap());
+
+		// no fence --> the buffer is reused without waiting (the driver synchronizes)
+		oAPI.bFailFence = true;
+		oRing.submit();
+		UploadFrame(oRing, oAPI);
+		UploadFrame(oRing, oAPI);
+		RLGC_CHECK(oAPI.iWaits == 0);
+		oAPI.bFailFence = false;
+
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+	void TestRingDestroyWhileMapped()
+	{
+		FakePixelBufferAPI oAPI;
+		{
+			lib::PixelBufferRing oRing(oAPI, 64, 2);
+			UploadFrame(oRing, oAPI);
+			RLGC_CHECK(oRing.map() != nullptr);
+		}
+
+		RLGC_CHECK(!oAPI.bMapped && oAPI.iBound == 0);
+		RLGC_CHECK(oAPI.oBuffers.empty());
+		RLGC_CHECK(oAPI.oFences.empty());
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+
+
+	void TestPersistent()
+	{
+		FakePixelBufferAPI oAPI;
+		{
+			lib::PersistentPixelBuffer oBuffer(oAPI, 100, 3);
+			RLGC_CHECK(oBuffer.valid());
+			RLGC_CHECK(oAPI.oBuffers.size() == 1 && oAPI.oBuffers.begin()->second.size() == 300);
+
+			// the frames are consecutive parts of the same buffer
+			RLGC_CHECK(oBuffer.frameOffset(2) == 200);
+			RLGC_CHECK(static_cast<uint8_t *>(oBuffer.frameData(1)) ==
+				oAPI.oBuffers.begin()->second.data() + 100);
+
+			// the first round doesn't have to wait
+			for (size_t i = 0; i < 2; ++i)
+			{
+				RLGC_CHECK(oBuffer.currentFrame() == i);
+				RLGC_CHECK(oBuffer.advance());
+			}
+			RLGC_CHECK(oAPI.iWaits == 0);
+			RLGC_CHECK(oBuffer.previousFrame() == 1);
+
+			// the next frames have to wait for the fences of the first round
+			RLGC_CHECK(oBuffer.advance());
+			RLGC_CHECK(oBuffer.currentFrame() == 0);
+			RLGC_CHECK(oAPI.iWaits == 1);
+			RLGC_CHECK(oAPI.oFences.size() == 2);
+
+			// on timeout, the frame is used anyway and the fence is released
+			oAPI.bFencesBusy = true;
+			RLGC_CHECK(!oBuffer.advance());
+			RLGC_CHECK(oBuffer.currentFrame() == 1);
+			RLGC_CHECK(oAPI.oFences.size() == 2);
+			oAPI.bFencesBusy = false;
+
+			oBuffer.bind();
+			RLGC_CHECK(oAPI.iBound != 0);
+			oBuffer.unbind();
+			RLGC_CHECK(oAPI.iBound == 0);
+		}
+
+		RLGC_CHECK(oAPI.oBuffers.empty());
+		RLGC_CHECK(oAPI.oFences.empty());
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+	void TestPersistentUnavailable()
+	{
+		FakePixelBufferAPI oAPI;
+
+		oAPI.bPersistent = false;
+		RLGC_CHECK(!lib::PersistentPixelBuffer(oAPI, 100, 2).valid());
+		RLGC_CHECK(oAPI.iCreatedBuffers == 0);
+
+		oAPI.bPersistent = true;
+		oAPI.bFailCreate = true;
+		RLGC_CHECK(!lib::PersistentPixelBuffer(oAPI, 100, 2).valid());
+
+		RLGC_CHECK(oAPI.iMisuses == 0);
+	}
+
+}
+
+
+
+int main()
+{
+	TestRingReuse();
+	TestRingBufferCount();
+	TestRingBusyFence();
+	TestRingFailures();
+	TestRingDestroyWhileMapped();
+	TestPersistent();
+	TestPersistentUnavailable();
+
+	return rlGameCanvasTest::Result();
+}
@@ -0,0 +1,482 @@
+// Bit-exact regression test of the SIMD pixel kernels against their scalar reference
+// implementations, for all combinations of source and destination alpha values and for row
+// lengths/offsets that don't line up with the vector width.
+
+#include "Test.hpp"
+#include "private/PixelKernels.hpp"
+
+#include <algorithm> // std::copy, std::count, std::equal, std::fill, std::min
+#include <cstdint>
+#include <cstdio>
+#include <memory>    // std::unique_ptr
+#include <random>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+namespace
+{
+
+	using BinaryRowFunc = void(*)(uint32_t *pDest, const uint32_t *pSrc, size_t iCount);
+	using UnaryRowFunc  = void(*)(uint32_t *pData, size_t iCount);
+
+	template <typename TFunc>
+	struct Variant
+	{
+		const char *szName;
+		TFunc       fn;
+	};
+
+	// All variants of a kernel that can run on this CPU, including the dispatching function.
+	template <typename TFunc>
+	std::vector<Variant<TFunc>> GetVariants(TFunc fnDispatched, TFunc fnSSE2, TFunc fnAVX2)
+	{
+		std::vector<Variant<TFunc>> oResult = { { "dispatched", fnDispatched } };
+
+		const auto &oFeatures = lib::GetCPUFeatures();
+		if (fnSSE2 && oFeatures.bSSE2)
+			oResult.push_back({ "SSE2", fnSSE2 });
+		if (fnAVX2 && oFeatures.bAVX2)
+			oResult.push_back({ "AVX2", fnAVX2 });
+
+		return oResult;
+	}
+
+#ifdef RLGAMECANVAS_X86
+#define RLGC_VARIANTS(name) GetVariants(lib::name, lib::name##_SSE2, lib::name##_AVX2)
+// kernels without an SSE2 variant
+#define RLGC_VARIANTS_AVX2(name) \
+	GetVariants<decltype(&lib::name)>(lib::name, nullptr, lib::name##_AVX2)
+#else
+#define RLGC_VARIANTS(name) GetVariants<decltype(&lib::name)>(lib::name, nullptr, nullptr)
+#define RLGC_VARIANTS_AVX2(name) RLGC_VARIANTS(name)
+#endif
+
+
+
+	// Every combination of source and destination alpha value, with random colors.
+	// Every 4th source pixel is premultiplied, so the premultiplied kernels also see valid input.
+	void GetAlphaCombinations(std::vector<uint32_t> &oDest, std::vector<uint32_t> &oSrc)
+	{
+		std::mt19937 rng(1234);
+
+		oDest.resize(256 * 256);
+		oSrc .resize(256 * 256);
+		for (uint32_t iSrcAlpha = 0; iSrcAlpha < 256; ++iSrcAlpha)
+		{
+			for (uint32_t iDestAlpha = 0; iDestAlpha < 256; ++iDestAlpha)
+			{
+				const size_t i = iSrcAlpha * 256 + iDestAlpha;
+				oDest[i] = (rng() & 0x00FFFFFF) | (iDestAlpha << 24);
+				oSrc[i]  = (rng() & 0x00FFFFFF) | (iSrcAlpha  << 24);
+				if (i % 4 == 0)
+					lib::PremultiplyRow_Reference(&oSrc[i], 1);
+			}
+		}
+	}
+
+	// Compare a kernel variant with the reference, both for the whole data and for short rows at
+	// all offsets within a vector.
+	// fnApply(fn, pDest, pSrc, iCount) calls a kernel. oSrc must be at least as long as oDest.
+	template <typename TFunc, typename TDestPixel, typename TSrcPixel, typename TApply>
+	void CompareRows(const char *szKernel, const Variant<TFunc> &oVariant, TFunc fnReference,
+		const std::vector<TDestPixel> &oDest, const std::vector<TSrcPixel> &oSrc,
+		const TApply &fnApply)
+	{
+		constexpr size_t iMaxShortLength = 67;
+		constexpr size_t iMaxOffset      = 8;
+		constexpr size_t iGuard          = 8; // pixels after the row that must stay untouched
+
+		std::vector<TDestPixel> oExpected, oActual;
+
+		const auto fnCompare = [&](size_t iDestOffset, size_t iSrcOffset, size_t iCount)
+		{
+			oExpected.assign(oDest.begin() + iDestOffset,
+				oDest.begin() + iDestOffset + iCount + iGuard);
+			oActual = oExpected;
+
+			fnApply(fnReference,   oExpected.data(), oSrc.data() + iSrcOffset, iCount);
+			fnApply(oVariant.fn, oActual.data(),   oSrc.data() + iSrcOffset, iCount);
+
+			for (size_t i = 0; i < oExpected.size(); ++i)
+			{
+				if (!RLGC_CHECK(oExpected[i] == oActual[i]))
+				{
+					std::printf("  %s (%s), %zu pixels, offsets %zu/%zu: "
+						"pixel %zu is %08X instead of %08X\n",
+						szKernel, oVariant.szName, iCount, iDestOffset, iSrcOffset, i,
+						unsigned(oActual[i]), unsigned(oExpected[i]));
+					return false;
+				}
+			}
+			return true;
+		};
+
+		// all alpha combinations in one long, unaligned row
+		if (!fnCompare(1, 3, oDest.size() - 1 - iGuard - 3))
+			return;
+
+		for (size_t iCount = 0; iCount <= iMaxShortLength; ++iCount)
+		{
+			for (size_t iOffset = 0; iOffset < iMaxOffset; ++iOffset)
+			{
+				// a different part of the data for every length, so all alpha values are used
+				const size_t iStart = (iCount * 977 + iOffset * 131) % (oDest.size() / 2);
+				if (!fnCompare(iStart + iOffset, iStart + (iMaxOffset - iOffset), iCount))
+					return;
+			}
+		}
+	}
+
+	void TestBinaryKernel(const char *szKernel, BinaryRowFunc fnReference,
+		const std::vector<Variant<BinaryRowFunc>> &oVariants,
+		const std::vector<uint32_t> &oDest, const std::vector<uint32_t> &oSrc)
+	{
+		for (const auto &oVariant : oVariants)
+		{
+			CompareRows(szKernel, oVariant, fnReference, oDest, oSrc,
+				[](BinaryRowFunc fn, uint32_t *pDest, const uint32_t *pSrc, size_t iCount)
+				{
+					fn(pDest, pSrc, iCount);
+				}
+			);
+		}
+	}
+
+	// Bilinear scaling: random sampling tables, every output pixel interpolates between two
+	// neighboring source columns.
+	void TestLerp(const std::vector<uint32_t> &oDest, const std::vector<uint32_t> &oSrc)
+	{
+		constexpr uint32_t iSrcColumns = 1024;
+
+		std::mt19937 rng(2002);
+		std::vector<uint32_t> oLeft(oDest.size()), oRight(oDest.size()), oWeights(oDest.size());
+		for (size_t i = 0; i < oDest.size(); ++i)
+		{
+			oLeft[i]    = rng() % iSrcColumns;
+			oRight[i]   = std::min(oLeft[i] + 1, iSrcColumns - 1);
+			oWeights[i] = rng() % 256;
+		}
+
+		for (const auto &oVariant : RLGC_VARIANTS(LerpColumns))
+		{
+			CompareRows("LerpColumns", oVariant,
+				static_cast<lib::LerpColumnsFunc>(lib::LerpColumns_Reference), oDest, oSrc,
+				[&](lib::LerpColumnsFunc fn, uint32_t *pDest, const uint32_t *pSrcRow,
+					size_t iCount)
+				{
+					// the tables start at a different alignment for every row length
+					const size_t iTableOffset = iCount % 8;
+					fn(pDest, pSrcRow, oLeft.data() + iTableOffset, oRight.data() + iTableOffset,
+						oWeights.data() + iTableOffset, iCount);
+				}
+			);
+		}
+
+		// the second row is the same part of oDest
+		for (const uint32_t iWeight : { 0u, 1u, 77u, 128u, 254u, 255u })
+		{
+			for (const auto &oVariant : RLGC_VARIANTS(LerpRows))
+			{
+				CompareRows("LerpRows", oVariant,
+					static_cast<lib::LerpRowsFunc>(lib::LerpRows_Reference), oDest, oSrc,
+					[&, iWeight](lib::LerpRowsFunc fn, uint32_t *pDest, const uint32_t *pA,
+						size_t iCount)
+					{
+						fn(pDest, pA, oDest.data() + (pA - oSrc.data()), iWeight, iCount);
+					}
+				);
+			}
+		}
+	}
+
+	// Nearest neighbor scaling: all factors with special code paths and a few without, plus random
+	// column tables.
+	void TestNearestNeighbor(const std::vector<uint32_t> &oDest, const std::vector<uint32_t> &oSrc)
+	{
+		// the destination row of iCount pixels is filled with as many whole source pixels as fit
+		for (const uint32_t iFactor : { 1u, 2u, 3u, 4u, 5u, 7u, 8u, 9u, 16u, 17u })
+		{
+			for (const auto &oVariant : RLGC_VARIANTS(ScaleRowInteger))
+			{
+				CompareRows("ScaleRowInteger", oVariant,
+					static_cast<lib::ScaleRowIntegerFunc>(lib::ScaleRowInteger_Reference),
+					oDest, oSrc,
+					[iFactor](lib::ScaleRowIntegerFunc fn, uint32_t *pDest, const uint32_t *pSrc,
+						size_t iCount)
+					{
+						fn(pDest, pSrc, iFactor, iCount / iFactor);
+					}
+				);
+			}
+		}
+
+		constexpr uint32_t iSrcColumns = 1024;
+
+		std::mt19937 rng(2008);
+		std::vector<uint32_t> oColumns(oDest.size());
+		for (auto &iColumn : oColumns)
+		{
+			iColumn = rng() % iSrcColumns;
+		}
+
+		for (const auto &oVariant : RLGC_VARIANTS_AVX2(SampleRow))
+		{
+			CompareRows("SampleRow", oVariant,
+				static_cast<lib::SampleRowFunc>(lib::SampleRow_Reference), oDest, oSrc,
+				[&](lib::SampleRowFunc fn, uint32_t *pDest, const uint32_t *pSrcRow, size_t iCount)
+				{
+					// the table starts at a different alignment for every row length
+					fn(pDest, pSrcRow, oColumns.data() + iCount % 8, iCount);
+				}
+			);
+		}
+	}
+
+	// Palette indices: Random indices, a third of them transparent (0), and some long runs of
+	// transparent indices, so the keyed copy also skips whole vectors.
+	void TestIndexed(const std::vector<uint32_t> &oPixels)
+	{
+		std::mt19937 rng(2007);
+
+		std::vector<uint8_t> oDestIndices(oPixels.size()), oSrcIndices(oPixels.size());
+		for (size_t i = 0; i < oPixels.size(); ++i)
+		{
+			oDestIndices[i] = uint8_t(rng());
+			oSrcIndices[i]  = (rng() % 3 == 0) ? 0 : uint8_t(rng());
+			if ((i / 64) % 5 == 0)
+				oSrcIndices[i] = 0;
+		}
+
+		const std::vector<uint32_t> oPalette(oPixels.begin(), oPixels.begin() + 256);
+		for (const auto &oVariant : RLGC_VARIANTS_AVX2(ExpandIndexedRow))
+		{
+			CompareRows("ExpandIndexedRow", oVariant,
+				static_cast<lib::ExpandIndexedRowFunc>(lib::ExpandIndexedRow_Reference),
+				oPixels, oSrcIndices,
+				[&](lib::ExpandIndexedRowFunc fn, uint32_t *pDest, const uint8_t *piSrc,
+					size_t iCount)
+				{
+					fn(pDest, piSrc, oPalette.data(), iCount);
+				}
+			);
+		}
+
+		for (const auto &oVariant : RLGC_VARIANTS(CopyIndexedRowKeyed))
+		{
+			CompareRows("CopyIndexedRowKeyed", oVariant,
+				static_cast<lib::CopyIndexedRowKeyedFunc>(lib::CopyIndexedRowKeyed_Reference),
+				oDestIndices, oSrcIndices,
+				[](lib::CopyIndexedRowKeyedFunc fn, uint8_t *piDest, const uint8_t *piSrc,
+					size_t iCount)
+				{
+					fn(piDest, piSrc, iCount);
+				}
+			);
+		}
+
+		// the transparent index must never overwrite the destination
+		std::vector<uint8_t> oDest(oDestIndices.begin(), oDestIndices.begin() + 100);
+		const std::vector<uint8_t> oTransparent(oDest.size(), 0);
+		for (const auto &oVariant : RLGC_VARIANTS(CopyIndexedRowKeyed))
+		{
+			oVariant.fn(oDest.data(), oTransparent.data(), oDest.size());
+			if (!RLGC_CHECK(std::equal(oDest.begin(), oDest.end(), oDestIndices.begin())))
+				std::printf("  CopyIndexedRowKeyed (%s) wrote transparent indices\n",
+					oVariant.szName);
+		}
+	}
+
+	// Run the reference and a variant of DiffRowBlocks on the same rows, starting with the same
+	// block flags, and compare the flags afterwards.
+	bool CompareDiff(const Variant<lib::DiffRowBlocksFunc> &oVariant, const uint32_t *pA,
+		const uint32_t *pB, size_t iCount, const std::vector<bool> &oInitial,
+		std::vector<bool> *poExpected = nullptr)
+	{
+		const std::unique_ptr<bool[]> up_bExpected(new bool[oInitial.size()]);
+		const std::unique_ptr<bool[]> up_bActual  (new bool[oInitial.size()]);
+		std::copy(oInitial.begin(), oInitial.end(), up_bExpected.get());
+		std::copy(oInitial.begin(), oInitial.end(), up_bActual.get());
+
+		lib::DiffRowBlocks_Reference(pA, pB, iCount, up_bExpected.get());
+		oVariant.fn(pA, pB, iCount, up_bActual.get());
+
+		if (poExpected != nullptr)
+			poExpected->assign(up_bExpected.get(), up_bExpected.get() + oInitial.size());
+
+		if (!RLGC_CHECK(std::equal(up_bExpected.get(), up_bExpected.get() + oInitial.size(),
+			up_bActual.get())))
+		{
+			std::printf("  DiffRowBlocks (%s), %zu pixels: different blocks\n",
+				oVariant.szName, iCount);
+			return false;
+		}
+		return true;
+	}
+
+	// Change detection: A false negative means a stale texture, so every single changed byte must
+	// be found, including the ones in the last, partial block of a row.
+	void TestDiffRowBlocks()
+	{
+		constexpr size_t iBlock     = lib::iDiffBlockPixels;
+		constexpr size_t iMaxCount  = 4 * iBlock + 5;
+		constexpr size_t iMaxBlocks = (iMaxCount + iBlock - 1) / iBlock;
+		constexpr size_t iMaxOffset = 3;
+
+		std::mt19937 rng(2011);
+		std::vector<uint32_t> oA(iMaxOffset + iMaxCount + 1);
+		for (auto &px : oA)
+		{
+			px = rng();
+		}
+
+		for (const auto &oVariant : RLGC_VARIANTS(DiffRowBlocks))
+		{
+			for (size_t iOffset = 0; iOffset <= iMaxOffset; ++iOffset)
+			{
+				for (size_t iCount = 0; iCount <= iMaxCount; ++iCount)
+				{
+					const size_t iBlocks = (iCount + iBlock - 1) / iBlock;
+					const std::vector<bool> oNone(iMaxBlocks, false);
+					std::vector<bool> oExpected;
+
+					// the pixel right after the row differs, but isn't part of it
+					std::vector<uint32_t> oB = oA;
+					oB[iOffset + iCount] ^= 1;
+					if (!CompareDiff(oVariant, oA.data() + iOffset, oB.data() + iOffset, iCount,
+						oNone, &oExpected) ||
+						!RLGC_CHECK(oExpected == oNone))
+						return;
+
+					for (size_t iByte = 0; iByte < iCount * sizeof(uint32_t); ++iByte)
+					{
+						auto pB = reinterpret_cast<uint8_t *>(oB.data() + iOffset);
+						pB[iByte] ^= uint8_t(1 << (iByte % 8));
+
+						const size_t iChangedBlock = iByte / sizeof(uint32_t) / iBlock;
+						if (!CompareDiff(oVariant, oA.data() + iOffset, oB.data() + iOffset,
+							iCount, oNone, &oExpected) ||
+							!RLGC_CHECK(oExpected[iChangedBlock]) ||
+							!RLGC_CHECK(std::count(oExpected.begin(), oExpected.end(), true) == 1))
+							return;
+
+						// blocks that are already marked stay marked
+						std::vector<bool> oAll(iMaxBlocks, false);
+						std::fill(oAll.begin(), oAll.begin() + iBlocks, true);
+						if (!CompareDiff(oVariant, oA.data() + iOffset, oB.data() + iOffset,
+							iCount, oAll, &oExpected) ||
+							!RLGC_CHECK(oExpected == oAll))
+							return;
+
+						pB[iByte] ^= uint8_t(1 << (iByte % 8));
+					}
+				}
+			}
+
+			// a tile of strided rows, like the layer change detection compares it: the flags are
+			// accumulated over all rows of the tile
+			constexpr size_t iStride = 3 * iBlock + 9;
+			constexpr size_t iWidth  = 2 * iBlock + 7;
+			constexpr size_t iRows   = 5;
+			std::vector<uint32_t> oTileA(iStride * iRows);
+			for (auto &px : oTileA)
+			{
+				px = rng();
+			}
+			for (unsigned iTry = 0; iTry < 200; ++iTry)
+			{
+				std::vector<uint32_t> oTileB = oTileA;
+				const unsigned iChanges = rng() % 3;
+				for (unsigned i = 0; i < iChanges; ++i)
+				{
+					oTileB[rng() % oTileB.size()] ^= 1u << (rng() % 32);
+				}
+
+				bool bExpected[iMaxBlocks] = {};
+				bool bActual[iMaxBlocks]   = {};
+				for (size_t iY = 0; iY < iRows; ++iY)
+				{
+					const size_t iRowOffset = iY * iStride + 1;
+					lib::DiffRowBlocks_Reference(oTileA.data() + iRowOffset,
+						oTileB.data() + iRowOffset, iWidth, bExpected);
+					oVariant.fn(oTileA.data() + iRowOffset, oTileB.data() + iRowOffset, iWidth,
+						bActual);
+				}
+				if (!RLGC_CHECK(std::equal(bExpected, bExpected + iMaxBlocks, bActual)))
+				{
+					std::printf("  DiffRowBlocks (%s): different blocks in a strided tile\n",
+						oVariant.szName);
+					break;
+				}
+			}
+		}
+	}
+
+	void TestPremultiply(const std::vector<uint32_t> &oData)
+	{
+		for (const auto &oVariant : RLGC_VARIANTS(PremultiplyRow))
+		{
+			CompareRows("PremultiplyRow", oVariant,
+				static_cast<UnaryRowFunc>(lib::PremultiplyRow_Reference), oData, oData,
+				[](UnaryRowFunc fn, uint32_t *pDest, const uint32_t *, size_t iCount)
+				{
+					fn(pDest, iCount);
+				}
+			);
+		}
+	}
+
+	void TestTint(const std::vector<uint32_t> &oSrc)
+	{
+		// every tint alpha value, each with a different color
+		std::mt19937 rng(5678);
+		const std::vector<uint32_t> oSrcPart(oSrc.begin(), oSrc.begin() + 4096 + 64);
+		for (uint32_t iTintAlpha = 0; iTintAlpha < 256; ++iTintAlpha)
+		{
+			const uint32_t pxTint = (rng() & 0x00FFFFFF) | (iTintAlpha << 24);
+
+			for (const auto &oVariant : RLGC_VARIANTS(TintRow))
+			{
+				CompareRows("TintRow", oVariant,
+					static_cast<lib::TintRowFunc>(lib::TintRow_Reference), oSrcPart, oSrcPart,
+					[pxTint](lib::TintRowFunc fn, uint32_t *pDest, const uint32_t *pSrc,
+						size_t iCount)
+					{
+						fn(pDest, pSrc, pxTint, iCount);
+					}
+				);
+			}
+		}
+	}
+
+}
+
+
+
+int main()
+{
+	const auto &oFeatures = lib::GetCPUFeatures();
+	std::printf("CPU features: SSE2 = %d, AVX2 = %d\n", int(oFeatures.bSSE2), int(oFeatures.bAVX2));
+
+	std::vector<uint32_t> oDest, oSrc;
+	GetAlphaCombinations(oDest, oSrc);
+
+	TestBinaryKernel("BlendRow", lib::BlendRow_Reference, RLGC_VARIANTS(BlendRow), oDest, oSrc);
+	TestBinaryKernel("BlendPremultipliedRow", lib::BlendPremultipliedRow_Reference,
+		RLGC_VARIANTS(BlendPremultipliedRow), oDest, oSrc);
+	TestBinaryKernel("AddRow", lib::AddRow_Reference, RLGC_VARIANTS(AddRow), oDest, oSrc);
+	TestBinaryKernel("MultiplyRow", lib::MultiplyRow_Reference, RLGC_VARIANTS(MultiplyRow),
+		oDest, oSrc);
+	TestBinaryKernel("ScreenRow", lib::ScreenRow_Reference, RLGC_VARIANTS(ScreenRow),
+		oDest, oSrc);
+	TestPremultiply(oSrc);
+	TestTint(oSrc);
+	TestLerp(oDest, oSrc);
+	TestNearestNeighbor(oDest, oSrc);
+	TestIndexed(oSrc);
+	TestDiffRowBlocks();
+
+	return rlGameCanvasTest::Result();
+}
@@ -0,0 +1,224 @@
+// Tests of the software compositor: A composed frame must be exactly the frame of a scalar
+// reference compositor that blends pixel by pixel, for layers that wrap around the frame's edges,
+// a translucent background color (the frame is opaque anyway), straight and premultiplied alpha,
+// and any count of threads.
+// Hidden layers are left out of the layer list by GraphicsData::compose before the compositor is
+// called, so the test builds the list the same way and checks that hidden layers aren't touched.
+
+#include "Test.hpp"
+#include "TestBitmap.hpp"
+#include "private/PixelKernels.hpp" // the reference kernels
+#include "private/SoftwareCompositor.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::TestBitmap;
+
+namespace
+{
+
+	struct TestLayer
+	{
+		TestBitmap      bmp;
+		lib::Resolution oScreenPos;
+		bool            bVisible;
+		bool            bUseBuffer; // return the pixels via the row buffer
+
+		mutable std::atomic<size_t> iGetRowCount{ 0 };
+		mutable std::atomic<bool>   bInvalidRow{ false };
+
+		TestLayer(lib::UInt iWidth, lib::UInt iHeight, lib::Resolution oScreenPos,
+			bool bVisible, bool bUseBuffer) :
+			bmp(iWidth, iHeight), oScreenPos(oScreenPos), bVisible(bVisible),
+			bUseBuffer(bUseBuffer)
+		{}
+
+		static const lib::PixelInt *GetRow(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt iCount, lib::PixelInt *pBuffer)
+		{
+			const auto &layer = *static_cast<const TestLayer *>(pvLayer);
+			++layer.iGetRowCount;
+
+			// the rows must never wrap around
+			const auto &size = layer.bmp.size();
+			if (iY >= size.y || iCount == 0 || iX + iCount > size.x)
+			{
+				layer.bInvalidRow = true;
+				return layer.bmp.pixels().data();
+			}
+
+			const lib::PixelInt *pRow = layer.bmp.pixels().data() + ((size_t)iY * size.x + iX);
+			if (!layer.bUseBuffer)
+				return pRow;
+
+			for (lib::UInt i = 0; i < iCount; ++i)
+			{
+				pBuffer[i] = pRow[i];
+			}
+			return pBuffer;
+		}
+	};
+
+	// Compose the visible layers pixel by pixel.
+	TestBitmap ComposeReference(const lib::Resolution &oFrameSize,
+		const std::vector<TestLayer *> &oLayers, lib::PixelInt pxBackground, bool bPremultiplied)
+	{
+		TestBitmap bmpResult(oFrameSize.x, oFrameSize.y);
+		for (lib::UInt iY = 0; iY < oFrameSize.y; ++iY)
+		{
+			for (lib::UInt iX = 0; iX < oFrameSize.x; ++iX)
+			{
+				lib::PixelInt &px = bmpResult.pixels()[(size_t)iY * oFrameSize.x + iX];
+				px = pxBackground | 0xFF000000;
+
+				for (const TestLayer *pLayer : oLayers)
+				{
+					if (!pLayer->bVisible)
+						continue;
+
+					const auto &size = pLayer->bmp.size();
+					const lib::UInt iLayerX = (iX + pLayer->oScreenPos.x) % size.x;
+					const lib::UInt iLayerY = (iY + pLayer->oScreenPos.y) % size.y;
+					const lib::PixelInt pxSrc =
+						pLayer->bmp.pixels()[(size_t)iLayerY * size.x + iLayerX];
+
+					if (bPremultiplied)
+						lib::BlendPremultipliedRow_Reference(&px, &pxSrc, 1);
+					else
+						lib::BlendRow_Reference(&px, &pxSrc, 1);
+				}
+			}
+		}
+		return bmpResult;
+	}
+
+	void CheckCompose(const std::string &sCase, lib::SoftwareCompositor &oCompositor,
+		const lib::Resolution &oFrameSize, const std::vector<TestLayer *> &oLayers,
+		lib::PixelInt pxBackground, bool bPremultiplied)
+	{
+		// the list of visible layers, like GraphicsData::compose builds it
+		std::vector<lib::SoftwareCompositor::Layer> oVisibleLayers;
+		for (TestLayer *pLayer : oLayers)
+		{
+			pLayer->iGetRowCount = 0;
+			pLayer->bInvalidRow  = false;
+			if (pLayer->bVisible)
+				oVisibleLayers.push_back(
+				{
+					pLayer->bmp.size(), pLayer->oScreenPos, TestLayer::GetRow, pLayer
+				});
+		}
+
+		const TestBitmap bmpExpected =
+			ComposeReference(oFrameSize, oLayers, pxBackground, bPremultiplied);
+		TestBitmap bmpActual(oFrameSize.x, oFrameSize.y);
+		// garbage, to make sure every pixel is written
+		for (auto &px : bmpActual.pixels())
+		{
+			px = 0x12345678;
+		}
+		oCompositor.compose(oFrameSize, oVisibleLayers.data(), oVisibleLayers.size(),
+			pxBackground, bmpActual.pixels().data());
+
+		if (!rlGameCanvasTest::SameBitmaps(sCase.c_str(), bmpExpected, bmpActual))
+			return;
+
+		for (const TestLayer *pLayer : oLayers)
+		{
+			if (!RLGC_CHECK(!pLayer->bInvalidRow))
+				std::printf("  %s: a row was requested beyond the edge of a layer\n",
+					sCase.c_str());
+			if (!pLayer->bVisible && !RLGC_CHECK(pLayer->iGetRowCount == 0))
+				std::printf("  %s: a hidden layer was read\n", sCase.c_str());
+		}
+	}
+
+	void CheckCompositor(bool bPremultiplied, size_t iThreadCount)
+	{
+		const std::string sMode = std::string(bPremultiplied ? "premultiplied" : "straight") +
+			", " + std::to_string(iThreadCount) + " threads, ";
+
+		lib::SoftwareCompositor oCompositor(bPremultiplied, iThreadCount);
+		if (!RLGC_CHECK(oCompositor.threadCount() == iThreadCount))
+			std::printf("  %s: %zu threads\n", sMode.c_str(), oCompositor.threadCount());
+
+		std::mt19937 rng(2015);
+
+		// from bottom to top: a background that covers the frame, layers that are smaller than
+		// the frame and wrap around (one with a screen position beyond its size), a hidden opaque
+		// layer and a layer that's wider than the frame
+		TestLayer oBackground(97, 53, { 0, 0 }, true, false);
+		TestLayer oWrapping(40, 21, { 33, 17 }, true, true);
+		TestLayer oTiny(3, 2, { 7, 5 }, true, false);
+		TestLayer oHidden(97, 53, { 0, 0 }, false, false);
+		TestLayer oWide(150, 7, { 140, 500 }, true, true);
+		std::vector<TestLayer *> oLayers = { &oBackground, &oWrapping, &oTiny, &oHidden, &oWide };
+		for (TestLayer *pLayer : oLayers)
+		{
+			rlGameCanvasTest::FillRuns(pLayer->bmp, rng);
+			if (bPremultiplied)
+				lib::PremultiplyRow_Reference(pLayer->bmp.pixels().data(),
+					pLayer->bmp.pixels().size());
+		}
+		for (auto &px : oHidden.bmp.pixels())
+		{
+			px |= 0xFF000000;
+		}
+
+		// a background color with alpha, which must be ignored
+		const lib::PixelInt pxBackground = 0x40336699;
+
+		// a frame height that isn't a multiple of SoftwareCompositor::iBandRows
+		CheckCompose(sMode + "97x53", oCompositor, { 97, 53 }, oLayers, pxBackground,
+			bPremultiplied);
+		CheckCompose(sMode + "1x1", oCompositor, { 1, 1 }, oLayers, pxBackground,
+			bPremultiplied);
+		// wider than before --> bigger row buffers
+		CheckCompose(sMode + "211x40", oCompositor, { 211, 40 }, oLayers, pxBackground,
+			bPremultiplied);
+		CheckCompose(sMode + "no layers", oCompositor, { 30, 20 }, {}, pxBackground,
+			bPremultiplied);
+
+		// all layers visible
+		oHidden.bVisible = true;
+		CheckCompose(sMode + "no hidden layers", oCompositor, { 97, 53 }, oLayers, pxBackground,
+			bPremultiplied);
+
+		// an empty frame isn't touched
+		lib::PixelInt px = 0x12345678;
+		oCompositor.compose({ 0, 5 }, nullptr, 0, pxBackground, &px);
+		RLGC_CHECK(px == 0x12345678);
+	}
+
+
+
+	void TestCompose()
+	{
+		for (const bool bPremultiplied : { false, true })
+		{
+			for (const size_t iThreadCount : { 1, 2, 4, 7 })
+			{
+				CheckCompositor(bPremultiplied, iThreadCount);
+			}
+		}
+	}
+
+}
+
+
+
+int main()
+{
+	TestCompose();
+
+	return rlGameCanvasTest::Result();
+}
@@ -0,0 +1,347 @@
+// Tests of the compiled sprites: The spans must follow the rules of SpriteBaking (merged short
+// runs, translucent runs padded to the blend granularity, zeroed transparent pixels), and drawing
+// a sprite must give exactly the same pixels as drawing its bitmap via ApplyBitmapOverlay,
+// wherever it's drawn. A sprite baked at compile time must be identical to a Sprite.
+
+#include "Test.hpp"
+#include "TestBitmap.hpp"
+#include "private/PixelKernels.hpp" // PremultiplyRow_Reference
+#include <rlGameCanvas++/BakedSprite.hpp>
+#include <rlGameCanvas++/Sprite.hpp>
+
+#include <algorithm> // std::copy, std::equal, std::max
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <iterator> // std::size
+#include <random>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+using rlGameCanvasTest::TestBitmap;
+
+namespace
+{
+
+	// A hand-made sprite whose spans are checked at compile time.
+	// Row 0: 8 opaque pixels --> an opaque span
+	// Row 1: 3 translucent pixels --> a translucent span, padded to 8 pixels with zeroed pixels
+	// Row 2: 2 opaque pixels --> too short on their own, blended as a padded translucent span
+	// Row 3: nothing visible
+	constexpr auto pxArt = lib::PixelsFromArt<16, 4>(
+		"XXXXXXXX        "
+		"ooo             "
+		"XX              "
+		"                ",
+		{ { ' ', 0x00FFFFFF }, { 'X', 0xFF0000FF }, { 'o', 0x800000FF } }
+	);
+	constexpr auto oArt = lib::BakeSprite<16, pxArt>();
+
+	constexpr bool SameSpan(const lib::SpriteSpan &a, const lib::SpriteSpan &b)
+	{
+		return a.iX == b.iX && a.iLength == b.iLength && a.bOpaque == b.bOpaque &&
+			a.iDataOffset == b.iDataOffset;
+	}
+
+	static_assert(oArt.size().x == 16 && oArt.size().y == 4);
+	static_assert(std::size(oArt.oSpans) == 3 && std::size(oArt.pxPixels) == 24);
+	static_assert(oArt.iRowStart[0] == 0 && oArt.iRowStart[1] == 1 && oArt.iRowStart[2] == 2 &&
+		oArt.iRowStart[3] == 3 && oArt.iRowStart[4] == 3);
+	static_assert(SameSpan(oArt.oSpans[0], { 0, 8, true,  0 }));
+	static_assert(SameSpan(oArt.oSpans[1], { 0, 8, false, 8 }));
+	static_assert(SameSpan(oArt.oSpans[2], { 0, 8, false, 16 }));
+	static_assert(oArt.pxPixels[0] == 0xFF0000FF && oArt.pxPixels[8] == 0x800000FF &&
+		oArt.pxPixels[10] == 0x800000FF && oArt.pxPixels[11] == 0 && oArt.pxPixels[15] == 0 &&
+		oArt.pxPixels[17] == 0xFF0000FF && oArt.pxPixels[18] == 0);
+
+	// Random runs like FillRuns, generated at compile time.
+	constexpr lib::UInt iRandomWidth  = 37;
+	constexpr lib::UInt iRandomHeight = 23;
+	constexpr std::array<lib::PixelInt, iRandomWidth * iRandomHeight> MakeRandomRuns()
+	{
+		std::array<lib::PixelInt, iRandomWidth * iRandomHeight> oResult = {};
+
+		uint32_t iState = 2025;
+		const auto fnRandom = [&iState]()
+		{
+			iState = iState * 1664525 + 1013904223; // LCG
+			return iState >> 8;
+		};
+
+		for (size_t i = 0; i < oResult.size();)
+		{
+			const uint32_t iType   = fnRandom() % 3;
+			const uint32_t iLength = 1 + fnRandom() % ((fnRandom() % 2) ? 4 : 24);
+			for (uint32_t iRun = 0; iRun < iLength && i < oResult.size(); ++iRun, ++i)
+			{
+				uint32_t iAlpha = 0;
+				if (iType == 1)
+					iAlpha = 0xFF;
+				else if (iType == 2)
+					iAlpha = 1 + fnRandom() % 254;
+
+				oResult[i] = (fnRandom() & 0x00FFFFFF) | (iAlpha << 24);
+			}
+		}
+
+		return oResult;
+	}
+	constexpr auto pxRandomRuns = MakeRandomRuns();
+
+
+
+	// Compile a bitmap to spans like Sprite does and check every span.
+	void CheckSpans(const char *szCase, const lib::Bitmap &bmp)
+	{
+		std::vector<lib::SpriteRunType> oTypes(bmp.size.x);
+		const auto oCounts = lib::SpriteBaking::BakeRows(bmp.ppxData, bmp.size, oTypes.data(),
+			nullptr, nullptr, nullptr);
+
+		std::vector<lib::SpriteSpan> oSpans(oCounts.iSpans);
+		std::vector<size_t>          oRowStart((size_t)bmp.size.y + 1);
+		std::vector<lib::PixelInt>   oPixels(oCounts.iPixels);
+		lib::SpriteBaking::BakeRows(bmp.ppxData, bmp.size, oTypes.data(), oSpans.data(),
+			oRowStart.data(), oPixels.data());
+		if (!RLGC_CHECK(oRowStart[0] == 0 && oRowStart[bmp.size.y] == oSpans.size()))
+			return;
+
+		for (lib::UInt iY = 0; iY < bmp.size.y; ++iY)
+		{
+			const lib::PixelInt *pRow = bmp.ppxData + (size_t)iY * bmp.size.x;
+
+			lib::UInt iCovered = 0; // all visible pixels left of this are part of a span
+			for (size_t iSpan = oRowStart[iY]; iSpan < oRowStart[iY + 1]; ++iSpan)
+			{
+				const auto &span = oSpans[iSpan];
+				const lib::UInt iEnd = span.iX + span.iLength;
+
+				bool bValid = span.iLength > 0 && span.iX >= iCovered && iEnd <= bmp.size.x;
+				for (lib::UInt iX = iCovered; bValid && iX < span.iX; ++iX)
+				{
+					bValid = (pRow[iX] >> 24) == 0; // skipped pixels must be invisible
+				}
+
+				// translucent spans are padded to whole blocks of the blend kernels, unless they
+				// reach the end of the row
+				if (!span.bOpaque)
+					bValid = bValid && (span.iLength % lib::SpriteBaking::iBlendGranularity == 0 ||
+						iEnd == bmp.size.x);
+
+				for (lib::UInt iX = span.iX; bValid && iX < iEnd; ++iX)
+				{
+					const lib::PixelInt px = oPixels[span.iDataOffset + (iX - span.iX)];
+					if (span.bOpaque)
+						bValid = (pRow[iX] >> 24) == 0xFF && px == pRow[iX];
+					else
+						bValid = px == (((pRow[iX] >> 24) == 0) ? 0 : pRow[iX]);
+				}
+
+				if (!RLGC_CHECK(bValid))
+				{
+					std::printf("  %s: invalid span %u-%u (%s) in row %u\n", szCase,
+						unsigned(span.iX), unsigned(iEnd), span.bOpaque ? "opaque" : "blended",
+						unsigned(iY));
+					return;
+				}
+				iCovered = iEnd;
+			}
+
+			for (lib::UInt iX = iCovered; iX < bmp.size.x; ++iX)
+			{
+				if (!RLGC_CHECK((pRow[iX] >> 24) == 0))
+				{
+					std::printf("  %s: visible pixel %u/%u isn't part of any span\n", szCase,
+						unsigned(iX), unsigned(iY));
+					return;
+				}
+			}
+		}
+	}
+
+	// Draw the sprite and its bitmap at all kinds of positions, including partly and fully
+	// clipped ones, and compare the results and the dirty rectangles.
+	void CheckDraw(const char *szCase, const TestBitmap &oBase, const TestBitmap &oSpriteBitmap,
+		lib::BitmapOverlayStrategy eStrategy)
+	{
+		const lib::Sprite oSprite(oSpriteBitmap.bmp());
+
+		const lib::Int iBaseW   = lib::Int(oBase.size().x);
+		const lib::Int iBaseH   = lib::Int(oBase.size().y);
+		const lib::Int iSpriteW = lib::Int(oSpriteBitmap.size().x);
+		const lib::Int iSpriteH = lib::Int(oSpriteBitmap.size().y);
+
+		const lib::Int iPositions[][2] =
+		{
+			{ 0, 0 }, { 5, 3 }, { -7, -4 }, { iBaseW - 10, iBaseH - 5 },
+			{ (iBaseW - iSpriteW) / 2, (iBaseH - iSpriteH) / 2 },
+			{ 1 - iSpriteW, 1 - iSpriteH }, { iBaseW - 1, iBaseH - 1 },
+			{ -iSpriteW - 3, 0 }, { iBaseW, 2 }, { 3, -iSpriteH }
+		};
+
+		for (const auto &pos : iPositions)
+		{
+			TestBitmap oExpected = oBase;
+			TestBitmap oActual   = oBase;
+
+			lib::Rect oExpectedRects[2] = {};
+			lib::Rect oActualRects[2]   = {};
+			lib::DirtyRects oExpectedDirty = { oExpectedRects, 2, 0, false };
+			lib::DirtyRects oActualDirty   = { oActualRects,   2, 0, false };
+
+			RLGC_CHECK(lib::ApplyBitmapOverlay(&oExpected.bmp(), &oSpriteBitmap.bmp(),
+				pos[0], pos[1], eStrategy, &oExpectedDirty));
+			RLGC_CHECK(lib::ApplySpriteOverlay(&oActual.bmp(), oSprite, pos[0], pos[1],
+				eStrategy, &oActualDirty));
+
+			char szPosCase[128];
+			std::snprintf(szPosCase, sizeof(szPosCase), "%s at %d/%d", szCase, int(pos[0]),
+				int(pos[1]));
+			rlGameCanvasTest::SameBitmaps(szPosCase, oExpected, oActual);
+
+			bool bSameRects = oExpectedDirty.iCount == oActualDirty.iCount;
+			for (lib::UInt i = 0; bSameRects && i < oExpectedDirty.iCount; ++i)
+			{
+				const auto &a = oExpectedRects[i];
+				const auto &b = oActualRects[i];
+				bSameRects = a.iLeft == b.iLeft && a.iTop == b.iTop && a.iRight == b.iRight &&
+					a.iBottom == b.iBottom;
+			}
+			if (!RLGC_CHECK(bSameRects))
+				std::printf("  %s: different dirty rectangles\n", szPosCase);
+		}
+	}
+
+
+
+	void TestSpans()
+	{
+		std::mt19937 rng(2005);
+
+		TestBitmap bmp(53, 40);
+		rlGameCanvasTest::FillRuns(bmp, rng);
+		CheckSpans("random runs", bmp.bmp());
+
+		// a single pixel wide sprite, where every run reaches the end of the row
+		TestBitmap bmpNarrow(1, 16);
+		rlGameCanvasTest::FillRuns(bmpNarrow, rng);
+		CheckSpans("narrow", bmpNarrow.bmp());
+
+		// exactly the lengths around the merge threshold and the blend granularity
+		TestBitmap bmpEdges(64, 1);
+		auto &px = bmpEdges.pixels();
+		for (size_t i = 0; i < px.size(); ++i)
+		{
+			px[i] = (i < 7 || (i >= 15 && i < 23)) ? 0xFF112233 : // opaque: 7, 8 pixels
+				(i < 9 || (i >= 30 && i < 37)) ? 0x80445566 :      // translucent
+				0x00778899;                                        // transparent, with color
+		}
+		CheckSpans("edges", bmpEdges.bmp());
+	}
+
+	// Compare the spans and pixels of a baked sprite with the ones compiled at runtime, the way
+	// Sprite compiles them, and draw both.
+	template <typename TBakedSprite>
+	void CheckBaked(const char *szCase, const TBakedSprite &oBaked, const lib::PixelInt *ppxData)
+	{
+		const lib::Resolution size = oBaked.size();
+		TestBitmap oSpriteBitmap(size.x, size.y);
+		std::copy(ppxData, ppxData + oSpriteBitmap.pixels().size(),
+			oSpriteBitmap.pixels().begin());
+		CheckSpans(szCase, oSpriteBitmap.bmp());
+
+		std::vector<lib::SpriteRunType> oTypes(size.x);
+		const auto oCounts = lib::SpriteBaking::BakeRows(ppxData, size, oTypes.data(),
+			nullptr, nullptr, nullptr);
+		std::vector<lib::SpriteSpan> oSpans(oCounts.iSpans);
+		std::vector<size_t>          oRowStart((size_t)size.y + 1);
+		std::vector<lib::PixelInt>   oPixels(oCounts.iPixels);
+		lib::SpriteBaking::BakeRows(ppxData, size, oTypes.data(), oSpans.data(), oRowStart.data(),
+			oPixels.data());
+
+		bool bSame = std::size(oBaked.oSpans) == std::max<size_t>(oSpans.size(), 1) &&
+			std::size(oBaked.pxPixels) == std::max<size_t>(oPixels.size(), 1) &&
+			std::equal(oRowStart.begin(), oRowStart.end(), oBaked.iRowStart) &&
+			std::equal(oSpans.begin(), oSpans.end(), oBaked.oSpans, SameSpan) &&
+			std::equal(oPixels.begin(), oPixels.end(), oBaked.pxPixels);
+		if (!RLGC_CHECK(bSame))
+		{
+			std::printf("  %s: the baked sprite differs from the runtime sprite\n", szCase);
+			return;
+		}
+
+		std::mt19937 rng(25);
+		TestBitmap oBase(64, 48);
+		rlGameCanvasTest::FillRandom(oBase, rng, 1);
+		const lib::Sprite oSprite(oSpriteBitmap.bmp());
+		for (const auto eStrategy :
+			{ lib::BitmapOverlayStrategy::Blend, lib::BitmapOverlayStrategy::BlendPremultiplied })
+		{
+			TestBitmap oExpected = oBase;
+			TestBitmap oActual   = oBase;
+			RLGC_CHECK(lib::ApplySpriteOverlay(&oExpected.bmp(), oSprite, -3, 30, eStrategy));
+			RLGC_CHECK(lib::ApplySpriteOverlay(&oActual.bmp(), oBaked, -3, 30, eStrategy));
+			rlGameCanvasTest::SameBitmaps(szCase, oExpected, oActual);
+		}
+	}
+
+	void TestBaked()
+	{
+		CheckBaked("baked art", oArt, pxArt.data());
+
+		constexpr auto oRandomRuns = lib::BakeSprite<iRandomWidth, pxRandomRuns>();
+		CheckBaked("baked random runs", oRandomRuns, pxRandomRuns.data());
+	}
+
+	void TestDraw()
+	{
+		std::mt19937 rng(5);
+
+		TestBitmap oSpriteBitmap(37, 23);
+		rlGameCanvasTest::FillRuns(oSpriteBitmap, rng);
+
+		// skipping a transparent pixel only equals blending it if the destination isn't fully
+		// transparent itself
+		TestBitmap oBase(64, 48);
+		rlGameCanvasTest::FillRandom(oBase, rng, 1);
+		CheckDraw("Blend", oBase, oSpriteBitmap, lib::BitmapOverlayStrategy::Blend);
+
+		// a base that's smaller than the sprite, so it's clipped on all sides at once
+		TestBitmap oSmallBase(16, 8);
+		rlGameCanvasTest::FillRandom(oSmallBase, rng, 1);
+		CheckDraw("Blend, small base", oSmallBase, oSpriteBitmap,
+			lib::BitmapOverlayStrategy::Blend);
+
+		// premultiplied: the transparent pixels are zero, like in any valid premultiplied bitmap
+		TestBitmap oPremultipliedSprite = oSpriteBitmap;
+		lib::PremultiplyRow_Reference(oPremultipliedSprite.pixels().data(),
+			oPremultipliedSprite.pixels().size());
+		TestBitmap oPremultipliedBase = oBase;
+		lib::PremultiplyRow_Reference(oPremultipliedBase.pixels().data(),
+			oPremultipliedBase.pixels().size());
+		CheckDraw("BlendPremultiplied", oPremultipliedBase, oPremultipliedSprite,
+			lib::BitmapOverlayStrategy::BlendPremultiplied);
+		CheckDraw("BlendPremultiplied, small base", oSmallBase, oPremultipliedSprite,
+			lib::BitmapOverlayStrategy::BlendPremultiplied);
+
+		// only blending is supported
+		TestBitmap oCopy = oBase;
+		RLGC_CHECK(!lib::ApplySpriteOverlay(&oCopy.bmp(), lib::Sprite(oSpriteBitmap.bmp()), 0, 0,
+			lib::BitmapOverlayStrategy::Replace));
+		rlGameCanvasTest::SameBitmaps("Replace", oBase, oCopy);
+	}
+
+}
+
+
+
+int main()
+{
+	TestSpans();
+	TestDraw();
+	TestBaked();
+
+	return rlGameCanvasTest::Result();
+}
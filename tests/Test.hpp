@@ -0,0 +1,62 @@
+/*
+	TEST
+	Minimal helpers for the regression tests, so they don't need any third-party framework.
+
+	Every test program counts its failed checks and returns a non-zero exit code if there were
+	any, which is all CTest needs.
+*/
+#ifndef RLGAMECANVAS_TEST
+#define RLGAMECANVAS_TEST
+
+
+
+
+
+#include <cstdio>
+
+
+
+namespace rlGameCanvasTest
+{
+
+	// The count of failed checks of the current test program.
+	inline int &FailureCount()
+	{
+		static int iFailures = 0;
+		return iFailures;
+	}
+
+	inline bool Check(bool bCondition, const char *szCondition, const char *szFile, int iLine)
+	{
+		if (!bCondition)
+		{
+			++FailureCount();
+			std::printf("%s(%d): check failed: %s\n", szFile, iLine, szCondition);
+		}
+		return bCondition;
+	}
+
+	// The exit code of a test program.
+	inline int Result()
+	{
+		if (FailureCount() == 0)
+		{
+			std::printf("all checks passed\n");
+			return 0;
+		}
+
+		std::printf("%d check(s) failed\n", FailureCount());
+		return 1;
+	}
+
+}
+
+// Evaluates to the result of the condition, so more details can be printed on failure.
+#define RLGC_CHECK(condition) \
+	::rlGameCanvasTest::Check(bool(condition), #condition, __FILE__, __LINE__)
+
+
+
+
+
+#endif // RLGAMECANVAS_TEST
\ No newline at end of file
@@ -0,0 +1,133 @@
+/*
+	TEST BITMAP
+	Bitmaps that own their pixels, for the tests of the drawing functions: Filling them with
+	random pixels and comparing them bit by bit.
+*/
+#ifndef RLGAMECANVAS_TEST_TESTBITMAP
+#define RLGAMECANVAS_TEST_TESTBITMAP
+
+
+
+
+
+#include "Test.hpp"
+#include <rlGameCanvas++/Bitmap.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+
+namespace rlGameCanvasTest
+{
+
+	class TestBitmap final
+	{
+	public: // methods
+
+		TestBitmap(rlGameCanvasLib::UInt iWidth, rlGameCanvasLib::UInt iHeight) :
+			m_oPixels((size_t)iWidth * iHeight, 0),
+			m_bmp{ m_oPixels.data(), { iWidth, iHeight } }
+		{}
+
+		TestBitmap(const TestBitmap &other) :
+			m_oPixels(other.m_oPixels),
+			m_bmp{ m_oPixels.data(), other.m_bmp.size }
+		{}
+
+		TestBitmap &operator=(const TestBitmap &other)
+		{
+			m_oPixels = other.m_oPixels;
+			m_bmp     = { m_oPixels.data(), other.m_bmp.size };
+			return *this;
+		}
+
+		rlGameCanvasLib::Bitmap       &bmp()       { return m_bmp; }
+		const rlGameCanvasLib::Bitmap &bmp() const { return m_bmp; }
+
+		const rlGameCanvasLib::Resolution &size() const { return m_bmp.size; }
+
+		std::vector<rlGameCanvasLib::PixelInt>       &pixels()       { return m_oPixels; }
+		const std::vector<rlGameCanvasLib::PixelInt> &pixels() const { return m_oPixels; }
+
+
+	private: // variables
+
+		std::vector<rlGameCanvasLib::PixelInt> m_oPixels;
+		rlGameCanvasLib::Bitmap                m_bmp;
+
+	};
+
+
+
+	// Random colors with random alpha values of at least iMinAlpha.
+	inline void FillRandom(TestBitmap &bmp, std::mt19937 &rng, uint32_t iMinAlpha = 0)
+	{
+		for (auto &px : bmp.pixels())
+		{
+			const uint32_t iAlpha = iMinAlpha + rng() % (256 - iMinAlpha);
+			px = (rng() & 0x00FFFFFF) | (iAlpha << 24);
+		}
+	}
+
+	// Rows of random runs of opaque, translucent and fully transparent pixels, like sprites have.
+	// Most runs are short, so runs are merged and padded in all kinds of combinations. The fully
+	// transparent pixels have random colors.
+	inline void FillRuns(TestBitmap &bmp, std::mt19937 &rng)
+	{
+		const auto &size = bmp.size();
+		for (rlGameCanvasLib::UInt iY = 0; iY < size.y; ++iY)
+		{
+			uint32_t *const pRow = bmp.pixels().data() + (size_t)iY * size.x;
+			for (rlGameCanvasLib::UInt iX = 0; iX < size.x;)
+			{
+				const uint32_t iType   = rng() % 3;
+				const uint32_t iLength = 1 + rng() % ((rng() % 2) ? 4 : 24);
+				for (uint32_t i = 0; i < iLength && iX < size.x; ++i, ++iX)
+				{
+					uint32_t iAlpha = 0;
+					if (iType == 1)
+						iAlpha = 0xFF;
+					else if (iType == 2)
+						iAlpha = 1 + rng() % 254;
+
+					pRow[iX] = (rng() & 0x00FFFFFF) | (iAlpha << 24);
+				}
+			}
+		}
+	}
+
+	// Compare two bitmaps bit by bit. Prints the first difference.
+	inline bool SameBitmaps(const char *szCase, const TestBitmap &oExpected,
+		const TestBitmap &oActual)
+	{
+		if (!RLGC_CHECK(oExpected.size().x == oActual.size().x &&
+			oExpected.size().y == oActual.size().y))
+		{
+			std::printf("  %s: different sizes\n", szCase);
+			return false;
+		}
+
+		const auto &size = oExpected.size();
+		for (size_t i = 0; i < oExpected.pixels().size(); ++i)
+		{
+			if (!RLGC_CHECK(oExpected.pixels()[i] == oActual.pixels()[i]))
+			{
+				std::printf("  %s: pixel %zu/%zu is %08X instead of %08X\n", szCase,
+					i % size.x, i / size.x, unsigned(oActual.pixels()[i]),
+					unsigned(oExpected.pixels()[i]));
+				return false;
+			}
+		}
+		return true;
+	}
+
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_TEST_TESTBITMAP
\ No newline at end of file
@@ -0,0 +1,185 @@
+// Benchmark of bilinear scaling via ApplyBitmapOverlay_Scaled, compared with the previous
+// implementation that interpolated every pixel via doubles (kept below as the baseline).
+//
+// Prints the average time per call for a few typical scaling ratios, as well as the maximum
+// difference per channel between the two implementations (the fixed point version uses 8 bit
+// weights, so a few units are expected).
+
+#include <rlGameCanvas++/Bitmap.hpp>
+#include <rlGameCanvas++/Pixel.hpp>
+
+#include <algorithm> // std::min, std::max
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>   // std::abs
+#include <memory>    // std::unique_ptr
+#include <random>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+namespace
+{
+
+	// The bilinear scaling of ApplyBitmapOverlay_Scaled before it was rewritten to fixed point,
+	// reduced to scaling the whole overlay into a buffer of iWidth * iHeight pixels.
+	namespace Baseline
+	{
+
+		constexpr double lerp(double a, double b, double t) noexcept
+		{
+			return a * (1.0 - t) + (b * t);
+		}
+
+		lib::Pixel PixelLerp(const lib::Pixel &px1, const lib::Pixel &px2, double dOffset)
+		{
+			lib::Pixel pxResult;
+			pxResult.rgba.a = (uint8_t)lerp(px1.rgba.a, px2.rgba.a, dOffset);
+			pxResult.rgba.r = (uint8_t)lerp(px1.rgba.r, px2.rgba.r, dOffset);
+			pxResult.rgba.g = (uint8_t)lerp(px1.rgba.g, px2.rgba.g, dOffset);
+			pxResult.rgba.b = (uint8_t)lerp(px1.rgba.b, px2.rgba.b, dOffset);
+			return pxResult;
+		}
+
+		void ScaleBilinear(const lib::Bitmap &bmp, lib::UInt iWidth, lib::UInt iHeight,
+			lib::Pixel *pDest)
+		{
+			const auto  &src     = bmp.ppxData;
+			const double dScaleX = (double)bmp.size.x / iWidth;
+			const double dScaleY = (double)bmp.size.y / iHeight;
+
+			struct HSamplingInfo
+			{
+				lib::UInt iIndexLeft, iIndexRight;
+				double    dOffsetX;
+			};
+
+			auto up_oSamplePixels = std::make_unique<HSamplingInfo[]>(iWidth);
+			for (size_t iX = 0; iX < iWidth; ++iX)
+			{
+				auto &si = up_oSamplePixels[iX];
+				const double dXAbs = dScaleX * iX;
+
+				si.iIndexLeft  = lib::UInt(dXAbs);
+				si.iIndexRight = lib::UInt(std::min<double>(bmp.size.x - 1, si.iIndexLeft + 1));
+				si.dOffsetX    = dXAbs - si.iIndexLeft;
+			}
+
+			for (size_t iY = 0; iY < iHeight; ++iY)
+			{
+				const double dYAbs = dScaleY * iY;
+
+				const lib::UInt iIndexTop    = lib::UInt(dYAbs);
+				const lib::UInt iIndexBottom =
+					lib::UInt(std::min<double>(bmp.size.y - 1, iIndexTop + 1));
+
+				const double dOffsetY = dYAbs - iIndexTop;
+
+				for (size_t iX = 0; iX < iWidth; ++iX, ++pDest)
+				{
+					const auto &si = up_oSamplePixels[iX];
+
+					const lib::Pixel pxSample[4] =
+					{
+						src[iIndexTop    * bmp.size.x + si.iIndexLeft ],
+						src[iIndexTop    * bmp.size.x + si.iIndexRight],
+						src[iIndexBottom * bmp.size.x + si.iIndexLeft ],
+						src[iIndexBottom * bmp.size.x + si.iIndexRight]
+					};
+
+					const lib::Pixel pxTop    = PixelLerp(pxSample[0], pxSample[1], si.dOffsetX);
+					const lib::Pixel pxBottom = PixelLerp(pxSample[2], pxSample[3], si.dOffsetX);
+
+					*pDest = PixelLerp(pxTop, pxBottom, dOffsetY);
+				}
+			}
+		}
+
+	}
+
+
+
+	// The average time of a call to fn, in milliseconds.
+	template <typename TFunc>
+	double MeasureMilliseconds(unsigned iRepetitions, const TFunc &fn)
+	{
+		const auto tpStart = std::chrono::steady_clock::now();
+		for (unsigned i = 0; i < iRepetitions; ++i)
+		{
+			fn();
+		}
+		const auto tpEnd = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::milli>(tpEnd - tpStart).count() / iRepetitions;
+	}
+
+}
+
+
+
+int main()
+{
+	struct Config
+	{
+		lib::Resolution resSrc;
+		lib::Resolution resDest;
+	};
+	constexpr Config oCONFIGS[] =
+	{
+		{ { 256, 240 }, { 1024,  960 } },
+		{ { 512, 480 }, {  300,  280 } },
+		{ {  64,  64 }, { 1920, 1080 } },
+	};
+	constexpr unsigned iREPETITIONS = 20;
+
+	std::mt19937 rng(2);
+	for (const auto &cfg : oCONFIGS)
+	{
+		std::vector<lib::PixelInt> oSrc((size_t)cfg.resSrc.x * cfg.resSrc.y);
+		for (auto &px : oSrc)
+		{
+			px = rng();
+		}
+		const lib::Bitmap bmpSrc = { oSrc.data(), cfg.resSrc };
+
+		const size_t iDestPixels = (size_t)cfg.resDest.x * cfg.resDest.y;
+		std::vector<lib::Pixel>    oBaseline(iDestPixels);
+		std::vector<lib::PixelInt> oDest(iDestPixels);
+		lib::Bitmap bmpDest = { oDest.data(), cfg.resDest };
+
+		const double dBaseline = MeasureMilliseconds(iREPETITIONS, [&]()
+			{
+				Baseline::ScaleBilinear(bmpSrc, cfg.resDest.x, cfg.resDest.y, oBaseline.data());
+			}
+		);
+		const double dCurrent = MeasureMilliseconds(iREPETITIONS, [&]()
+			{
+				lib::ApplyBitmapOverlay_Scaled(&bmpDest, &bmpSrc, 0, 0,
+					cfg.resDest.x, cfg.resDest.y, lib::BitmapOverlayStrategy::Replace,
+					lib::BitmapScalingStrategy::Bilinear);
+			}
+		);
+
+		int iMaxDiff = 0;
+		for (size_t i = 0; i < iDestPixels; ++i)
+		{
+			for (unsigned iShift = 0; iShift < 32; iShift += 8)
+			{
+				const int iCurrent  = int((oDest[i]         >> iShift) & 0xFF);
+				const int iBaseline = int((oBaseline[i].val >> iShift) & 0xFF);
+				iMaxDiff = std::max(iMaxDiff, std::abs(iCurrent - iBaseline));
+			}
+		}
+
+		std::printf("%4ux%-4u -> %4ux%-4u: double %6.2f ms, fixed point %6.2f ms (%4.1fx), "
+			"max. channel difference %d\n",
+			unsigned(cfg.resSrc.x), unsigned(cfg.resSrc.y),
+			unsigned(cfg.resDest.x), unsigned(cfg.resDest.y),
+			dBaseline, dCurrent, dBaseline / dCurrent, iMaxDiff);
+	}
+
+	return 0;
+}
@@ -0,0 +1,117 @@
+// Startup benchmark: Creates the graphics data of a few typical modes (all layer buffers carved
+// from a single arena) and prints the time per create() call as well as the peak resident memory
+// of the process.
+//
+// The OpenGL calls are no-ops (NullGL.cpp), so only the CPU side is measured. To compare with an
+// earlier version of the library, build the benchmark against that version's sources.
+// The peak memory is the maximum over the whole process, so the modes are sorted by size.
+// Memory that was allocated but not touched yet doesn't count, like on Windows.
+
+#include "private/GraphicsData.hpp"
+#include <rlGameCanvas/Definitions.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include <sys/resource.h> // getrusage
+
+
+
+namespace lib = rlGameCanvasLib;
+
+namespace
+{
+
+	double PeakResidentMiB()
+	{
+		rusage oUsage = {};
+		getrusage(RUSAGE_SELF, &oUsage);
+#ifdef __APPLE__
+		return oUsage.ru_maxrss / (1024.0 * 1024.0); // bytes
+#else
+		return oUsage.ru_maxrss / 1024.0; // kilobytes
+#endif
+	}
+
+	lib::LayerMetadata MakeLayer(lib::UInt iWidth, lib::UInt iHeight, lib::UInt iFormat,
+		lib::UInt iFlags = 0)
+	{
+		lib::LayerMetadata oResult = {};
+		oResult.oLayerSize = { iWidth, iHeight };
+		oResult.iFormat    = iFormat;
+		oResult.iFlags     = iFlags;
+		return oResult;
+	}
+
+	struct Scenario
+	{
+		const char    *szName;
+		lib::Mode_CPP  mode;
+	};
+
+}
+
+
+
+int main()
+{
+	constexpr unsigned iREPETITIONS = 5;
+
+	constexpr lib::UInt iRGBA    = RL_GAMECANVAS_LAY_FORMAT_RGBA;
+	constexpr lib::UInt iINDEXED = RL_GAMECANVAS_LAY_FORMAT_INDEXED8;
+
+	std::vector<Scenario> oScenarios(3);
+
+	oScenarios[0].szName            = "retro: 320x240, 3 RGBA layers + 1 indexed";
+	oScenarios[0].mode.oScreenSize  = { 320, 240 };
+	oScenarios[0].mode.oLayerMetadata =
+	{
+		MakeLayer(640, 480, iRGBA), MakeLayer(320, 240, iINDEXED),
+		MakeLayer(320, 240, iRGBA), MakeLayer(320, 240, iRGBA, RL_GAMECANVAS_LAY_DETECT_CHANGES)
+	};
+
+	oScenarios[1].szName            = "full HD: 4 RGBA layers";
+	oScenarios[1].mode.oScreenSize  = { 1920, 1080 };
+	oScenarios[1].mode.oLayerMetadata =
+	{
+		MakeLayer(3840, 1080, iRGBA), MakeLayer(1920, 1080, iRGBA),
+		MakeLayer(1920, 1080, iRGBA), MakeLayer(1920, 1080, iRGBA, RL_GAMECANVAS_LAY_DETECT_CHANGES)
+	};
+
+	oScenarios[2].szName            = "huge: 3 RGBA layers + 1 indexed, 4096x4096 each";
+	oScenarios[2].mode.oScreenSize  = { 1920, 1080 };
+	oScenarios[2].mode.oLayerMetadata =
+	{
+		MakeLayer(4096, 4096, iRGBA), MakeLayer(4096, 4096, iRGBA),
+		MakeLayer(4096, 4096, iINDEXED), MakeLayer(4096, 4096, iRGBA)
+	};
+
+	for (auto &oScenario : oScenarios)
+	{
+		oScenario.mode.oTilesets.resize(oScenario.mode.oLayerMetadata.size());
+
+		GraphicsData oData;
+		double dTotalMilliseconds = 0.0;
+		for (unsigned i = 0; i < iREPETITIONS; ++i)
+		{
+			const auto tpStart = std::chrono::steady_clock::now();
+			const bool bCreated = oData.create(oScenario.mode);
+			const auto tpEnd = std::chrono::steady_clock::now();
+
+			if (!bCreated)
+			{
+				std::printf("%s: create() failed\n", oScenario.szName);
+				return 1;
+			}
+			dTotalMilliseconds +=
+				std::chrono::duration<double, std::milli>(tpEnd - tpStart).count();
+		}
+
+		std::printf("%-50s %8.3f ms per create(), %7.1f MiB estimated, peak RSS %7.1f MiB\n",
+			oScenario.szName, dTotalMilliseconds / iREPETITIONS,
+			oData.memoryUsage() / (1024.0 * 1024.0), PeakResidentMiB());
+	}
+
+	return 0;
+}
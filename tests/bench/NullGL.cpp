@@ -0,0 +1,41 @@
+// OpenGL 1.1 functions that do nothing, so the graphics data can be benchmarked without a
+// context or a graphics card. Only the functions referenced by the library's sources exist.
+
+#include <gl/GL.h>
+
+
+
+extern "C"
+{
+
+	const GLubyte *APIENTRY glGetString(GLenum) { return reinterpret_cast<const GLubyte *>("1.1"); }
+	GLenum APIENTRY glGetError() { return GL_NO_ERROR; }
+
+	void APIENTRY glGenTextures(GLsizei n, GLuint *textures)
+	{
+		for (GLsizei i = 0; i < n; ++i)
+		{
+			textures[i] = GLuint(i + 1);
+		}
+	}
+	void APIENTRY glDeleteTextures(GLsizei, const GLuint *) {}
+	void APIENTRY glBindTexture(GLenum, GLuint) {}
+	void APIENTRY glTexParameteri(GLenum, GLenum, GLint) {}
+	void APIENTRY glTexEnvf(GLenum, GLenum, GLfloat) {}
+	void APIENTRY glPixelStorei(GLenum, GLint) {}
+	void APIENTRY glTexImage2D(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum,
+		const void *) {}
+	void APIENTRY glTexSubImage2D(GLenum, GLint, GLint, GLint, GLsizei, GLsizei, GLenum, GLenum,
+		const void *) {}
+
+	void APIENTRY glViewport(GLint, GLint, GLsizei, GLsizei) {}
+	void APIENTRY glClearColor(GLfloat, GLfloat, GLfloat, GLfloat) {}
+	void APIENTRY glClear(GLbitfield) {}
+	void APIENTRY glBegin(GLenum) {}
+	void APIENTRY glEnd() {}
+	void APIENTRY glTexCoord2f(GLfloat, GLfloat) {}
+	void APIENTRY glVertex2f(GLfloat, GLfloat) {}
+	void APIENTRY glVertex3f(GLfloat, GLfloat, GLfloat) {}
+	void APIENTRY glVertex3i(GLint, GLint, GLint) {}
+
+}
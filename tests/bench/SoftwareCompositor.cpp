@@ -0,0 +1,157 @@
+// Headless benchmark of the software compositor: Blends a typical stack of layers into a frame,
+// with different thread counts of the WorkerPool, without any window or OpenGL context.
+//
+// Prints the average time per frame and the speedup compared to a single thread, for a few
+// typical frame sizes.
+
+#include "private/SoftwareCompositor.hpp"
+
+#include <algorithm> // std::max
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+
+
+namespace lib = rlGameCanvasLib;
+
+namespace
+{
+
+	// An RGBA layer that returns pointers to its own pixels.
+	struct RGBALayer
+	{
+		lib::Resolution            oSize;
+		std::vector<lib::PixelInt> oPixels;
+
+		static const lib::PixelInt *GetRow(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt /* iCount */, lib::PixelInt * /* pBuffer */)
+		{
+			const auto &layer = *static_cast<const RGBALayer *>(pvLayer);
+			return layer.oPixels.data() + ((size_t)iY * layer.oSize.x + iX);
+		}
+	};
+
+	// An indexed layer whose rows must be resolved to the row buffer first.
+	struct IndexedLayer
+	{
+		lib::Resolution       oSize;
+		std::vector<uint8_t>  oIndices;
+		lib::PixelInt         pxPalette[256];
+
+		static const lib::PixelInt *GetRow(const void *pvLayer, lib::UInt iX, lib::UInt iY,
+			lib::UInt iCount, lib::PixelInt *pBuffer)
+		{
+			const auto &layer = *static_cast<const IndexedLayer *>(pvLayer);
+			const uint8_t *pIndices = layer.oIndices.data() + ((size_t)iY * layer.oSize.x + iX);
+			for (lib::UInt i = 0; i < iCount; ++i)
+			{
+				pBuffer[i] = layer.pxPalette[pIndices[i]];
+			}
+			return pBuffer;
+		}
+	};
+
+	// Random pixels with the given share of opaque and fully transparent pixels; the rest is
+	// translucent.
+	lib::PixelInt RandomPixel(std::mt19937 &rng, unsigned iOpaquePercent,
+		unsigned iTransparentPercent)
+	{
+		const unsigned iRandom = rng() % 100;
+		lib::PixelInt iAlpha;
+		if (iRandom < iOpaquePercent)
+			iAlpha = 0xFF;
+		else if (iRandom < iOpaquePercent + iTransparentPercent)
+			iAlpha = 0;
+		else
+			iAlpha = 1 + rng() % 254;
+
+		return (rng() & 0x00FFFFFF) | (iAlpha << 24);
+	}
+
+}
+
+
+
+int main()
+{
+	constexpr lib::Resolution oFRAME_SIZES[] = { { 640, 360 }, { 1280, 720 }, { 1920, 1080 } };
+	constexpr unsigned iFRAMES = 60;
+
+	std::vector<size_t> oThreadCounts = { 1, 2, 4 };
+	const size_t iHardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	if (iHardwareThreads > 4)
+		oThreadCounts.push_back(iHardwareThreads);
+	std::printf("%zu hardware thread(s)\n", iHardwareThreads);
+
+	std::mt19937 rng(15);
+	for (const auto &oFrameSize : oFRAME_SIZES)
+	{
+		// a scrolling background, a mostly transparent sprite layer, an indexed layer and a
+		// translucent overlay; all bigger than the frame, so the rows wrap around
+		const lib::Resolution oLayerSize = { oFrameSize.x + 100, oFrameSize.y + 60 };
+		const size_t iLayerPixels = (size_t)oLayerSize.x * oLayerSize.y;
+
+		RGBALayer oBackground = { oLayerSize, std::vector<lib::PixelInt>(iLayerPixels) };
+		RGBALayer oSprites    = { oLayerSize, std::vector<lib::PixelInt>(iLayerPixels) };
+		RGBALayer oOverlay    = { oLayerSize, std::vector<lib::PixelInt>(iLayerPixels) };
+		for (size_t i = 0; i < iLayerPixels; ++i)
+		{
+			oBackground.oPixels[i] = RandomPixel(rng, 100, 0);
+			oSprites   .oPixels[i] = RandomPixel(rng, 20, 75);
+			oOverlay   .oPixels[i] = RandomPixel(rng, 0, 50);
+		}
+
+		IndexedLayer oIndexed = { oLayerSize, std::vector<uint8_t>(iLayerPixels), {} };
+		for (auto &i : oIndexed.oIndices)
+		{
+			i = uint8_t(rng());
+		}
+		for (auto &px : oIndexed.pxPalette)
+		{
+			px = RandomPixel(rng, 40, 40);
+		}
+
+		std::vector<lib::SoftwareCompositor::Layer> oLayers =
+		{
+			{ oLayerSize, {  0,  0 }, RGBALayer   ::GetRow, &oBackground },
+			{ oLayerSize, { 37, 11 }, IndexedLayer::GetRow, &oIndexed    },
+			{ oLayerSize, { 80, 50 }, RGBALayer   ::GetRow, &oSprites    },
+			{ oLayerSize, {  5, 59 }, RGBALayer   ::GetRow, &oOverlay    },
+		};
+		std::vector<lib::PixelInt> oFrame((size_t)oFrameSize.x * oFrameSize.y);
+
+		double dSingleThreaded = 0.0;
+		for (const size_t iThreads : oThreadCounts)
+		{
+			lib::SoftwareCompositor oCompositor(false, iThreads);
+			oCompositor.compose(oFrameSize, oLayers.data(), oLayers.size(), lib::Pixel(0),
+				oFrame.data()); // warm-up: thread startup, row buffers
+
+			const auto tpStart = std::chrono::steady_clock::now();
+			for (unsigned iFrame = 0; iFrame < iFRAMES; ++iFrame)
+			{
+				// scroll a bit every frame, like a game would
+				oLayers[0].oScreenPos.x = iFrame;
+				oLayers[2].oScreenPos.y = iFrame * 2;
+				oCompositor.compose(oFrameSize, oLayers.data(), oLayers.size(), lib::Pixel(0),
+					oFrame.data());
+			}
+			const auto tpEnd = std::chrono::steady_clock::now();
+
+			const double dMilliseconds =
+				std::chrono::duration<double, std::milli>(tpEnd - tpStart).count() / iFRAMES;
+			if (iThreads == 1)
+				dSingleThreaded = dMilliseconds;
+
+			std::printf("%4ux%-4u, %zu layers, %2zu thread(s): %7.3f ms per frame (%4.1fx)\n",
+				unsigned(oFrameSize.x), unsigned(oFrameSize.y), oLayers.size(), iThreads,
+				dMilliseconds, dSingleThreaded / dMilliseconds);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+	WINDOWS COMPATIBILITY (tests only)
+	The few parts of <Windows.h> that the sources built by the tests use, so the tests and
+	benchmarks can also be built on other platforms.
+
+	This directory is only on the include path when not building for Windows.
+*/
+#ifndef RLGAMECANVAS_TEST_COMPAT_WINDOWS
+#define RLGAMECANVAS_TEST_COMPAT_WINDOWS
+
+
+
+
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h> // mmap, munmap
+#include <unistd.h>   // sysconf
+
+
+
+#ifndef __stdcall
+#define __stdcall
+#endif
+#define APIENTRY
+#define WINAPI
+
+#define FALSE 0
+
+typedef void         *HWND;
+typedef void         *HICON;
+typedef void         *HANDLE;
+typedef void         *PROC;
+typedef int           BOOL;
+typedef long          LONG;
+typedef unsigned long DWORD;
+typedef unsigned int  UINT;
+typedef uintptr_t     WPARAM;
+typedef intptr_t      LPARAM;
+
+// Like the MSVC version: On error, the destination is cleared and an error code is returned.
+static inline int memcpy_s(void *pDest, size_t iDestSize, const void *pSrc, size_t iCount)
+{
+	if (pDest == NULL || pSrc == NULL || iCount > iDestSize)
+	{
+		if (pDest != NULL)
+			memset(pDest, 0, iDestSize);
+		return 22; // EINVAL
+	}
+
+	memcpy(pDest, pSrc, iCount);
+	return 0;
+}
+
+
+
+// No extension functions --> the library takes the paths that only need OpenGL 1.1.
+static inline PROC wglGetProcAddress(const char *szName) { (void)szName; return NULL; }
+
+
+
+// Virtual memory: committed pages are zeroed and only count towards the resident memory once
+// they're touched, like on Windows.
+
+#define MEM_COMMIT      0x00001000
+#define MEM_RESERVE     0x00002000
+#define MEM_RELEASE     0x00008000
+#define MEM_LARGE_PAGES 0x20000000
+#define PAGE_READWRITE  0x04
+
+static inline void *VirtualAlloc(void *pAddress, size_t iSize, DWORD iAllocationType,
+	DWORD iProtect)
+{
+	(void)pAddress;
+	(void)iAllocationType;
+	(void)iProtect;
+
+	// munmap needs the size --> store it in an extra page in front of the memory
+	const size_t iPageSize = (size_t)sysconf(_SC_PAGESIZE);
+	void *pPages = mmap(NULL, iSize + iPageSize, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (pPages == MAP_FAILED)
+		return NULL;
+
+	*(size_t *)pPages = iSize + iPageSize;
+	return (uint8_t *)pPages + iPageSize;
+}
+
+static inline BOOL VirtualFree(void *pAddress, size_t iSize, DWORD iFreeType)
+{
+	(void)iSize;
+	(void)iFreeType;
+
+	uint8_t *pPages = (uint8_t *)pAddress - (size_t)sysconf(_SC_PAGESIZE);
+	return munmap(pPages, *(size_t *)pPages) == 0;
+}
+
+
+
+// Privileges: large pages are never available.
+
+#define TOKEN_ADJUST_PRIVILEGES 0x0020
+#define TOKEN_QUERY             0x0008
+#define SE_PRIVILEGE_ENABLED    0x00000002
+#define SE_LOCK_MEMORY_NAME     L"SeLockMemoryPrivilege"
+#define ERROR_NOT_ALL_ASSIGNED  1300L
+
+typedef struct
+{
+	DWORD LowPart;
+	LONG  HighPart;
+} LUID;
+
+typedef struct
+{
+	LUID  Luid;
+	DWORD Attributes;
+} LUID_AND_ATTRIBUTES;
+
+typedef struct
+{
+	DWORD               PrivilegeCount;
+	LUID_AND_ATTRIBUTES Privileges[1];
+} TOKEN_PRIVILEGES;
+
+static inline HANDLE GetCurrentProcess(void) { return NULL; }
+static inline BOOL   CloseHandle(HANDLE hObject) { (void)hObject; return 1; }
+static inline DWORD  GetLastError(void) { return 0; }
+static inline size_t GetLargePageMinimum(void) { return 0; }
+
+static inline BOOL OpenProcessToken(HANDLE hProcess, DWORD iDesiredAccess, HANDLE *phToken)
+{
+	(void)hProcess;
+	(void)iDesiredAccess;
+	(void)phToken;
+	return 0;
+}
+
+static inline BOOL LookupPrivilegeValueW(const wchar_t *szSystemName, const wchar_t *szName,
+	LUID *pLuid)
+{
+	(void)szSystemName;
+	(void)szName;
+	(void)pLuid;
+	return 0;
+}
+
+static inline BOOL AdjustTokenPrivileges(HANDLE hToken, BOOL bDisableAll,
+	TOKEN_PRIVILEGES *pNewState, DWORD iBufferLength, TOKEN_PRIVILEGES *pPreviousState,
+	DWORD *piReturnLength)
+{
+	(void)hToken;
+	(void)bDisableAll;
+	(void)pNewState;
+	(void)iBufferLength;
+	(void)pPreviousState;
+	(void)piReturnLength;
+	return 0;
+}
+
+
+
+
+
+#endif // RLGAMECANVAS_TEST_COMPAT_WINDOWS
\ No newline at end of file
@@ -0,0 +1,18 @@
+/*
+	OPENGL HEADER (tests only)
+	The Windows SDK has <gl/GL.h>, other platforms have <GL/gl.h>.
+*/
+#ifndef RLGAMECANVAS_TEST_COMPAT_GL
+#define RLGAMECANVAS_TEST_COMPAT_GL
+
+
+
+
+
+#include <GL/gl.h>
+
+
+
+
+
+#endif // RLGAMECANVAS_TEST_COMPAT_GL
\ No newline at end of file